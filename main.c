@@ -1,6 +1,26 @@
+#ifdef __linux__
+// accept4 et O_CLOEXEC, pour le partage des tableaux entre instances
+#define _GNU_SOURCE
+#endif
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <time.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/file.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <unistd.h>
+#endif
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
@@ -12,14 +32,273 @@
 #define MIN_TEXTBOX_HEIGHT 30
 #define MAX_TEXT_LENGTH 256
 
+// Un tableau "nom" est stocké dans nom.db, nom_done.db et nom_archive.db,
+// nom.txt servant de boîte de réception
+#define DEFAULT_BOARD_NAME "tasks"
+#define MAX_BOARD_NAME 64
+#define MAX_OPEN_BOARDS 9
+#define DEFAULT_CACHE_MB 64
+
+// Les tâches de la colonne "Done" sont stockées à part et chargées à la demande
+#define DONE_COLUMN 2
+#define DONE_PAGES_AT_STARTUP 2
+#define DEFAULT_ARCHIVE_DAYS 30
+
+// Import CSV/JSON : taille des blocs lus et nombre de tâches par lot enregistré
+#define IMPORT_CHUNK_SIZE 65536
+#define IMPORT_BATCH_SIZE 4096
+
+// Générateur de tableaux de test (--generate) : valeurs par défaut de ses options
+#define GENERATOR_TEXT_LENGTH 40
+#define GENERATOR_MULTILINE_PERCENT 5
+#define GENERATOR_UTF8_PERCENT 10
+#define GENERATOR_TAGS 50
+#define GENERATOR_DAYS 365
+
+// Recherche : nombre de candidats vérifiés à chaque image
+#define SEARCH_VERIFY_PER_FRAME 20000
+// Recherche : nombre de modifications reportées de l'index faites à chaque image
+#define INDEX_CHANGES_PER_FRAME 2000
+// Recherche : temps maximal d'une frappe et d'une mise à jour de l'index pour un million de
+// tâches (--bench-search)
+#define SEARCH_KEYSTROKE_BUDGET_MS 1.0
+#define SEARCH_UPDATE_BUDGET_MS 0.05
+
+// Police de l'interface
+#define FONT_PATH "C:\\SDL\\todolist\\Roboto-Regular.ttf"
+#define FONT_SIZE 30
+
+// Rendu des textes en arrière-plan : au plus RASTER_MAX_WORKERS fils, chacun avec sa propre
+// police, et textures créées par l'interface dans la limite de RASTER_UPLOAD_BUDGET_US par image
+#define RASTER_MAX_WORKERS 8
+#define RASTER_QUEUE_SIZE 1024 // Textes en cours de rendu au plus (puissance de 2)
+#define RASTER_UPLOAD_BUDGET_US 3000
+
+// Benchmark du rendu sans écran (--bench-render) : tableau immobile, défilement, déplacement, saisie
+#define RENDER_BENCH_SCENARIOS 4
+
+// Vérification du rendu (--check-render) : tableaux fixes dont le CRC32 des pixels est comparé
+// aux valeurs de référence
+#define RENDER_CHECK_SCENES 5
+#define RENDER_GOLDEN_PATH "render_golden.txt"
+
+// Comptage des allocations (--alloc-stats, --check-allocs) : domaines auxquels elles sont
+// attribuées, et taille de l'en-tête ajouté à chaque bloc (garde l'alignement de malloc)
+#define ALLOC_EVENTS 0
+#define ALLOC_UPDATE 1
+#define ALLOC_STORAGE 2
+#define ALLOC_RENDER 3
+#define ALLOC_RASTER 4
+#define ALLOC_OVERLAY 5
+#define ALLOC_OTHER 6
+#define ALLOC_ZONES 7
+#define ALLOC_HEADER 16
+#define ALLOC_OVERLAY_MS 500
+
+// Taille initiale de la mémoire de travail d'une image (agrandie si elle déborde)
+#define FRAME_ARENA_SIZE 65536
+
+// Affichage des performances (F3) : phases mesurées de la boucle principale, nombre d'images de
+// l'histogramme, intervalle de mise à jour du texte et caractères ASCII rendus pour l'écrire
+#define HUD_EVENTS 0
+#define HUD_UPDATE 1
+#define HUD_DRAW 2
+#define HUD_PRESENT 3
+#define HUD_PHASES 4
+#define HUD_HISTORY 120
+#define HUD_UPDATE_MS 250
+#define HUD_LINES 7
+#define HUD_FONT_SIZE 16
+#define HUD_FIRST_GLYPH 32
+#define HUD_GLYPHS 95
+#define HUD_WIDTH 420
+#define HUD_BAR_WIDTH 3
+#define HUD_GRAPH_HEIGHT 66
+
+// Latence entre une saisie et l'affichage de l'image qui en tient compte (HUD, --latency-stats) :
+// types de saisie suivis, mesures gardées par type et saisies en attente d'affichage par type
+#define LATENCY_TEXT 0
+#define LATENCY_MOTION 1
+#define LATENCY_TYPES 2
+#define LATENCY_SAMPLES 1024
+#define LATENCY_PENDING 64
+
+// Trace des phases (--trace, F4 pour l'écrire sans quitter) : zones gardées par fil (puissance
+// de 2, les plus anciennes sont écrasées) et nombre de fils suivis
+#define TRACE_RING_SIZE 16384
+#define TRACE_MAX_THREADS 16
+
+// Palette de commandes (Ctrl+P) : seuls les PALETTE_TITLE_WIDTH premiers caractères des
+// titres sont comparés, et seuls les PALETTE_MAX_RESULTS meilleurs résultats sont gardés
+#define PALETTE_TITLE_WIDTH 32
+#define PALETTE_MAX_QUERY 32
+#define PALETTE_MAX_RESULTS 1000
+#define PALETTE_VISIBLE_ROWS 10
+
+// Actions de la palette : les commandes fixes, puis changer de tableau et aller à une tâche
+#define PALETTE_ADD 0
+#define PALETTE_MOVE_TODO 1
+#define PALETTE_MOVE_IN_PROGRESS 2
+#define PALETTE_MOVE_DONE 3
+#define PALETTE_DELETE 4
+#define PALETTE_DONE_VIEW 5   // Toutes les tâches de la vue filtrée
+#define PALETTE_DELETE_VIEW 6
+#define PALETTE_UNDO 7
+#define PALETTE_REDO 8
+#define PALETTE_NUM_COMMANDS 9
+#define PALETTE_SWITCH_BOARD 9
+#define PALETTE_TASK 10
+
+// Étiquettes (#tag) : chaque étiquette garde l'ensemble de ses tâches, découpé en conteneurs
+// de 65536 numéros. Un conteneur est un tableau trié jusqu'à TAG_ARRAY_MAX numéros, puis
+// un bitmap de TAG_BITMAP_WORDS mots.
+#define TAG_ARRAY_MAX 4096
+#define TAG_BITMAP_WORDS 1024
+#define MAX_TAG_LENGTH 32
+#define MAX_TASK_TAGS 32
+#define MAX_FILTER_LENGTH 128
+#define MAX_FILTER_OPS 64
+
+// Opérations d'une vue filtrée, en notation postfixe
+#define FILTER_TAG 0
+#define FILTER_NOT 1
+#define FILTER_AND 2
+#define FILTER_OR 3
+#define FILTER_AND_NOT 4
+
+// Langage des vues filtrées (« column = 1 and age > 7d and text ~ "deploy" ») : nœuds de
+// l'arbre analysé (FILTER_TAG à FILTER_OR, puis comparaison et texte), champs comparés
+// et instructions du code compilé
+#define FILTER_COMPARE 5
+#define FILTER_TEXT 6
+#define MAX_QUERY_NODES 64
+#define MAX_QUERY_CODE (2 * MAX_QUERY_NODES)
+#define MAX_QUERY_STRINGS 16
+#define MAX_QUERY_STRING 64
+
+#define QUERY_FIELD_COLUMN 0
+#define QUERY_FIELD_AGE 1  // Secondes depuis la création
+#define QUERY_FIELD_DONE 2 // Secondes depuis le passage dans "Done"
+
+#define QUERY_EQUAL 0
+#define QUERY_NOT_EQUAL 1
+#define QUERY_LESS 2
+#define QUERY_LESS_EQUAL 3
+#define QUERY_GREATER 4
+#define QUERY_GREATER_EQUAL 5
+
+#define QUERY_OP_TAG 0           // Tâche portant l'étiquette strings[value]
+#define QUERY_OP_TEXT 1          // Texte contenant strings[value]
+#define QUERY_OP_COMPARE 2       // Champ field comparé à value
+#define QUERY_OP_NOT 3
+#define QUERY_OP_JUMP_IF_FALSE 4 // Court-circuit d'un AND
+#define QUERY_OP_JUMP_IF_TRUE 5  // Court-circuit d'un OR
+
+// Surveillance de tasks.txt : intervalle d'interrogation sans inotify et taille
+// de la fin de fichier comparée pour reconnaître un ajout
+#define INBOX_POLL_MS 500
+#define INBOX_TAIL_SIZE 64
+
+// Historique des modifications (Ctrl+Z / Ctrl+Y) : mémoire maximale et types de modifications
+#define UNDO_MAX_MB 8
+#define UNDO_BUDGET_MS 25 // Étape de 10 000 tâches faite, annulée ou refaite (--bench-undo)
+#define UNDO_INSERT 0 // Tâche ajoutée au tableau
+#define UNDO_DELETE 1 // Tâche supprimée, son emplacement restant libre
+#define UNDO_MOVE 2   // Tâche changée de colonne, et de tableau si besoin
+#define UNDO_EDIT 3   // Texte modifié
+#define UNDO_STEP_START 1 // Première modification d'une étape (annulée d'un coup)
+
+// Chronologie d'un tableau (Ctrl+H) : à chaque enregistrement, les pages modifiées sont
+// recopiées dans un fichier de pages et une entrée est ajoutée au journal des versions.
+// Une image clé (toutes les pages) est écrite après TIMELINE_KEYFRAME_DELTAS entrées,
+// dès que ces entrées pèsent au moins le quart d'une image clé.
+#define TIMELINE_MAGIC 0x4C535454 // "TTSL"
+#define TIMELINE_VERSION 2
+#define TIMELINE_DELTA 1          // Pages modifiées depuis l'entrée précédente
+#define TIMELINE_KEYFRAME 2       // Toutes les pages du tableau
+#define TIMELINE_HEADER_SIZE 16   // Type et tableau, date, nombre de tâches et de pages
+#define TIMELINE_KEYFRAME_DELTAS 64
+#define TIMELINE_DONE_PAGES 3     // Dernières pages de la colonne "Done" reconstruites
+#define TIMELINE_NO_PAGE 0xFFFFFFFF
+#define TIMELINE_COPY_ALIGN 16    // Les copies de pages commencent sur un multiple de 16 octets
+#define AUTOSAVE_SECONDS 60
+
+// Tableau partagé entre plusieurs instances (Linux) : la première prend le verrou nom.lock
+// et devient serveur sur le socket Unix nom.sock, les suivantes s'y connectent. Chaque
+// tâche y porte un identifiant et trois registres datés par une horloge de Lamport (texte,
+// colonne, place dans son tableau) : une modification est faite tout de suite, puis envoyée
+// en entrées qui se fusionnent dans n'importe quel ordre (la date la plus récente l'emporte,
+// une suppression l'emporte sur tout). Le serveur relaie aux autres instances ce qui a changé
+// son tableau, et seul lui écrit les fichiers. Un message est formé de sa taille, de son type,
+// d'une valeur de 32 bits et de ses données.
+#define SYNC_ALONE 0
+#define SYNC_SERVER 1
+#define SYNC_CLIENT 2
+#define SYNC_MAX_PEERS 16
+#define SYNC_HEADER_SIZE 9
+#define SYNC_MAX_MESSAGE (1 << 20)
+#define SYNC_MAX_OUTPUT (64 << 20)   // Connexion trop lente, fermée au-delà
+#define SYNC_WAIT_MS 2000            // Attente d'un serveur qui démarre ou qui enregistre
+#define SYNC_LOAD_MS 10000           // Lecture du tableau par un client qui arrive
+#define SYNC_REPORT_MS 100           // Client : dernière étape reçue signalée au plus aussi souvent
+#define SYNC_COLLECT_MS 1000         // Serveur : suppressions oubliées au plus aussi souvent
+#define SYNC_HELLO 1   // Client : rejoindre (le serveur enregistre le tableau)
+#define SYNC_WELCOME 2 // Serveur : dernière étape, horloge et numéro d'instance ; le tableau peut être lu
+#define SYNC_IDS 3     // Serveur : identifiants et clés des tâches enregistrées, après WELCOME
+#define SYNC_LOADED 4  // Client : tableau lu, le serveur peut de nouveau enregistrer
+#define SYNC_DELTA 5   // Entrées : dernière étape reçue (client) ou numéro de l'étape (serveur)
+#define SYNC_ACK 6     // Serveur : entrées du client fusionnées, avec le numéro de l'étape
+#define SYNC_STABLE 7  // Serveur : dernière étape reçue par toutes les instances
+#define SYNC_DRAG 8    // Position d'une tâche déplacée à la souris (une fois par image au plus)
+#define SYNC_ENTRY_TASK 1    // Entrée : tâche et ses registres
+#define SYNC_ENTRY_DELETED 2 // Entrée : tâche supprimée
+#define SYNC_TEXT 0    // Registres d'une tâche partagée : texte,
+#define SYNC_PLACE 1   // colonne et date de passage dans "Done",
+#define SYNC_ORDER 2   // clé de la tâche dans l'ordre de son tableau
+#define SYNC_REPLICA_BITS 24             // Identifiants et dates : compteur ou horloge, puis numéro d'instance
+#define SYNC_PEER_READY 0
+#define SYNC_PEER_JOINING 1 // HELLO reçu, en attente d'un enregistrement
+#define SYNC_PEER_LOADING 2 // WELCOME envoyé, le client lit les fichiers
+
+// Enregistrement des événements traités par la boucle principale (--record) et relecture
+// (--replay) : en-tête, puis pour chaque événement l'écart en images et en millisecondes
+// avec le précédent (entiers de longueur variable), sa taille et ses octets. L'en-tête et
+// la fin de l'enregistrement portent les empreintes du tableau affiché.
+#define EVENTLOG_MAGIC 0x56455454 // "TTEV"
+#define EVENTLOG_VERSION 1
+#define EVENTLOG_END 0xFF         // Taille réservée à la fin de l'enregistrement
+
+// Format du fichier de tâches paginé : une page d'en-tête, puis des segments
+// composés d'une page de table suivie de PAGES_PER_SEGMENT pages de données.
+// Chaque enregistrement, chaque page de données (via sa table, CRC des CRC de
+// ses enregistrements) et chaque page de table portent un CRC32 pour pouvoir
+// récupérer les tâches après un crash. Une tâche garde son emplacement : une
+// suppression le laisse libre (rempli de zéros) et l'ordre d'affichage est donné
+// par la clé de chaque tâche, si bien qu'une modification ne réécrit qu'une page.
+#define PAGE_SIZE 4096
+#define RECORD_HEADER_SIZE 24 // CRC, colonne, dates et clé d'ordre, avant le texte
+#define RECORD_SIZE (RECORD_HEADER_SIZE + MAX_TEXT_LENGTH)
+#define RECORDS_PER_PAGE (PAGE_SIZE / RECORD_SIZE)
+#define PAGE_ENTRY_SIZE 8
+#define PAGES_PER_SEGMENT (PAGE_SIZE / PAGE_ENTRY_SIZE - 1)
+#define DB_MAGIC 0x42445454 // "TTDB"
+#define DB_VERSION 5
+#define ORDER_KEY_GAP ((Uint64)1 << SYNC_REPLICA_BITS) // Écart entre les clés des tâches ajoutées après les autres
+
 // Structure pour représenter une zone de texte
 typedef struct {
     char text[MAX_TEXT_LENGTH];
     SDL_Rect rect;
     bool isEditing;
     bool isDragging;
+    bool isFree;      // Emplacement libre (tâche supprimée) : ni affiché, ni indexé, ni enregistré
     char inputText[MAX_TEXT_LENGTH];
     int column; // Nouveau champ pour stocker l'index de la colonne
+    Uint32 createdAt; // Date de création (secondes depuis 1970)
+    Uint32 doneAt;    // Date de passage dans la colonne "Done", 0 sinon
+    Uint64 id;        // Tableau partagé : identifiant de la tâche, 0 sinon
+    Uint64 orderKey;  // Ordre d'affichage : les tâches sont rangées par clé, puis par identifiant
+    Uint64 stamps[3]; // Tableau partagé : dates des registres SYNC_TEXT à SYNC_ORDER
 } TextLine;
 
 // Structure pour représenter une colonne
@@ -31,103 +310,10709 @@ typedef struct {
     SDL_Color color; // Nouveau champ pour stocker la couleur de la colonne
 } Column;
 
+// Structure pour suivre les pages du fichier de tâches à réécrire
+typedef struct {
+    Uint8 *dirtyPages;   // Un octet par page de données, 1 si la page a été modifiée
+    Uint32 *pageCrcs;    // CRC32 de chaque page de données, recopié dans les pages de table
+    Uint8 *pageTasks;    // Nombre de tâches (emplacements occupés) de chaque page, idem
+    int pageCapacity;
+    int dirtyFrom;       // Pages modifiées comprises entre dirtyFrom et dirtyTo (exclue)
+    int dirtyTo;
+    int savedNumLines;   // Nombre de tâches lors du dernier enregistrement
+    bool rewriteAll;     // Fichier absent ou importé : tout réécrire
+    Uint64 bytesWritten; // Statistiques du dernier enregistrement
+    int pagesWritten;
+    Uint32 changes;      // Nombre de modifications, pour repérer celles faites hors de l'historique
+    Uint32 savedChanges; // Valeur de changes lors du dernier enregistrement
+    bool quiet;          // Pas de message à chaque enregistrement (benchmark)
+} PageStore;
+
+// Structure pour les numéros de tâches d'une étiquette qui ont les mêmes 16 bits de poids
+// fort : tableau trié tant qu'ils sont peu nombreux, bitmap au-delà
+typedef struct {
+    Uint16 key;     // 16 bits de poids fort des numéros
+    int count;
+    int capacity;   // Capacité du tableau
+    Uint16 *values; // Tableau trié des 16 bits de poids faible, NULL pour un bitmap
+    Uint64 *bits;   // Bitmap de TAG_BITMAP_WORDS mots, NULL pour un tableau
+} TagContainer;
+
+// Structure pour un ensemble compressé de numéros de tâches (conteneurs triés par clé)
+typedef struct {
+    TagContainer *containers;
+    int numContainers;
+    int capacity;
+} TagBitmap;
+
+// Structure pour les tâches contenant un trigramme, rangées comme celles d'une étiquette :
+// ajouter ou retirer une tâche ne décale au plus qu'un conteneur
+typedef struct {
+    Uint32 key; // Trigramme + 1, 0 : emplacement libre
+    int count;
+    TagBitmap ids; // Numéros des tâches dans le tableau
+} Posting;
+
+// Structure pour une étiquette et ses tâches
+typedef struct {
+    char name[MAX_TAG_LENGTH]; // En minuscules, sans le #
+    TagBitmap tasks;
+} Tag;
+
+// Structure pour les champs d'une tâche lus par les vues filtrées, rangés à la suite les uns
+// des autres pour être parcourus sans lire les TextLine
+typedef struct {
+    Uint32 createdAt;
+    Uint32 doneAt;
+    int column;
+} TaskFields;
+
+// Structure pour une opération postfixe d'une vue filtrée qui ne porte que sur des étiquettes
+typedef struct {
+    int op;  // FILTER_TAG à FILTER_AND_NOT
+    int tag; // Pour FILTER_TAG : numéro de la chaîne du nom de l'étiquette
+} FilterOp;
+
+// Structure pour une instruction du code compilé d'une vue filtrée
+typedef struct {
+    Uint8 op;     // QUERY_OP_TAG à QUERY_OP_JUMP_IF_TRUE
+    Uint8 field;
+    Uint8 compare;
+    Uint8 target; // Instruction suivante d'un saut
+    Sint32 value;
+} QueryInstr;
+
+// Structure pour une vue filtrée compilée. Le code est évalué tâche par tâche avec
+// court-circuit ; une vue qui ne porte que sur des étiquettes est aussi compilée en
+// opérations postfixes évaluées sur les ensembles compressés.
+typedef struct {
+    QueryInstr code[MAX_QUERY_CODE];
+    int codeLength;  // 0 : aucune vue filtrée
+    FilterOp ops[MAX_FILTER_OPS];
+    int numOps;      // 0 si la vue ne porte pas que sur des étiquettes
+    QueryInstr anchors[MAX_QUERY_STRINGS]; // Étiquettes et textes reliés à la racine par AND : de quoi utiliser les index
+    int numAnchors;
+    char strings[MAX_QUERY_STRINGS][MAX_QUERY_STRING]; // Noms d'étiquettes et textes cherchés, en minuscules
+    int numStrings;
+    int tagIds[MAX_QUERY_STRINGS]; // Numéro dans l'index de l'étiquette de chaque chaîne
+    Uint32 now;      // Date de référence des âges
+} Query;
+
+// Structure pour un nœud de l'arbre d'une expression de vue filtrée
+typedef struct {
+    int type;     // FILTER_TAG à FILTER_OR, FILTER_COMPARE ou FILTER_TEXT
+    int left;     // Nœuds fils
+    int right;
+    int field;
+    int compare;
+    Sint32 value; // Valeur comparée, ou numéro de la chaîne
+} QueryNode;
+
+// Structure pour l'analyse d'une expression de vue filtrée
+typedef struct {
+    const char *cursor;
+    QueryNode nodes[MAX_QUERY_NODES];
+    int numNodes;
+    Query *query; // Reçoit les chaînes
+} QueryParser;
+
+struct Board;
+
+// Structure pour une tâche à ajouter aux listes de trigrammes de son texte ou à en retirer
+typedef struct {
+    Uint32 id;
+    Uint32 text; // Position du texte dans pendingTexts
+    bool add;
+} PendingPosting;
+
+// Structure pour l'index de recherche d'un tableau (trigrammes -> tâches) et les
+// résultats de la dernière recherche
+typedef struct {
+    Posting *postings; // Table à adressage ouvert
+    int capacity;
+    int numPostings;
+    size_t idBytes;
+    Uint32 *matches;   // Tâches trouvées, triées : vérifiées puis candidats restants
+    int numMatches;
+    int numVerified;   // matches[0..numVerified[ : tâches vérifiées
+    int nextToVerify;  // matches[nextToVerify..numMatches[ : candidats pas encore vérifiés
+    int matchCapacity;
+    char query[MAX_TEXT_LENGTH];
+    bool active;       // Une recherche d'au moins 3 caractères est en cours
+    bool stale;        // L'index a changé depuis la dernière recherche
+    Uint32 version;    // Incrémenté à chaque modification
+    Uint8 *titles;     // Titres en minuscules pour la palette, PALETTE_TITLE_WIDTH octets par tâche
+    TaskFields *fields; // Champs des tâches pour les vues filtrées, rangés comme les titres
+    int titleBase;     // Numéro de la tâche du premier titre
+    int numTitles;
+    int titleCapacity;
+    Tag *tags;         // Étiquettes trouvées dans les textes
+    int numTags;
+    int tagCapacity;
+    int *tagSlots;     // Table à adressage ouvert : numéro de l'étiquette + 1, 0 : emplacement libre
+    int tagSlotCapacity;
+    TagBitmap indexed; // Toutes les tâches indexées (complément d'un NOT)
+    Query view;        // Vue filtrée en cours
+    TagBitmap filtered; // Tâches de la vue filtrée, tenues à jour à chaque modification
+    const struct Board *board; // Tableau indexé, pour évaluer la vue sur les champs des tâches
+    // Tâches à ajouter aux listes de trigrammes ou à en retirer, dans l'ordre. Une
+    // modification groupée les laisse ici : elles sont faites quelques-unes à chaque image,
+    // ou toutes avant une recherche.
+    bool batching;
+    PendingPosting *pending;
+    int firstPending;  // pending[firstPending..numPending[ : pas encore faites
+    int numPending;
+    int pendingCapacity;
+    char *pendingTexts; // Textes des tâches, à la suite
+    size_t pendingTextLength;
+    size_t pendingTextCapacity;
+} TrigramIndex;
+
+// Structure pour une page de données recopiée dans le fichier des pages de la chronologie
+typedef struct {
+    Uint32 copy; // Position de la copie compactée (en multiples de TIMELINE_COPY_ALIGN octets)
+                 // dans le fichier des pages, TIMELINE_NO_PAGE si absente
+    Uint32 crc;  // CRC de la page, comme dans les pages de table
+} TimelinePage;
+
+// Structure pour enregistrer la chronologie d'un tableau : dernière version de chaque page
+// et pages recopiées pendant l'enregistrement en cours
+typedef struct {
+    const char *logPath;
+    const char *pagesPath;
+    int slot;              // 0 : tâches actives, 1 : colonne "Done"
+    TimelinePage *pages;
+    int numLines;
+    int capacity;
+    Uint32 *changed;       // Numéro, copie et CRC de chaque page modifiée
+    int numChanged;
+    int changedCapacity;
+    SDL_RWops *pagesFile;  // Ouvert pendant un enregistrement
+    Uint32 nextCopy;       // Position de la prochaine copie
+    bool started;          // Au moins une entrée écrite pour ce tableau
+    bool failed;           // Erreur d'écriture : plus rien n'est enregistré
+    int deltas;            // Entrées depuis la dernière image clé et leur taille
+    size_t deltaBytes;
+    Uint32 now;            // Date imposée des entrées (benchmark), 0 : heure courante
+} TimelineWriter;
+
+// Structure pour un tampon d'octets reçus ou à envoyer
+typedef struct {
+    Uint8 *data;
+    size_t length;
+    size_t capacity;
+} SyncBuffer;
+
+// Structure pour une connexion à une autre instance
+typedef struct {
+    int fd;
+    int state;         // SYNC_PEER_READY à SYNC_PEER_LOADING (serveur)
+    Uint32 since;      // Début de la lecture du tableau par le client
+    Uint32 applied;    // Dernière étape reçue par le client (serveur)
+    SyncBuffer input;  // Octets reçus ; input.data[0..consumed[ : messages déjà traités
+    size_t consumed;
+    SyncBuffer output; // Octets en attente d'envoi
+    bool broken;       // Message illisible : connexion à fermer
+} SyncPeer;
+
+// Structure pour une table d'adressage ouvert des tâches partagées, par identifiant
+typedef struct {
+    Uint64 *ids;       // 0 : case libre
+    Uint32 *values;
+    Uint32 capacity;   // Puissance de 2
+    Uint32 count;
+} SyncTable;
+
+// Structure pour le partage d'un tableau ouvert avec les autres instances
+typedef struct BoardSync {
+    int role;              // SYNC_ALONE, SYNC_SERVER ou SYNC_CLIENT
+    int lockFd;
+    int listenFd;
+    SyncPeer peers[SYNC_MAX_PEERS]; // Serveur : ses clients ; client : peers[0], le serveur
+    int numPeers;
+    struct Board *boards[2];        // Tâches actives et colonne "Done"
+    bool tracking;         // Identifiants attribués : les modifications sont enregistrées
+    Uint32 replica;        // Numéro de cette instance (0 : serveur)
+    Uint32 nextReplica;    // Serveur : numéro du prochain client accueilli
+    Uint64 clock;          // Horloge de Lamport
+    Uint64 counter;        // Tâches créées par cette instance
+    SyncTable live;        // Tâches en mémoire : numéro * 2 + tableau
+    SyncTable tombstones;  // Tâches supprimées : étape de la suppression, 0 si pas encore numérotée
+    SyncBuffer delta;      // Entrées locales pas encore envoyées
+    SyncBuffer relay;      // Serveur : état fusionné des tâches changées par le dernier lot reçu
+    SyncBuffer unsequenced; // Suppressions locales pas encore numérotées : identifiant et lot
+    Uint32 seq;            // Dernière étape numérotée par le serveur
+    Uint32 stable;         // Dernière étape reçue par toutes les instances
+    Uint32 batchesSent;    // Lots d'entrées locales envoyés
+    Uint32 batchesAcked;   // Client : lots fusionnés par le serveur
+    Uint32 reportedSeq;    // Client : dernière étape signalée au serveur
+    Uint32 reportedAt;
+    Uint32 collectedAt;    // Serveur : dernier oubli des suppressions
+    Uint64 sentAt[64];     // Client : envoi des derniers lots, pour le temps de réponse
+    bool applying;         // Entrées reçues en cours de fusion : pas enregistrées
+    bool failed;           // Entrée locale perdue faute de mémoire
+    bool lost;             // Client : serveur perdu, le tableau doit être relu
+    Uint64 dragId;         // Tâche déplacée à la souris à signaler, 0 sinon
+    SDL_Point dragPosition;
+    // Statistiques
+    int resyncs;
+    Uint64 entriesMerged;  // Entrées reçues et fusionnées
+    Uint64 mergeTime;      // Durée des fusions (compteur de performance)
+    Uint64 entryBytes;     // Taille des entrées locales envoyées
+    int tombstonesCollected;
+    int roundTrips;
+    double roundTripTotal; // Millisecondes entre l'envoi d'un lot et sa fusion par le serveur
+    double roundTripMax;
+    Uint64 bytesSent;
+} BoardSync;
+
+// Structure pour représenter le tableau de tâches (tableau dynamique).
+// Un tableau peut n'être chargé qu'en partie : lines[0] correspond alors à la
+// tâche baseIndex, les pages précédentes restant sur disque. Chaque tâche garde
+// son emplacement (son numéro) jusqu'à sa suppression.
+typedef struct Board {
+    const char *path;
+    TextLine *lines;
+    int numLines;   // Nombre total d'emplacements, y compris ceux restés sur disque
+    int baseIndex;
+    int capacity;
+    int numFree;    // Emplacements libres, y compris ceux restés sur disque
+    bool appendOnly; // Colonne "Done" et archive : un ajout se fait toujours à la fin, pour que l'ordre
+                     // des emplacements reste celui des clés ; sinon il reprend un emplacement libre
+    int *freeSlots;  // Emplacements libérés à reprendre (pile ; ceux déjà repris sont sautés)
+    int numFreeSlots;
+    int freeCapacity;
+    Uint64 lastOrderKey; // Plus grande clé d'ordre attribuée
+    TextLine **order;    // Tableau partagé : tâches en mémoire rangées par clé, pour la colonne "Done"
+    int numOrdered;
+    int orderCapacity;
+    bool ordered;        // order est à jour (false : à refaire après un ajout, une suppression ou une clé changée)
+    PageStore store;
+    TrigramIndex *search; // Index de recherche tenu à jour, NULL si le tableau n'est pas affiché
+    TimelineWriter *timeline; // Chronologie complétée à chaque enregistrement, NULL sinon
+    struct BoardSync *sync;   // Partage avec les autres instances qui modifient le tableau, NULL sinon
+} Board;
+
+// Structure pour une ligne déjà lue de tasks.txt
+typedef struct {
+    Uint32 hash;  // CRC32 du texte de la tâche
+    int column;   // -1 pour une ligne mal formée
+    long offset;  // Position de la ligne dans le fichier
+} InboxLine;
+
+// Structure pour surveiller tasks.txt, où des scripts ajoutent des tâches
+// pendant que l'application est ouverte
+typedef struct {
+    InboxLine *lines; // Lignes connues, dans l'ordre du fichier
+    int numLines;
+    int capacity;
+    long seenSize;    // Octets lus, jusqu'au dernier retour à la ligne
+    char tail[INBOX_TAIL_SIZE]; // Derniers octets lus
+    int tailLength;
+    const char *path;
+    time_t seenMtime;
+    Uint32 lastPoll;
+    int inotifyFd;    // -1 sans inotify : le fichier est alors interrogé périodiquement
+} InboxWatcher;
+
+// Structure pour les noms des fichiers d'un tableau
+typedef struct {
+    char name[MAX_BOARD_NAME];
+    char tasks[MAX_BOARD_NAME + 16];
+    char done[MAX_BOARD_NAME + 16];
+    char archive[MAX_BOARD_NAME + 16];
+    char inbox[MAX_BOARD_NAME + 16];
+    char timelineLog[MAX_BOARD_NAME + 16];
+    char timelinePages[MAX_BOARD_NAME + 16];
+    char lock[MAX_BOARD_NAME + 16];
+    char socket[MAX_BOARD_NAME + 16];
+} BoardFiles;
+
+// Structure pour une texture de texte gardée en cache
+typedef struct {
+    Uint32 hash; // 0 : emplacement libre
+    int wrapWidth;
+    SDL_Color color;
+    SDL_Texture *texture;
+    int width;
+    int height;
+    Uint32 lastFrame;
+    char text[MAX_TEXT_LENGTH];
+} TextCacheEntry;
+
+// Structure pour le cache des textures de texte d'un tableau (table à adressage ouvert)
+typedef struct {
+    TextCacheEntry *entries;
+    int capacity; // Puissance de 2
+    int count;
+    size_t bytes; // Taille des textures (4 octets par pixel)
+    Uint32 frame; // Image en cours, pour repérer les textures inutilisées
+    struct TextRaster *raster; // Rendu en arrière-plan (NULL : rendu immédiat)
+} TextCache;
+
+// Structure pour un texte à rendre par un fil de rendu
+typedef struct {
+    Uint32 hash; // 0 : tâche de rendu libre
+    int wrapWidth;
+    SDL_Color color;
+    SDL_Surface *surface; // Rendue par le fil, NULL en cas d'échec
+    char text[MAX_TEXT_LENGTH];
+} RasterJob;
+
+// Structure pour une file bornée sans verrou, à plusieurs producteurs et consommateurs :
+// chaque case porte un numéro de séquence qui indique si elle peut être écrite ou lue
+typedef struct {
+    SDL_atomic_t sequence[RASTER_QUEUE_SIZE];
+    int values[RASTER_QUEUE_SIZE];
+    SDL_atomic_t head; // Prochaine case lue
+    SDL_atomic_t tail; // Prochaine case écrite
+} RasterQueue;
+
+// Structure pour un fil de rendu et sa police (une police ne doit servir qu'à un fil)
+typedef struct {
+    struct TextRaster *raster;
+    TTF_Font *font;
+    SDL_Thread *thread;
+} RasterWorker;
+
+// Structure pour le rendu des textes en arrière-plan. Les tâches de rendu passent de
+// l'interface aux fils par queued, puis reviennent par finished ; l'interface seule
+// touche à la liste des tâches libres et à la table des textes en cours de rendu.
+typedef struct TextRaster {
+    RasterJob jobs[RASTER_QUEUE_SIZE];
+    int freeJobs[RASTER_QUEUE_SIZE];
+    int numFree;
+    int pending[2 * RASTER_QUEUE_SIZE]; // Table à adressage ouvert : tâche + 1, 0 : libre
+    RasterQueue queued;
+    RasterQueue finished;
+    SDL_sem *wake; // Une unité par tâche dans queued
+    SDL_atomic_t quit;
+    RasterWorker workers[RASTER_MAX_WORKERS];
+    int numWorkers;
+    // Statistiques
+    Uint64 rendered;   // Textes rendus par les fils
+    Uint64 uploaded;   // Textures créées par l'interface
+    Uint64 uploadTime; // En ticks de compteur de performance
+    int deferred;      // Images où le budget a reporté des textures à l'image suivante
+} TextRaster;
+
+// Structure pour le bilan de la vérification du fichier au chargement
+typedef struct {
+    int recordsLoaded;
+    int recordsSalvaged;  // Tâches valides récupérées dans une page endommagée
+    int recordsDiscarded; // Tâches dont le CRC ne correspond pas
+    int pagesDamaged;
+    bool headerDamaged;
+    bool truncated;       // Fin de fichier manquante (écriture interrompue)
+    int linesSkipped;     // Lignes mal formées dans l'ancien fichier texte
+} RecoveryStats;
+
+// Structure pour une modification de l'historique. Les tâches sont désignées par leur
+// tableau (0 : tâches actives, 1 : colonne "Done") et leur emplacement ; les textes sont
+// rangés dans le tampon de l'historique.
+typedef struct {
+    Uint8 type;       // UNDO_INSERT à UNDO_EDIT
+    Uint8 flags;      // UNDO_STEP_START
+    Uint8 board;
+    Uint8 toBoard;    // UNDO_MOVE : tableau d'arrivée
+    Uint8 column;     // Colonne avant la modification (tâche ajoutée : sa colonne)
+    Uint8 newColumn;  // UNDO_MOVE
+    Uint8 prefix;     // UNDO_EDIT : début commun aux deux textes
+    Uint8 oldLength;  // UNDO_EDIT : passage remplacé, puis passage inséré, rangés à la suite
+    Uint8 newLength;
+    Sint16 x, y, h;   // Zone affichée avant la modification
+    int index;
+    int toIndex;      // UNDO_MOVE : numéro dans le tableau d'arrivée
+    Uint32 text;      // Position des textes de la modification dans le tampon
+    Uint32 createdAt;
+    Uint32 doneAt;    // Avant la modification
+    Uint32 newDoneAt; // UNDO_MOVE
+    Uint64 orderKey;  // Clé d'ordre avant la modification (tâche remise à sa place)
+} UndoRecord;
+
+// Structure pour l'historique des modifications d'un tableau ouvert
+typedef struct {
+    UndoRecord *records;
+    int numRecords;
+    int cursor;        // records[0..cursor[ : modifications faites, au-delà : à refaire
+    int capacity;
+    char *texts;       // Textes des tâches ajoutées ou supprimées et passages modifiés
+    Uint32 textLength;
+    Uint32 textCapacity;
+    bool stepPending;  // La prochaine modification commence une étape
+    Uint32 changes[2]; // Modifications des deux tableaux à la fin de la dernière étape
+} UndoLog;
+
+// Structure pour un tableau ouvert, gardé en mémoire avec ses textures
+typedef struct {
+    BoardFiles files;
+    Board tasks;
+    Board done;
+    Board archive;
+    InboxWatcher inbox;
+    TextCache textCache;
+    TrigramIndex taskIndex;
+    TrigramIndex doneIndex;
+    UndoLog history;
+    TimelineWriter timeline[2];
+    BoardSync sync;
+    int doneScroll;
+    Uint32 lastUsed;
+    bool quiet; // Pas de message à chaque chargement ou enregistrement (commandes, benchmarks)
+} OpenBoard;
+
+// Structure pour une entrée du journal de la chronologie, relevée à l'ouverture de la vue
+typedef struct {
+    size_t offset;
+    Uint32 time;     // Jamais inférieure à celle de l'entrée précédente
+    int keyframe;    // Dernière image clé du même tableau
+    int latest[2];   // Dernière entrée de chaque tableau jusqu'à celle-ci, -1 si aucune
+    Uint8 slot;
+    Uint8 kind;
+} TimelineEntry;
+
+// Structure pour la vue de la chronologie : le journal en mémoire et les deux tableaux
+// reconstruits à la version choisie, affichés en lecture seule. Seules les pages qui
+// diffèrent de la version affichée sont relues.
+typedef struct {
+    bool open;
+    Uint8 *log;
+    size_t logSize;
+    TimelineEntry *entries;
+    int numEntries;
+    int position;          // Entrée affichée
+    char pagesPath[MAX_BOARD_NAME + 16];
+    Board boards[2];       // Tâches actives et dernières pages de la colonne "Done"
+    TimelinePage *pages[2];
+    int capacity[2];
+    TimelinePage *shown[2]; // Copie décodée dans boards[b] pour chaque page
+    int shownCapacity[2];
+    int doneScroll;
+} TimelineView;
+
+// Structure pour l'enregistrement ou la relecture des événements
+typedef struct {
+    SDL_RWops *file;     // Enregistrement
+    SyncBuffer pending;  // Événements de l'image en cours, écrits à la fin de l'image
+    Uint8 *data;         // Relecture : tout le fichier
+    size_t size;
+    size_t offset;       // Prochain événement à relire
+    bool replaying;
+    bool maxSpeed;       // Relecture sans attendre l'heure des événements ni l'écran
+    bool finished;       // Relecture : tous les événements ont été relus
+    bool ended;          // Relecture : la fin de l'enregistrement a été lue
+    Uint32 frame;        // Image en cours
+    Uint32 start;        // Heure du début (SDL_GetTicks)
+    Uint32 lastFrame;    // Image et heure du dernier événement écrit ou relu
+    Uint32 lastTime;
+    Uint32 checksums[2]; // Tableau affiché au début (relecture : à la fin de l'enregistrement)
+    int numEvents;
+} EventLog;
+
+// Structure pour un résultat de la palette
+typedef struct {
+    int score;
+    int order;  // Ordre d'apparition, pour départager les scores égaux
+    int action; // PALETTE_ADD à PALETTE_TASK
+    int board;  // Pour une tâche : 0 tâches actives, 1 colonne "Done"
+    int id;     // Numéro de la tâche, ou du tableau pour PALETTE_SWITCH_BOARD
+} PaletteResult;
+
+// Structure pour la palette de commandes
+typedef struct {
+    bool open;
+    char query[PALETTE_MAX_QUERY + 1];
+    PaletteResult *results; // Meilleurs résultats, triés une fois la recherche finie
+    int numResults;
+    int selected;
+    int scroll;             // Premier résultat affiché (seules les lignes visibles sont dessinées)
+    // Blocs de 16 titres où la requête précédente a été trouvée : une requête qui la
+    // prolonge ne peut être trouvée que dans ces blocs
+    int *blocks[2];
+    int numBlocks[2];
+    int blockCapacity[2];
+    Uint32 versions[2];     // Version des index lors de la requête précédente
+    const void *scannedBoard;
+    char scannedQuery[PALETTE_MAX_QUERY + 1];
+} Palette;
+
+// Structure pour le cache des tableaux récemment affichés (LRU)
+typedef struct {
+    OpenBoard *boards[MAX_OPEN_BOARDS];
+    int count;
+    size_t budget; // Mémoire maximale des tableaux ouverts, en octets
+    Uint32 clock;
+} BoardCache;
+
 // Fonction pour vérifier si un point est à l'intérieur d'un rectangle
 bool isPointInRect(const SDL_Point *point, const SDL_Rect *rect) {
     return point->x >= rect->x && point->x < rect->x + rect->w &&
            point->y >= rect->y && point->y < rect->y + rect->h;
 }
 
-// Fonction pour sauvegarder les données dans un fichier
-void saveTasksToFile(TextLine *textLines, int numLines) {
-    FILE *file = fopen("tasks.txt", "w");
-    if (file != NULL) {
-        for (int i = 0; i < numLines; ++i) {
-            fprintf(file, "%s\n", textLines[i].text);
+// Fonction pour construire les noms des fichiers d'un tableau (dans le dossier courant)
+bool setBoardFiles(BoardFiles *files, const char *name) {
+    if (name[0] == '\0' || strlen(name) >= MAX_BOARD_NAME || strpbrk(name, "/\\:") != NULL) {
+        printf("Invalid board name %s.\n", name);
+        return false;
+    }
+    SDL_strlcpy(files->name, name, sizeof(files->name));
+    SDL_snprintf(files->tasks, sizeof(files->tasks), "%s.db", name);
+    SDL_snprintf(files->done, sizeof(files->done), "%s_done.db", name);
+    SDL_snprintf(files->archive, sizeof(files->archive), "%s_archive.db", name);
+    SDL_snprintf(files->inbox, sizeof(files->inbox), "%s.txt", name);
+    SDL_snprintf(files->timelineLog, sizeof(files->timelineLog), "%s_timeline.log", name);
+    SDL_snprintf(files->timelinePages, sizeof(files->timelinePages), "%s_timeline.pages", name);
+    SDL_snprintf(files->lock, sizeof(files->lock), "%s.lock", name);
+    SDL_snprintf(files->socket, sizeof(files->socket), "%s.sock", name);
+    return true;
+}
+
+// Structure pour les compteurs du rendu depuis le démarrage, lus par l'affichage des
+// performances (F3) : appels de dessin, textes rendus et recherches dans le cache des textures
+typedef struct {
+    Uint64 drawCalls;
+    Uint64 rasterized;
+    Uint64 cacheHits;
+    Uint64 cacheMisses;
+} RenderCounters;
+
+RenderCounters renderCounters;
+
+// Structure pour les compteurs d'allocations d'un domaine
+typedef struct {
+    Uint64 count;
+    Uint64 bytes;
+} AllocCounter;
+
+// Structure pour le comptage des allocations faites par SDL_malloc (notre code, SDL et SDL_ttf),
+// par image et par domaine. Chaque bloc est précédé de sa taille pour suivre la mémoire occupée.
+typedef struct {
+    bool enabled;
+    SDL_SpinLock lock;
+    SDL_malloc_func originalMalloc;
+    SDL_calloc_func originalCalloc;
+    SDL_realloc_func originalRealloc;
+    SDL_free_func originalFree;
+    AllocCounter frame[ALLOC_ZONES];     // Image en cours
+    AllocCounter lastFrame[ALLOC_ZONES]; // Dernière image terminée
+    AllocCounter total[ALLOC_ZONES];
+    Uint64 frees;
+    Sint64 live;          // Octets alloués et pas encore libérés
+    Sint64 peak;
+    Sint64 framePeak;     // Pic de l'image en cours
+    Sint64 lastFramePeak;
+    Uint64 frames;
+    Uint64 framesWithAllocs;
+    Uint64 maxFrameAllocs;
+} AllocStats;
+
+AllocStats allocStats;
+// Domaine des allocations du fil courant (voir setAllocZone)
+_Thread_local int allocZone = ALLOC_OTHER;
+
+// Fonction pour choisir le domaine auquel sont attribuées les allocations du fil courant ;
+// renvoie le domaine précédent
+int setAllocZone(int zone) {
+    int previous = allocZone;
+    allocZone = zone;
+    return previous;
+}
+
+// Fonction pour compter une allocation (size > 0) ou une libération (size < 0)
+void countAllocation(Sint64 size) {
+    SDL_AtomicLock(&allocStats.lock);
+    if (size > 0) {
+        allocStats.frame[allocZone].count++;
+        allocStats.frame[allocZone].bytes += (Uint64)size;
+    } else {
+        allocStats.frees++;
+    }
+    allocStats.live += size;
+    allocStats.peak = allocStats.live > allocStats.peak ? allocStats.live : allocStats.peak;
+    allocStats.framePeak = allocStats.live > allocStats.framePeak ? allocStats.live : allocStats.framePeak;
+    SDL_AtomicUnlock(&allocStats.lock);
+}
+
+// Fonctions installées par SDL_SetMemoryFunctions : le bloc rendu suit un en-tête de
+// ALLOC_HEADER octets qui garde sa taille (et l'alignement de malloc)
+void *countedMalloc(size_t size) {
+    Uint8 *block = allocStats.originalMalloc(size + ALLOC_HEADER);
+    if (block == NULL) {
+        return NULL;
+    }
+    memcpy(block, &size, sizeof(size));
+    countAllocation((Sint64)size);
+    return block + ALLOC_HEADER;
+}
+
+void *countedCalloc(size_t count, size_t size) {
+    if (size != 0 && count > (SIZE_MAX - ALLOC_HEADER) / size) {
+        return NULL;
+    }
+    size_t total = count * size;
+    Uint8 *block = allocStats.originalCalloc(1, total + ALLOC_HEADER);
+    if (block == NULL) {
+        return NULL;
+    }
+    memcpy(block, &total, sizeof(total));
+    countAllocation((Sint64)total);
+    return block + ALLOC_HEADER;
+}
+
+void *countedRealloc(void *memory, size_t size) {
+    if (memory == NULL) {
+        return countedMalloc(size);
+    }
+    Uint8 *block = (Uint8 *)memory - ALLOC_HEADER;
+    size_t oldSize;
+    memcpy(&oldSize, block, sizeof(oldSize));
+    block = allocStats.originalRealloc(block, size + ALLOC_HEADER);
+    if (block == NULL) {
+        return NULL;
+    }
+    memcpy(block, &size, sizeof(size));
+    // Une réallocation compte comme une allocation de la nouvelle taille et une libération
+    countAllocation(-(Sint64)oldSize);
+    countAllocation((Sint64)size);
+    return block + ALLOC_HEADER;
+}
+
+void countedFree(void *memory) {
+    if (memory == NULL) {
+        return;
+    }
+    Uint8 *block = (Uint8 *)memory - ALLOC_HEADER;
+    size_t size;
+    memcpy(&size, block, sizeof(size));
+    countAllocation(-(Sint64)size);
+    allocStats.originalFree(block);
+}
+
+// Fonction pour installer le comptage des allocations. Elle doit être appelée avant toute
+// autre fonction de SDL : un bloc alloué avant n'aurait pas d'en-tête.
+bool startAllocStats(void) {
+    SDL_GetOriginalMemoryFunctions(&allocStats.originalMalloc, &allocStats.originalCalloc, &allocStats.originalRealloc,
+                                   &allocStats.originalFree);
+    if (SDL_SetMemoryFunctions(countedMalloc, countedCalloc, countedRealloc, countedFree) != 0) {
+        printf("Error installing the allocation counters: %s\n", SDL_GetError());
+        return false;
+    }
+    allocStats.enabled = true;
+    return true;
+}
+
+// Fonction pour terminer l'image en cours : ses compteurs deviennent ceux de la dernière image
+void endAllocFrame(void) {
+    SDL_AtomicLock(&allocStats.lock);
+    Uint64 count = 0;
+    for (int z = 0; z < ALLOC_ZONES; ++z) {
+        allocStats.lastFrame[z] = allocStats.frame[z];
+        allocStats.total[z].count += allocStats.frame[z].count;
+        allocStats.total[z].bytes += allocStats.frame[z].bytes;
+        count += allocStats.frame[z].count;
+        allocStats.frame[z] = (AllocCounter){0, 0};
+    }
+    allocStats.frames++;
+    allocStats.framesWithAllocs += count > 0;
+    allocStats.maxFrameAllocs = count > allocStats.maxFrameAllocs ? count : allocStats.maxFrameAllocs;
+    allocStats.lastFramePeak = allocStats.framePeak;
+    allocStats.framePeak = allocStats.live;
+    SDL_AtomicUnlock(&allocStats.lock);
+}
+
+// Fonction pour compter les allocations de la dernière image, tous domaines confondus
+Uint64 lastFrameAllocs(void) {
+    Uint64 count = 0;
+    for (int z = 0; z < ALLOC_ZONES; ++z) {
+        count += allocStats.lastFrame[z].count;
+    }
+    return count;
+}
+
+// Fonction pour afficher le bilan des allocations (à la sortie)
+void printAllocStats(void) {
+    static const char *zones[ALLOC_ZONES] = {"events", "update", "storage", "render", "raster", "overlay", "other"};
+    endAllocFrame();
+    printf("Allocations over %llu frames (%llu frames allocated, at most %llu allocations in a frame):\n",
+           (unsigned long long)allocStats.frames, (unsigned long long)allocStats.framesWithAllocs, (unsigned long long)allocStats.maxFrameAllocs);
+    for (int z = 0; z < ALLOC_ZONES; ++z) {
+        printf("  %-8s %10llu allocations %12llu bytes (%.1f per frame)\n", zones[z], (unsigned long long)allocStats.total[z].count,
+               (unsigned long long)allocStats.total[z].bytes, (double)allocStats.total[z].count / (double)(allocStats.frames > 0 ? allocStats.frames : 1));
+    }
+    printf("  %llu frees, peak %.1f MB, %lld bytes still allocated\n", (unsigned long long)allocStats.frees, allocStats.peak / 1e6,
+           (long long)allocStats.live);
+}
+
+// Structure pour la mémoire de travail d'une image : allocations par simple décalage dans un
+// bloc, rendues en une fois (fin de portée ou fin d'image). Quand le bloc est plein, elles
+// débordent sur des blocs séparés et le bloc est agrandi à la fin de l'image : les images
+// suivantes n'allouent plus rien. Seul le fil de l'interface s'en sert.
+typedef struct {
+    Uint8 *memory;
+    size_t capacity;
+    size_t used;
+    size_t wanted;       // Plus grand besoin depuis la dernière fin d'image
+    void **overflow;     // Blocs de débordement, libérés en fin de portée ou d'image
+    int numOverflow;
+    int overflowCapacity;
+    size_t overflowBytes;
+} FrameArena;
+
+// Structure pour une position dans la mémoire de travail (début d'une portée)
+typedef struct {
+    size_t used;
+    int numOverflow;
+    size_t overflowBytes;
+} ArenaMark;
+
+FrameArena frameArena;
+
+// Fonction pour allouer dans la mémoire de travail (alignement de 16 octets)
+void *arenaAlloc(FrameArena *arena, size_t size) {
+    size = (size + 15) & ~(size_t)15;
+    void *memory = NULL;
+    if (arena->used + size <= arena->capacity) {
+        memory = arena->memory + arena->used;
+        arena->used += size;
+    } else {
+        if (arena->numOverflow == arena->overflowCapacity) {
+            int newCapacity = arena->overflowCapacity > 0 ? arena->overflowCapacity * 2 : 16;
+            void **overflow = SDL_realloc(arena->overflow, (size_t)newCapacity * sizeof(void *));
+            if (overflow == NULL) {
+                return NULL;
+            }
+            arena->overflow = overflow;
+            arena->overflowCapacity = newCapacity;
+        }
+        memory = SDL_malloc(size);
+        if (memory == NULL) {
+            return NULL;
+        }
+        arena->overflow[arena->numOverflow++] = memory;
+        arena->overflowBytes += size;
+    }
+    if (arena->used + arena->overflowBytes > arena->wanted) {
+        arena->wanted = arena->used + arena->overflowBytes;
+    }
+    return memory;
+}
+
+// Fonction pour relever la position courante de la mémoire de travail
+ArenaMark arenaMark(const FrameArena *arena) {
+    return (ArenaMark){arena->used, arena->numOverflow, arena->overflowBytes};
+}
+
+// Fonction pour rendre tout ce qui a été alloué depuis mark (portées imbriquées : la plus
+// récente est rendue en premier)
+void arenaRelease(FrameArena *arena, ArenaMark mark) {
+    arena->used = mark.used;
+    while (arena->numOverflow > mark.numOverflow) {
+        SDL_free(arena->overflow[--arena->numOverflow]);
+    }
+    arena->overflowBytes = mark.overflowBytes;
+}
+
+// Fonction pour vider la mémoire de travail en fin d'image, en agrandissant le bloc s'il a
+// débordé pendant l'image
+void resetFrameArena(FrameArena *arena) {
+    arenaRelease(arena, (ArenaMark){0, 0, 0});
+    if (arena->wanted > arena->capacity) {
+        size_t capacity = arena->capacity > 0 ? arena->capacity : FRAME_ARENA_SIZE;
+        while (capacity < arena->wanted) {
+            capacity *= 2;
+        }
+        SDL_free(arena->memory);
+        arena->memory = SDL_malloc(capacity);
+        arena->capacity = arena->memory != NULL ? capacity : 0;
+    }
+    arena->wanted = 0;
+}
+
+// Fonction pour libérer la mémoire de travail
+void freeFrameArena(FrameArena *arena) {
+    arenaRelease(arena, (ArenaMark){0, 0, 0});
+    SDL_free(arena->memory);
+    SDL_free(arena->overflow);
+    memset(arena, 0, sizeof(*arena));
+}
+
+// Structure pour une zone mesurée (début et durée en unités de SDL_GetPerformanceCounter).
+// Le nom est une chaîne constante du programme : il n'est pas copié.
+typedef struct {
+    const char *name;
+    Uint64 start;
+    Uint64 duration;
+} TraceZone;
+
+// Structure pour les zones d'un fil : un anneau écrit par ce seul fil, sans verrou. Le nombre
+// de zones écrites n'est publié qu'une fois la zone complète, ce qui permet de lire l'anneau
+// depuis un autre fil.
+typedef struct {
+    const char *threadName;
+    SDL_atomic_t written;
+    TraceZone zones[TRACE_RING_SIZE];
+} TraceRing;
+
+// Structure pour la trace des phases, écrite au format Chrome trace (chrome://tracing, Perfetto)
+typedef struct {
+    bool enabled;
+    const char *path;
+    Uint64 start;
+    SDL_atomic_t numRings;
+    TraceRing *rings[TRACE_MAX_THREADS];
+} Tracer;
+
+Tracer tracer;
+// Anneau du fil courant (créé à sa première zone) et nom affiché pour ce fil
+_Thread_local TraceRing *traceRing;
+_Thread_local const char *traceThreadName = "main";
+
+// Fonction pour nommer le fil courant dans la trace (avant sa première zone)
+void nameTraceThread(const char *name) {
+    traceThreadName = name;
+}
+
+// Fonction pour commencer une zone : renvoie son début, ou 0 si la trace est désactivée
+// (une seule comparaison, la zone n'est alors pas mesurée)
+Uint64 beginTraceZone(void) {
+    return tracer.enabled ? SDL_GetPerformanceCounter() : 0;
+}
+
+// Fonction pour terminer une zone commencée par beginTraceZone et l'ajouter à l'anneau du fil
+void endTraceZone(Uint64 start, const char *name) {
+    if (start == 0) {
+        return;
+    }
+    Uint64 end = SDL_GetPerformanceCounter();
+    TraceRing *ring = traceRing;
+    if (ring == NULL) {
+        int index = SDL_AtomicAdd(&tracer.numRings, 1);
+        if (index >= TRACE_MAX_THREADS) {
+            return;
+        }
+        ring = SDL_calloc(1, sizeof(TraceRing));
+        if (ring == NULL) {
+            return;
+        }
+        ring->threadName = traceThreadName;
+        SDL_AtomicSetPtr((void **)&tracer.rings[index], ring);
+        traceRing = ring;
+    }
+    int written = SDL_AtomicGet(&ring->written);
+    TraceZone *zone = &ring->zones[written & (TRACE_RING_SIZE - 1)];
+    zone->name = name;
+    zone->start = start;
+    zone->duration = end - start;
+    SDL_AtomicSet(&ring->written, written + 1);
+}
+
+// Fonction pour écrire la trace (les TRACE_RING_SIZE dernières zones de chaque fil) au format
+// JSON de Chrome trace. Les anneaux sont copiés avant l'écriture, puis les zones que leur fil a
+// écrasées pendant la copie sont écartées.
+bool writeTrace(const char *path) {
+    if (!tracer.enabled) {
+        printf("Tracing is off (start with --trace <file>).\n");
+        return false;
+    }
+    TraceZone *copy = SDL_malloc(sizeof(TraceZone) * TRACE_RING_SIZE);
+    FILE *file = fopen(path, "w");
+    if (copy == NULL || file == NULL) {
+        printf("Error opening %s for writing.\n", path);
+        SDL_free(copy);
+        if (file != NULL) {
+            fclose(file);
+        }
+        return false;
+    }
+    double tickUs = 1e6 / (double)SDL_GetPerformanceFrequency();
+    int numRings = SDL_min(SDL_AtomicGet(&tracer.numRings), TRACE_MAX_THREADS);
+    int numZones = 0;
+    const char *separator = "";
+    fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+    for (int t = 0; t < numRings; ++t) {
+        TraceRing *ring = SDL_AtomicGetPtr((void **)&tracer.rings[t]);
+        if (ring == NULL) {
+            continue;
+        }
+        fprintf(file, "%s\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+                separator, t + 1, ring->threadName);
+        separator = ",";
+        int end = SDL_AtomicGet(&ring->written);
+        int first = end > TRACE_RING_SIZE ? end - TRACE_RING_SIZE : 0;
+        memcpy(copy, ring->zones, sizeof(TraceZone) * TRACE_RING_SIZE);
+        // Le fil peut être en train d'écrire la zone written, qui occupe la place de la zone
+        // written - TRACE_RING_SIZE : celle-ci est donc écartée aussi
+        int overwritten = SDL_AtomicGet(&ring->written) - TRACE_RING_SIZE + 1;
+        first = SDL_max(first, overwritten);
+        for (int i = first; i < end; ++i) {
+            const TraceZone *zone = &copy[i & (TRACE_RING_SIZE - 1)];
+            fprintf(file, ",\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}", zone->name,
+                    t + 1, (double)(zone->start - tracer.start) * tickUs, (double)zone->duration * tickUs);
+            numZones++;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    bool ok = fclose(file) == 0;
+    SDL_free(copy);
+    if (ok) {
+        printf("Trace written to %s (%d zones).\n", path, numZones);
+    } else {
+        printf("Error writing %s.\n", path);
+    }
+    return ok;
+}
+
+// Fonction pour écrire la trace à la sortie du programme, quel que soit le mode
+void writeTraceAtExit(void) {
+    writeTrace(tracer.path);
+    tracer.enabled = false;
+}
+
+// Fonction pour activer la trace des phases, écrite dans path à la sortie
+void startTrace(const char *path) {
+    tracer.path = path;
+    tracer.start = SDL_GetPerformanceCounter();
+    tracer.enabled = true;
+    atexit(writeTraceAtExit);
+}
+
+// Fonction pour agrandir le tableau de tâches si nécessaire
+bool reserveTasks(Board *board, int count) {
+    if (count <= board->capacity) {
+        return true;
+    }
+    int newCapacity = board->capacity > 0 ? board->capacity : 64;
+    while (newCapacity < count) {
+        newCapacity *= 2;
+    }
+    TextLine *lines = SDL_realloc(board->lines, (size_t)newCapacity * sizeof(TextLine));
+    if (lines == NULL) {
+        printf("Error allocating memory for %d tasks.\n", newCapacity);
+        return false;
+    }
+    board->lines = lines;
+    board->capacity = newCapacity;
+    board->ordered = false;
+    return true;
+}
+
+// Fonction pour agrandir le suivi des pages (modifications et CRC) si nécessaire
+bool reservePages(PageStore *store, int numPages) {
+    if (numPages <= store->pageCapacity) {
+        return true;
+    }
+    int newCapacity = store->pageCapacity > 0 ? store->pageCapacity : 64;
+    while (newCapacity < numPages) {
+        newCapacity *= 2;
+    }
+    Uint8 *dirtyPages = SDL_realloc(store->dirtyPages, newCapacity);
+    if (dirtyPages == NULL) {
+        return false;
+    }
+    store->dirtyPages = dirtyPages;
+    Uint32 *pageCrcs = SDL_realloc(store->pageCrcs, (size_t)newCapacity * sizeof(Uint32));
+    if (pageCrcs == NULL) {
+        return false;
+    }
+    store->pageCrcs = pageCrcs;
+    Uint8 *pageTasks = SDL_realloc(store->pageTasks, newCapacity);
+    if (pageTasks == NULL) {
+        return false;
+    }
+    store->pageTasks = pageTasks;
+    memset(dirtyPages + store->pageCapacity, 0, newCapacity - store->pageCapacity);
+    memset(pageCrcs + store->pageCapacity, 0, (size_t)(newCapacity - store->pageCapacity) * sizeof(Uint32));
+    memset(pageTasks + store->pageCapacity, 0, newCapacity - store->pageCapacity);
+    store->pageCapacity = newCapacity;
+    return true;
+}
+
+// Fonction pour marquer une page (déjà suivie) comme modifiée, en étendant l'intervalle
+// des pages à parcourir au prochain enregistrement
+void markPageDirty(PageStore *store, int page) {
+    store->dirtyPages[page] = 1;
+    if (store->dirtyFrom == store->dirtyTo) {
+        store->dirtyFrom = page;
+        store->dirtyTo = page + 1;
+    } else {
+        store->dirtyFrom = page < store->dirtyFrom ? page : store->dirtyFrom;
+        store->dirtyTo = page >= store->dirtyTo ? page + 1 : store->dirtyTo;
+    }
+}
+
+// Fonction pour marquer la page qui contient une tâche comme modifiée
+void markTaskDirty(PageStore *store, int index) {
+    int page = index / RECORDS_PER_PAGE;
+    store->changes++;
+    if (!reservePages(store, page + 1)) {
+        // Sans suivi possible, le prochain enregistrement réécrit tout
+        store->rewriteAll = true;
+        return;
+    }
+    markPageDirty(store, page);
+}
+
+// Fonction pour obtenir le nombre d'emplacements présents en mémoire (tâches et emplacements libres)
+int loadedTasks(const Board *board) {
+    return board->numLines - board->baseIndex;
+}
+
+// Fonction pour obtenir le nombre de tâches d'un tableau, y compris celles restées sur disque
+int countTasks(const Board *board) {
+    return board->numLines - board->numFree;
+}
+
+// Fonction pour extraire les trigrammes distincts d'un texte, en minuscules (ASCII),
+// triés par ordre croissant. Renvoie leur nombre.
+int extractTrigrams(const char *text, Uint32 *trigrams) {
+    int count = 0;
+    size_t length = strlen(text);
+    for (size_t i = 0; i + 2 < length; ++i) {
+        Uint32 trigram = 0;
+        for (int k = 0; k < 3; ++k) {
+            Uint8 c = (Uint8)text[i + k];
+            trigram = trigram << 8 | (c >= 'A' && c <= 'Z' ? c + 32 : c);
+        }
+        trigrams[count++] = trigram;
+    }
+    // Tri par insertion : au plus MAX_TEXT_LENGTH trigrammes, souvent déjà presque triés
+    for (int i = 1; i < count; ++i) {
+        Uint32 trigram = trigrams[i];
+        int j = i;
+        while (j > 0 && trigrams[j - 1] > trigram) {
+            trigrams[j] = trigrams[j - 1];
+            --j;
+        }
+        trigrams[j] = trigram;
+    }
+    int unique = 0;
+    for (int i = 0; i < count; ++i) {
+        if (unique == 0 || trigrams[unique - 1] != trigrams[i]) {
+            trigrams[unique++] = trigrams[i];
+        }
+    }
+    return unique;
+}
+
+// Fonction pour trouver la liste de tâches d'un trigramme (create : la créer si elle n'existe pas)
+Posting *findPosting(TrigramIndex *index, Uint32 trigram, bool create) {
+    if (create && (index->numPostings + 1) * 2 > index->capacity) {
+        int newCapacity = index->capacity > 0 ? index->capacity * 2 : 1024;
+        Posting *postings = SDL_calloc((size_t)newCapacity, sizeof(Posting));
+        if (postings == NULL) {
+            return NULL;
+        }
+        for (int i = 0; i < index->capacity; ++i) {
+            if (index->postings[i].key != 0) {
+                int slot = (int)((index->postings[i].key * 0x9E3779B1u) >> 8) & (newCapacity - 1);
+                while (postings[slot].key != 0) {
+                    slot = (slot + 1) & (newCapacity - 1);
+                }
+                postings[slot] = index->postings[i];
+            }
+        }
+        SDL_free(index->postings);
+        index->postings = postings;
+        index->capacity = newCapacity;
+    }
+    if (index->capacity == 0) {
+        return NULL;
+    }
+    Uint32 key = trigram + 1;
+    int slot = (int)((key * 0x9E3779B1u) >> 8) & (index->capacity - 1);
+    while (index->postings[slot].key != 0) {
+        if (index->postings[slot].key == key) {
+            return &index->postings[slot];
+        }
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+    if (!create) {
+        return NULL;
+    }
+    index->postings[slot].key = key;
+    index->numPostings++;
+    return &index->postings[slot];
+}
+
+// Fonction pour trouver la position de id dans une liste triée (ou celle où l'insérer)
+int lowerBound(const Uint32 *ids, int count, Uint32 id) {
+    int low = 0, high = count;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (ids[middle] < id) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+// Fonction pour vérifier si un texte contient query (déjà en minuscules), sans tenir compte de la casse
+bool containsIgnoreCase(const char *text, const char *query) {
+    for (; *text != '\0'; ++text) {
+        int k = 0;
+        while (query[k] != '\0') {
+            Uint8 c = (Uint8)text[k];
+            if ((c >= 'A' && c <= 'Z' ? c + 32 : c) != (Uint8)query[k]) {
+                break;
+            }
+            ++k;
+        }
+        if (query[k] == '\0') {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Fonction pour trouver la position de value dans un tableau trié (ou celle où l'insérer)
+int lowerBound16(const Uint16 *values, int count, Uint16 value) {
+    int low = 0, high = count;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (values[middle] < value) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+// Fonction pour compter les bits à 1 d'un mot
+int countBits64(Uint64 x) {
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int)((x * 0x0101010101010101ull) >> 56);
+}
+
+// Fonction pour trouver la position du conteneur de clé key (ou celle où l'insérer)
+int findTagContainer(const TagBitmap *bitmap, Uint16 key) {
+    // Les tâches sont surtout ajoutées en fin de tableau : essayer d'abord le dernier conteneur
+    int count = bitmap->numContainers;
+    if (count > 0 && bitmap->containers[count - 1].key <= key) {
+        return bitmap->containers[count - 1].key == key ? count - 1 : count;
+    }
+    int low = 0, high = count;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (bitmap->containers[middle].key < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+// Fonction pour savoir si un conteneur contient une valeur
+bool containerContains(const TagContainer *container, Uint16 value) {
+    if (container->bits != NULL) {
+        return (container->bits[value >> 6] >> (value & 63)) & 1;
+    }
+    int position = lowerBound16(container->values, container->count, value);
+    return position < container->count && container->values[position] == value;
+}
+
+// Fonction pour savoir si une tâche fait partie d'un ensemble
+bool tagBitmapContains(const TagBitmap *bitmap, Uint32 id) {
+    int position = findTagContainer(bitmap, (Uint16)(id >> 16));
+    return position < bitmap->numContainers && bitmap->containers[position].key == (id >> 16) &&
+           containerContains(&bitmap->containers[position], (Uint16)id);
+}
+
+// Fonction pour compter les tâches d'un ensemble
+int tagBitmapCount(const TagBitmap *bitmap) {
+    int count = 0;
+    for (int c = 0; c < bitmap->numContainers; ++c) {
+        count += bitmap->containers[c].count;
+    }
+    return count;
+}
+
+// Fonction pour écrire les tâches d'un ensemble dans ids, par ordre croissant. Renvoie leur nombre.
+int tagBitmapIds(const TagBitmap *bitmap, Uint32 *ids) {
+    int count = 0;
+    for (int c = 0; c < bitmap->numContainers; ++c) {
+        const TagContainer *container = &bitmap->containers[c];
+        Uint32 high = (Uint32)container->key << 16;
+        if (container->bits == NULL) {
+            for (int i = 0; i < container->count; ++i) {
+                ids[count++] = high | container->values[i];
+            }
+            continue;
+        }
+        for (int w = 0; w < TAG_BITMAP_WORDS; ++w) {
+            for (Uint64 word = container->bits[w]; word != 0; word &= word - 1) {
+                ids[count++] = high | (Uint32)(w * 64 + countBits64((word & (~word + 1)) - 1));
+            }
+        }
+    }
+    return count;
+}
+
+// Fonction pour obtenir la mémoire occupée par les valeurs d'un conteneur
+size_t tagContainerBytes(const TagContainer *container) {
+    return container->bits != NULL ? TAG_BITMAP_WORDS * sizeof(Uint64) : (size_t)container->capacity * sizeof(Uint16);
+}
+
+// Fonction pour obtenir la mémoire occupée par un ensemble
+size_t tagBitmapBytes(const TagBitmap *bitmap) {
+    size_t bytes = (size_t)bitmap->capacity * sizeof(TagContainer);
+    for (int c = 0; c < bitmap->numContainers; ++c) {
+        bytes += tagContainerBytes(&bitmap->containers[c]);
+    }
+    return bytes;
+}
+
+// Fonction pour ranger count valeurs données sous forme de bitmap dans un nouveau conteneur
+// (dont seule la clé est renseignée), en tableau s'il y en a peu
+bool storeContainerWords(TagContainer *container, const Uint64 *words, int count) {
+    container->count = count;
+    if (count > TAG_ARRAY_MAX) {
+        container->bits = SDL_malloc(TAG_BITMAP_WORDS * sizeof(Uint64));
+        if (container->bits == NULL) {
+            return false;
+        }
+        memcpy(container->bits, words, TAG_BITMAP_WORDS * sizeof(Uint64));
+        return true;
+    }
+    container->values = SDL_malloc((size_t)count * sizeof(Uint16));
+    if (container->values == NULL) {
+        return false;
+    }
+    container->capacity = count;
+    int n = 0;
+    for (int w = 0; w < TAG_BITMAP_WORDS; ++w) {
+        for (Uint64 word = words[w]; word != 0; word &= word - 1) {
+            container->values[n++] = (Uint16)(w * 64 + countBits64((word & (~word + 1)) - 1));
+        }
+    }
+    return true;
+}
+
+// Fonction pour ajouter une tâche à un ensemble
+bool addToTagBitmap(TagBitmap *bitmap, Uint32 id) {
+    Uint16 key = (Uint16)(id >> 16), value = (Uint16)id;
+    int position = findTagContainer(bitmap, key);
+    if (position == bitmap->numContainers || bitmap->containers[position].key != key) {
+        if (bitmap->numContainers == bitmap->capacity) {
+            int newCapacity = bitmap->capacity > 0 ? bitmap->capacity * 2 : 4;
+            TagContainer *containers = SDL_realloc(bitmap->containers, (size_t)newCapacity * sizeof(TagContainer));
+            if (containers == NULL) {
+                return false;
+            }
+            bitmap->containers = containers;
+            bitmap->capacity = newCapacity;
+        }
+        memmove(bitmap->containers + position + 1, bitmap->containers + position, (size_t)(bitmap->numContainers - position) * sizeof(TagContainer));
+        memset(&bitmap->containers[position], 0, sizeof(TagContainer));
+        bitmap->containers[position].key = key;
+        bitmap->numContainers++;
+    }
+
+    TagContainer *container = &bitmap->containers[position];
+    if (container->bits != NULL) {
+        Uint64 mask = 1ull << (value & 63);
+        if ((container->bits[value >> 6] & mask) == 0) {
+            container->bits[value >> 6] |= mask;
+            container->count++;
+        }
+        return true;
+    }
+    int at = container->count > 0 && container->values[container->count - 1] < value ? container->count : lowerBound16(container->values, container->count, value);
+    if (at < container->count && container->values[at] == value) {
+        return true;
+    }
+    if (container->count == TAG_ARRAY_MAX) {
+        // Tableau plein : passer en bitmap
+        Uint64 *bits = SDL_calloc(TAG_BITMAP_WORDS, sizeof(Uint64));
+        if (bits == NULL) {
+            return false;
+        }
+        for (int i = 0; i < container->count; ++i) {
+            bits[container->values[i] >> 6] |= 1ull << (container->values[i] & 63);
+        }
+        bits[value >> 6] |= 1ull << (value & 63);
+        SDL_free(container->values);
+        container->values = NULL;
+        container->capacity = 0;
+        container->bits = bits;
+        container->count++;
+        return true;
+    }
+    if (container->count == container->capacity) {
+        int newCapacity = container->capacity > 0 ? container->capacity * 2 : 4;
+        newCapacity = newCapacity > TAG_ARRAY_MAX ? TAG_ARRAY_MAX : newCapacity;
+        Uint16 *values = SDL_realloc(container->values, (size_t)newCapacity * sizeof(Uint16));
+        if (values == NULL) {
+            return false;
+        }
+        container->values = values;
+        container->capacity = newCapacity;
+    }
+    memmove(container->values + at + 1, container->values + at, (size_t)(container->count - at) * sizeof(Uint16));
+    container->values[at] = value;
+    container->count++;
+    return true;
+}
+
+// Fonction pour retirer une tâche d'un ensemble
+void removeFromTagBitmap(TagBitmap *bitmap, Uint32 id) {
+    Uint16 key = (Uint16)(id >> 16), value = (Uint16)id;
+    int position = findTagContainer(bitmap, key);
+    if (position == bitmap->numContainers || bitmap->containers[position].key != key) {
+        return;
+    }
+    TagContainer *container = &bitmap->containers[position];
+    if (container->bits != NULL) {
+        Uint64 mask = 1ull << (value & 63);
+        if ((container->bits[value >> 6] & mask) == 0) {
+            return;
+        }
+        container->bits[value >> 6] &= ~mask;
+        container->count--;
+        // Repasser en tableau bien en dessous du seuil, pour ne pas alterner à chaque modification
+        TagContainer array = {key, 0, 0, NULL, NULL};
+        if (container->count < TAG_ARRAY_MAX / 2 && storeContainerWords(&array, container->bits, container->count)) {
+            SDL_free(container->bits);
+            *container = array;
+        }
+    } else {
+        int at = lowerBound16(container->values, container->count, value);
+        if (at == container->count || container->values[at] != value) {
+            return;
+        }
+        memmove(container->values + at, container->values + at + 1, (size_t)(container->count - at - 1) * sizeof(Uint16));
+        container->count--;
+    }
+    if (container->count == 0) {
+        SDL_free(container->values);
+        SDL_free(container->bits);
+        memmove(container, container + 1, (size_t)(bitmap->numContainers - position - 1) * sizeof(TagContainer));
+        bitmap->numContainers--;
+    }
+}
+
+// Fonction pour libérer un ensemble
+void freeTagBitmap(TagBitmap *bitmap) {
+    for (int c = 0; c < bitmap->numContainers; ++c) {
+        SDL_free(bitmap->containers[c].values);
+        SDL_free(bitmap->containers[c].bits);
+    }
+    SDL_free(bitmap->containers);
+    memset(bitmap, 0, sizeof(*bitmap));
+}
+
+// Fonction pour obtenir un conteneur sous forme de bitmap
+void containerWords(const TagContainer *container, Uint64 *words) {
+    if (container->bits != NULL) {
+        memcpy(words, container->bits, TAG_BITMAP_WORDS * sizeof(Uint64));
+        return;
+    }
+    memset(words, 0, TAG_BITMAP_WORDS * sizeof(Uint64));
+    for (int i = 0; i < container->count; ++i) {
+        words[container->values[i] >> 6] |= 1ull << (container->values[i] & 63);
+    }
+}
+
+// Fonction pour combiner deux conteneurs de même clé (NULL : conteneur vide) avec FILTER_AND,
+// FILTER_OR ou FILTER_AND_NOT. Renvoie false si le résultat est vide (ou la mémoire insuffisante).
+bool combineContainers(const TagContainer *a, const TagContainer *b, int op, TagContainer *out) {
+    memset(out, 0, sizeof(*out));
+    out->key = a != NULL ? a->key : b->key;
+    if ((a == NULL && op != FILTER_OR) || (b == NULL && op == FILTER_AND)) {
+        return false;
+    }
+    if (a == NULL || b == NULL) {
+        // Un seul conteneur : le recopier
+        const TagContainer *only = a != NULL ? a : b;
+        Uint64 words[TAG_BITMAP_WORDS];
+        if (only->bits != NULL) {
+            return storeContainerWords(out, only->bits, only->count);
+        }
+        containerWords(only, words);
+        return storeContainerWords(out, words, only->count);
+    }
+
+    // Intersection ou différence avec un tableau : le résultat est une partie du tableau,
+    // chaque valeur est cherchée dans l'autre conteneur
+    const TagContainer *array = NULL;
+    if (a->bits == NULL && op != FILTER_OR) {
+        array = a;
+    } else if (b->bits == NULL && op == FILTER_AND) {
+        array = b;
+    }
+    if (array != NULL) {
+        const TagContainer *other = array == a ? b : a;
+        out->values = SDL_malloc((size_t)array->count * sizeof(Uint16));
+        if (out->values == NULL) {
+            return false;
+        }
+        out->capacity = array->count;
+        for (int i = 0; i < array->count; ++i) {
+            if (containerContains(other, array->values[i]) == (op == FILTER_AND)) {
+                out->values[out->count++] = array->values[i];
+            }
+        }
+        if (out->count == 0) {
+            SDL_free(out->values);
+            out->values = NULL;
+        }
+        return out->count > 0;
+    }
+
+    // Sinon, combiner les bitmaps mot à mot
+    Uint64 x[TAG_BITMAP_WORDS], y[TAG_BITMAP_WORDS];
+    containerWords(a, x);
+    containerWords(b, y);
+    int count = 0;
+    for (int w = 0; w < TAG_BITMAP_WORDS; ++w) {
+        x[w] = op == FILTER_AND ? x[w] & y[w] : (op == FILTER_OR ? x[w] | y[w] : x[w] & ~y[w]);
+        count += countBits64(x[w]);
+    }
+    return count > 0 && storeContainerWords(out, x, count);
+}
+
+// Fonction pour combiner deux ensembles (FILTER_AND, FILTER_OR ou FILTER_AND_NOT) dans out
+bool combineTagBitmaps(const TagBitmap *a, const TagBitmap *b, int op, TagBitmap *out) {
+    memset(out, 0, sizeof(*out));
+    int capacity = a->numContainers + b->numContainers;
+    if (capacity == 0) {
+        return true;
+    }
+    out->containers = SDL_malloc((size_t)capacity * sizeof(TagContainer));
+    if (out->containers == NULL) {
+        return false;
+    }
+    out->capacity = capacity;
+    int i = 0, j = 0;
+    while (i < a->numContainers || j < b->numContainers) {
+        const TagContainer *x = i < a->numContainers ? &a->containers[i] : NULL;
+        const TagContainer *y = j < b->numContainers ? &b->containers[j] : NULL;
+        if (x != NULL && y != NULL && x->key != y->key) {
+            if (x->key < y->key) {
+                y = NULL;
+            } else {
+                x = NULL;
+            }
+        }
+        i += x != NULL;
+        j += y != NULL;
+        if (combineContainers(x, y, op, &out->containers[out->numContainers])) {
+            out->numContainers++;
+        }
+    }
+    return true;
+}
+
+// Fonction pour savoir si un caractère peut faire partie d'une étiquette
+bool isTagChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+}
+
+// Fonction pour lire le nom d'une étiquette (après le #), en minuscules. Renvoie sa longueur.
+int readTagName(const char **text, char name[MAX_TAG_LENGTH]) {
+    int length = 0;
+    for (; isTagChar(**text); ++*text) {
+        if (length < MAX_TAG_LENGTH - 1) {
+            char c = **text;
+            name[length++] = (char)(c >= 'A' && c <= 'Z' ? c + 32 : c);
+        }
+    }
+    name[length] = '\0';
+    return length;
+}
+
+// Fonction pour extraire les étiquettes distinctes (#tag) d'un texte. Une étiquette commence
+// par une lettre : « #42 » est un numéro, pas une étiquette. Renvoie leur nombre.
+int extractTags(const char *text, char tags[][MAX_TAG_LENGTH], int maxTags) {
+    int count = 0;
+    while ((text = strchr(text, '#')) != NULL && count < maxTags) {
+        ++text;
+        if (readTagName(&text, tags[count]) == 0 || tags[count][0] < 'a' || tags[count][0] > 'z') {
+            continue;
+        }
+        bool seen = false;
+        for (int t = 0; t < count && !seen; ++t) {
+            seen = strcmp(tags[t], tags[count]) == 0;
+        }
+        count += !seen;
+    }
+    return count;
+}
+
+// Fonction pour calculer le hachage d'un nom d'étiquette (FNV-1a)
+Uint32 tagNameHash(const char *name) {
+    Uint32 hash = 2166136261u;
+    for (; *name != '\0'; ++name) {
+        hash = (hash ^ (Uint8)*name) * 16777619u;
+    }
+    return hash;
+}
+
+// Fonction pour trouver une étiquette de l'index (create : la créer si elle n'existe pas).
+// Renvoie son numéro, -1 si elle n'existe pas.
+int findTag(TrigramIndex *index, const char *name, bool create) {
+    Uint32 hash = tagNameHash(name);
+    int slot = -1;
+    if (index->tagSlotCapacity > 0) {
+        slot = (int)(hash & (Uint32)(index->tagSlotCapacity - 1));
+        while (index->tagSlots[slot] != 0) {
+            int t = index->tagSlots[slot] - 1;
+            if (strcmp(index->tags[t].name, name) == 0) {
+                return t;
+            }
+            slot = (slot + 1) & (index->tagSlotCapacity - 1);
+        }
+    }
+    if (!create) {
+        return -1;
+    }
+    if ((index->numTags + 1) * 2 > index->tagSlotCapacity) {
+        // Agrandir la table et y replacer les étiquettes
+        int newCapacity = index->tagSlotCapacity > 0 ? index->tagSlotCapacity * 2 : 64;
+        int *slots = SDL_calloc((size_t)newCapacity, sizeof(int));
+        if (slots == NULL) {
+            return -1;
+        }
+        for (int t = 0; t < index->numTags; ++t) {
+            int s = (int)(tagNameHash(index->tags[t].name) & (Uint32)(newCapacity - 1));
+            while (slots[s] != 0) {
+                s = (s + 1) & (newCapacity - 1);
+            }
+            slots[s] = t + 1;
+        }
+        SDL_free(index->tagSlots);
+        index->tagSlots = slots;
+        index->tagSlotCapacity = newCapacity;
+        slot = (int)(hash & (Uint32)(newCapacity - 1));
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & (newCapacity - 1);
+        }
+    }
+    if (index->numTags == index->tagCapacity) {
+        int newCapacity = index->tagCapacity > 0 ? index->tagCapacity * 2 : 16;
+        Tag *tags = SDL_realloc(index->tags, (size_t)newCapacity * sizeof(Tag));
+        if (tags == NULL) {
+            return -1;
+        }
+        index->tags = tags;
+        index->tagCapacity = newCapacity;
+    }
+    Tag *tag = &index->tags[index->numTags];
+    memset(tag, 0, sizeof(*tag));
+    SDL_strlcpy(tag->name, name, sizeof(tag->name));
+    index->tagSlots[slot] = index->numTags + 1;
+    return index->numTags++;
+}
+
+// Fonction pour évaluer le code d'une vue filtrée sur une tâche (numéro id) déjà indexée.
+// Les champs sont lus dans ceux de l'index et les textes courts dans les titres compacts
+// (en minuscules) : le TextLine n'est lu que pour un texte plus long qu'un titre. Les
+// étiquettes sont cherchées dans leurs ensembles.
+bool runQuery(const Query *query, const TrigramIndex *index, const TextLine *line, Uint32 id) {
+    const TaskFields *fields = &index->fields[id - (Uint32)index->titleBase];
+    const char *title = (const char *)index->titles + (size_t)(id - (Uint32)index->titleBase) * PALETTE_TITLE_WIDTH;
+    bool result = false;
+    for (int pc = 0; pc < query->codeLength; ++pc) {
+        const QueryInstr *instr = &query->code[pc];
+        switch (instr->op) {
+            case QUERY_OP_TAG:
+                result = tagBitmapContains(&index->tags[query->tagIds[instr->value]].tasks, id);
+                break;
+            case QUERY_OP_TEXT:
+                if (title[PALETTE_TITLE_WIDTH - 1] == '\0') {
+                    result = strstr(title, query->strings[instr->value]) != NULL;
+                } else {
+                    result = containsIgnoreCase(line->text, query->strings[instr->value]);
+                }
+                break;
+            case QUERY_OP_COMPARE: {
+                // Âge depuis le passage dans "Done" : -1 pour une tâche pas terminée, qui ne correspond jamais
+                Sint64 field = fields->column;
+                if (instr->field == QUERY_FIELD_AGE) {
+                    field = (Sint64)query->now - fields->createdAt;
+                } else if (instr->field == QUERY_FIELD_DONE) {
+                    field = fields->doneAt != 0 ? (Sint64)query->now - fields->doneAt : -1;
+                }
+                Sint64 value = instr->value;
+                switch (instr->compare) {
+                    case QUERY_EQUAL: result = field == value; break;
+                    case QUERY_NOT_EQUAL: result = field != value; break;
+                    case QUERY_LESS: result = field < value; break;
+                    case QUERY_LESS_EQUAL: result = field <= value; break;
+                    case QUERY_GREATER: result = field > value; break;
+                    default: result = field >= value; break;
+                }
+                result = result && field >= 0;
+                break;
+            }
+            case QUERY_OP_NOT:
+                result = !result;
+                break;
+            case QUERY_OP_JUMP_IF_FALSE:
+                pc = result ? pc : instr->target - 1;
+                break;
+            default:
+                pc = result ? instr->target - 1 : pc;
+                break;
+        }
+    }
+    return result;
+}
+
+// Fonction pour ajouter une tâche aux ensembles de ses étiquettes, ou l'en retirer, et tenir
+// à jour la vue filtrée en cours
+void tagTask(TrigramIndex *index, int id, const char *text, bool add) {
+    char names[MAX_TASK_TAGS][MAX_TAG_LENGTH];
+    int numNames = extractTags(text, names, MAX_TASK_TAGS);
+    for (int t = 0; t < numNames; ++t) {
+        int tag = findTag(index, names[t], add);
+        if (tag < 0) {
+            continue;
+        }
+        if (add) {
+            addToTagBitmap(&index->tags[tag].tasks, (Uint32)id);
+        } else {
+            removeFromTagBitmap(&index->tags[tag].tasks, (Uint32)id);
+        }
+    }
+    if (add) {
+        addToTagBitmap(&index->indexed, (Uint32)id);
+        const struct Board *board = index->board;
+        if (index->view.codeLength > 0 && board != NULL && runQuery(&index->view, index, &board->lines[id - board->baseIndex], (Uint32)id)) {
+            addToTagBitmap(&index->filtered, (Uint32)id);
+        }
+    } else {
+        removeFromTagBitmap(&index->indexed, (Uint32)id);
+        removeFromTagBitmap(&index->filtered, (Uint32)id);
+    }
+}
+
+// Fonction pour savoir si une tâche en mémoire (lines[i]) est affichée : un emplacement libre
+// ne l'est jamais et, avec une vue filtrée, seules les tâches de la vue et celle en cours
+// d'édition le sont
+bool isTaskShown(const Board *board, int i) {
+    const TrigramIndex *index = board->search;
+    if (board->lines[i].isFree) {
+        return false;
+    }
+    return index == NULL || index->view.codeLength == 0 || board->lines[i].isEditing ||
+           tagBitmapContains(&index->filtered, (Uint32)(board->baseIndex + i));
+}
+
+// Fonction pour agrandir les titres et les champs des tâches si nécessaire (la mémoire
+// ajoutée est mise à zéro)
+bool reserveTitles(TrigramIndex *index, int count) {
+    if (count <= index->titleCapacity) {
+        return true;
+    }
+    // Capacité multiple de 16 : la palette compare les titres par blocs de 16
+    int newCapacity = index->titleCapacity > 0 ? index->titleCapacity : 1024;
+    while (newCapacity < count) {
+        newCapacity *= 2;
+    }
+    Uint8 *titles = SDL_realloc(index->titles, (size_t)newCapacity * PALETTE_TITLE_WIDTH);
+    if (titles == NULL) {
+        return false;
+    }
+    memset(titles + (size_t)index->titleCapacity * PALETTE_TITLE_WIDTH, 0, (size_t)(newCapacity - index->titleCapacity) * PALETTE_TITLE_WIDTH);
+    index->titles = titles;
+    TaskFields *fields = SDL_realloc(index->fields, (size_t)newCapacity * sizeof(TaskFields));
+    if (fields == NULL) {
+        return false;
+    }
+    memset(fields + index->titleCapacity, 0, (size_t)(newCapacity - index->titleCapacity) * sizeof(TaskFields));
+    index->fields = fields;
+    index->titleCapacity = newCapacity;
+    return true;
+}
+
+// Fonction pour ranger le titre d'une tâche, en minuscules, dans les titres compacts de la
+// palette et ses champs dans ceux des vues filtrées (line NULL : les effacer). Les titres
+// couvrent les tâches titleBase à titleBase + numTitles - 1 ; au-delà, la mémoire réservée
+// reste à zéro.
+void packTask(TrigramIndex *index, int id, const TextLine *line) {
+    index->version++;
+    if (line == NULL) {
+        if (id >= index->titleBase && id < index->titleBase + index->numTitles) {
+            memset(index->titles + (size_t)(id - index->titleBase) * PALETTE_TITLE_WIDTH, 0, PALETTE_TITLE_WIDTH);
+            memset(&index->fields[id - index->titleBase], 0, sizeof(TaskFields));
+            if (id == index->titleBase + index->numTitles - 1) {
+                index->numTitles--;
+            }
+        }
+        return;
+    }
+    if (index->numTitles == 0) {
+        index->titleBase = id;
+    }
+    int first = id < index->titleBase ? id : index->titleBase;
+    int end = id + 1 > index->titleBase + index->numTitles ? id + 1 : index->titleBase + index->numTitles;
+    if (!reserveTitles(index, end - first)) {
+        return;
+    }
+    if (id < index->titleBase) {
+        // Pages plus anciennes chargées : décaler les titres et les champs existants
+        int shift = index->titleBase - id;
+        memmove(index->titles + (size_t)shift * PALETTE_TITLE_WIDTH, index->titles, (size_t)index->numTitles * PALETTE_TITLE_WIDTH);
+        memset(index->titles, 0, (size_t)shift * PALETTE_TITLE_WIDTH);
+        memmove(index->fields + shift, index->fields, (size_t)index->numTitles * sizeof(TaskFields));
+        memset(index->fields, 0, (size_t)shift * sizeof(TaskFields));
+        index->titleBase = id;
+    }
+    index->numTitles = end - first;
+    index->fields[id - index->titleBase] = (TaskFields){line->createdAt, line->doneAt, line->column};
+
+    const char *text = line->text;
+    Uint8 *row = index->titles + (size_t)(id - index->titleBase) * PALETTE_TITLE_WIDTH;
+    int k = 0;
+    for (; k < PALETTE_TITLE_WIDTH && text[k] != '\0'; ++k) {
+        Uint8 c = (Uint8)text[k];
+        row[k] = c >= 'A' && c <= 'Z' ? c + 32 : c;
+    }
+    memset(row + k, 0, PALETTE_TITLE_WIDTH - k);
+}
+
+// Fonction pour ajouter (add) ou retirer une tâche de la liste d'un trigramme, en tenant
+// à jour son nombre de tâches et la mémoire de l'index d'après le seul conteneur modifié
+bool changePosting(TrigramIndex *index, Posting *posting, Uint32 id, bool add) {
+    TagBitmap *ids = &posting->ids;
+    Uint16 key = (Uint16)(id >> 16);
+    int counts[2];
+    size_t bytes[2];
+    bool ok = true;
+    for (int pass = 0; pass < 2; ++pass) {
+        int position = findTagContainer(ids, key);
+        const TagContainer *container = position < ids->numContainers && ids->containers[position].key == key ? &ids->containers[position] : NULL;
+        counts[pass] = container != NULL ? container->count : 0;
+        bytes[pass] = (size_t)ids->capacity * sizeof(TagContainer) + (container != NULL ? tagContainerBytes(container) : 0);
+        if (pass == 0 && add) {
+            ok = addToTagBitmap(ids, id);
+        } else if (pass == 0) {
+            removeFromTagBitmap(ids, id);
+        }
+    }
+    posting->count += counts[1] - counts[0];
+    index->idBytes += bytes[1] - bytes[0];
+    return ok;
+}
+
+// Fonction pour ajouter une tâche à la liste d'un trigramme
+bool addToPosting(TrigramIndex *index, Uint32 trigram, Uint32 id) {
+    Posting *posting = findPosting(index, trigram, true);
+    return posting != NULL && changePosting(index, posting, id, true);
+}
+
+// Fonction pour retirer une tâche de la liste d'un trigramme
+void removeFromPosting(TrigramIndex *index, Uint32 trigram, Uint32 id) {
+    Posting *posting = findPosting(index, trigram, false);
+    if (posting != NULL) {
+        changePosting(index, posting, id, false);
+    }
+}
+
+// Fonction pour ajouter une tâche aux listes des trigrammes de son texte (add) ou l'en retirer
+bool changePostings(TrigramIndex *index, Uint32 id, const char *text, bool add) {
+    Uint32 trigrams[MAX_TEXT_LENGTH];
+    int count = extractTrigrams(text, trigrams);
+    for (int t = 0; t < count; ++t) {
+        if (add && !addToPosting(index, trigrams[t], id)) {
+            return false;
+        } else if (!add) {
+            removeFromPosting(index, trigrams[t], id);
+        }
+    }
+    return true;
+}
+
+// Fonction pour faire au plus budget modifications reportées des listes de trigrammes, dans
+// l'ordre où elles ont été demandées (appelée à chaque image jusqu'à ce qu'il n'en reste plus)
+void applyPendingPostings(TrigramIndex *index, int budget) {
+    if (index == NULL || index->numPending == 0) {
+        return;
+    }
+    for (; index->firstPending < index->numPending && budget > 0; ++index->firstPending, --budget) {
+        const PendingPosting *change = &index->pending[index->firstPending];
+        changePostings(index, change->id, index->pendingTexts + change->text, change->add);
+    }
+    if (index->firstPending == index->numPending && !index->batching) {
+        SDL_free(index->pending);
+        SDL_free(index->pendingTexts);
+        index->pending = NULL;
+        index->pendingTexts = NULL;
+        index->firstPending = index->numPending = index->pendingCapacity = 0;
+        index->pendingTextLength = index->pendingTextCapacity = 0;
+    }
+}
+
+// Fonction pour faire toutes les modifications reportées des listes de trigrammes, avant de
+// les lire
+void flushPendingPostings(TrigramIndex *index) {
+    applyPendingPostings(index, SDL_MAX_SINT32);
+}
+
+// Fonction pour reporter l'ajout ou le retrait d'une tâche des listes de trigrammes. Sans
+// mémoire pour la noter, tout ce qui est en attente est fait, puis cette modification.
+void addPendingPosting(TrigramIndex *index, Uint32 id, const char *text, bool add) {
+    size_t length = strlen(text) + 1;
+    if (index->numPending == index->pendingCapacity) {
+        int newCapacity = index->pendingCapacity > 0 ? index->pendingCapacity * 2 : 256;
+        PendingPosting *pending = SDL_realloc(index->pending, (size_t)newCapacity * sizeof(PendingPosting));
+        if (pending != NULL) {
+            index->pending = pending;
+            index->pendingCapacity = newCapacity;
+        }
+    }
+    if (index->pendingTextLength + length > index->pendingTextCapacity) {
+        size_t newCapacity = index->pendingTextCapacity > 0 ? index->pendingTextCapacity * 2 : 8192;
+        while (newCapacity < index->pendingTextLength + length) {
+            newCapacity *= 2;
+        }
+        char *texts = SDL_realloc(index->pendingTexts, newCapacity);
+        if (texts != NULL) {
+            index->pendingTexts = texts;
+            index->pendingTextCapacity = newCapacity;
+        }
+    }
+    if (index->numPending == index->pendingCapacity || index->pendingTextLength + length > index->pendingTextCapacity) {
+        bool batching = index->batching;
+        index->batching = false;
+        flushPendingPostings(index);
+        index->batching = batching;
+        changePostings(index, id, text, add);
+        return;
+    }
+    memcpy(index->pendingTexts + index->pendingTextLength, text, length);
+    index->pending[index->numPending++] = (PendingPosting){id, (Uint32)index->pendingTextLength, add};
+    index->pendingTextLength += length;
+}
+
+// Fonctions pour commencer et terminer une modification groupée (beaucoup de tâches
+// ajoutées, déplacées ou supprimées d'un coup) : les listes de trigrammes ne sont pas
+// modifiées pendant l'opération, mais ensuite, par applyPendingPostings. Une recherche fait
+// d'abord tout ce qui reste.
+void beginIndexBatch(TrigramIndex *index) {
+    if (index != NULL) {
+        index->batching = true;
+    }
+}
+
+void endIndexBatch(TrigramIndex *index) {
+    if (index != NULL) {
+        index->batching = false;
+    }
+}
+
+// Fonction pour ajouter une tâche à l'index de recherche (aucun effet si index est NULL). Ses
+// trigrammes attendent si une modification groupée est en cours ou n'est pas encore faite.
+void indexTask(TrigramIndex *index, int id, const TextLine *line) {
+    if (index == NULL) {
+        return;
+    }
+    packTask(index, id, line);
+    tagTask(index, id, line->text, true);
+    if (index->batching || index->numPending > 0) {
+        addPendingPosting(index, (Uint32)id, line->text, true);
+    } else if (!changePostings(index, (Uint32)id, line->text, true)) {
+        return;
+    }
+    index->stale = true;
+}
+
+// Fonction pour retirer une tâche de l'index de recherche (aucun effet si index est NULL)
+void unindexTask(TrigramIndex *index, int id, const char *text) {
+    if (index == NULL) {
+        return;
+    }
+    packTask(index, id, NULL);
+    tagTask(index, id, text, false);
+    if (index->batching || index->numPending > 0) {
+        addPendingPosting(index, (Uint32)id, text, false);
+    } else {
+        changePostings(index, (Uint32)id, text, false);
+    }
+    index->stale = true;
+}
+
+// Fonction pour libérer l'index de recherche
+void freeTrigramIndex(TrigramIndex *index) {
+    for (int i = 0; i < index->capacity; ++i) {
+        freeTagBitmap(&index->postings[i].ids);
+    }
+    SDL_free(index->postings);
+    SDL_free(index->matches);
+    SDL_free(index->titles);
+    SDL_free(index->fields);
+    for (int t = 0; t < index->numTags; ++t) {
+        freeTagBitmap(&index->tags[t].tasks);
+    }
+    SDL_free(index->tags);
+    SDL_free(index->tagSlots);
+    freeTagBitmap(&index->indexed);
+    freeTagBitmap(&index->filtered);
+    SDL_free(index->pending);
+    SDL_free(index->pendingTexts);
+    memset(index, 0, sizeof(*index));
+}
+
+void shareAppendedTask(Board *board, TextLine *line, int index);
+void shareDeletedTask(Board *board, int index);
+void shareChangedTask(Board *board, int index, int reg);
+
+// Fonction pour obtenir l'emplacement d'une tâche en mémoire
+int taskSlot(const Board *board, const TextLine *line) {
+    return (int)(line - board->lines) + board->baseIndex;
+}
+
+// Fonction pour noter un emplacement libéré, à reprendre par un prochain ajout. Les
+// emplacements déjà repris sont retirés de la pile quand elle est pleine.
+void noteFreeSlot(Board *board, int index) {
+    if (board->appendOnly) {
+        return;
+    }
+    if (board->numFreeSlots == board->freeCapacity) {
+        int kept = 0;
+        for (int k = 0; k < board->numFreeSlots; ++k) {
+            int slot = board->freeSlots[k];
+            if (slot >= board->baseIndex && slot < board->numLines && board->lines[slot - board->baseIndex].isFree) {
+                board->freeSlots[kept++] = slot;
+            }
+        }
+        board->numFreeSlots = kept;
+    }
+    if (board->numFreeSlots * 2 >= board->freeCapacity) {
+        int newCapacity = board->freeCapacity > 0 ? board->freeCapacity * 2 : 256;
+        int *slots = SDL_realloc(board->freeSlots, (size_t)newCapacity * sizeof(int));
+        if (slots == NULL) {
+            // L'emplacement reste libre, sans être repris
+            return;
+        }
+        board->freeSlots = slots;
+        board->freeCapacity = newCapacity;
+    }
+    board->freeSlots[board->numFreeSlots++] = index;
+}
+
+// Fonction pour reprendre un emplacement libre. Renvoie -1 s'il n'y en a pas.
+int takeFreeSlot(Board *board) {
+    while (board->numFreeSlots > 0) {
+        int slot = board->freeSlots[--board->numFreeSlots];
+        if (slot >= board->baseIndex && slot < board->numLines && board->lines[slot - board->baseIndex].isFree) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+// Fonction pour trouver la première tâche en mémoire à partir de l'emplacement index (en
+// reprenant au début après la dernière). Renvoie -1 si le tableau n'en a aucune en mémoire.
+int nextLiveTask(const Board *board, int index) {
+    int count = loadedTasks(board);
+    int start = index - board->baseIndex;
+    start = start >= 0 && start < count ? start : 0;
+    for (int k = 0; k < count; ++k) {
+        int i = (start + k) % count;
+        if (!board->lines[i].isFree) {
+            return board->baseIndex + i;
+        }
+    }
+    return -1;
+}
+
+// Fonction pour occuper l'emplacement index avec une tâche : sans clé d'ordre (0), ou pour
+// un ajout local, la tâche est rangée après toutes les autres. Comme les identifiants, la
+// clé se termine par le numéro de l'instance : deux instances partagées qui ajoutent une
+// tâche en même temps ne lui donnent jamais la même clé.
+TextLine *placeTask(Board *board, int index, const TextLine *task, bool keepKey) {
+    TextLine *line = &board->lines[index - board->baseIndex];
+    *line = *task;
+    line->isFree = false;
+    if (!keepKey || line->orderKey == 0) {
+        line->orderKey = (board->lastOrderKey / ORDER_KEY_GAP + 1) * ORDER_KEY_GAP | (board->sync != NULL ? board->sync->replica : 0);
+    }
+    board->lastOrderKey = line->orderKey > board->lastOrderKey ? line->orderKey : board->lastOrderKey;
+    board->ordered = false;
+    if (board->sync != NULL) {
+        shareAppendedTask(board, line, index);
+    }
+    indexTask(board->search, index, line);
+    markTaskDirty(&board->store, index);
+    return line;
+}
+
+// Fonction pour ajouter une tâche au tableau : dans un emplacement libre, sauf pour la colonne
+// "Done" et l'archive où elle va à la fin. Elle est rangée après les autres, sauf une tâche reçue d'un
+// tableau partagé, qui garde sa clé.
+TextLine *appendTask(Board *board, const TextLine *task) {
+    int index = board->appendOnly ? -1 : takeFreeSlot(board);
+    if (index >= 0) {
+        board->numFree--;
+    } else {
+        if (!reserveTasks(board, loadedTasks(board) + 1)) {
+            return NULL;
+        }
+        index = board->numLines++;
+    }
+    return placeTask(board, index, task, board->sync != NULL && board->sync->applying);
+}
+
+// Fonction pour supprimer une tâche : son emplacement devient libre (rempli de zéros), les
+// autres tâches ne bougent pas et seule sa page est réécrite
+void deleteTask(Board *board, int index) {
+    TextLine *line = &board->lines[index - board->baseIndex];
+    unindexTask(board->search, index, line->text);
+    if (board->sync != NULL) {
+        shareDeletedTask(board, index);
+    }
+    memset(line, 0, sizeof(*line));
+    line->isFree = true;
+    board->numFree++;
+    board->ordered = false;
+    noteFreeSlot(board, index);
+    markTaskDirty(&board->store, index);
+}
+
+// Fonction pour remettre une tâche dans son emplacement libre index (inverse de deleteTask).
+// Elle garde sa clé d'ordre, donc sa place parmi les autres tâches ; sans clé (0), elle est
+// rangée après elles. Renvoie false si l'emplacement n'est pas libre.
+bool insertTask(Board *board, int index, const TextLine *task) {
+    if (index < board->baseIndex || index >= board->numLines || !board->lines[index - board->baseIndex].isFree) {
+        return false;
+    }
+    board->numFree--;
+    placeTask(board, index, task, true);
+    return true;
+}
+
+// Fonction pour remplacer le texte d'une tâche en tenant l'index à jour
+void setTaskText(Board *board, int index, const char *text) {
+    TextLine *line = &board->lines[index - board->baseIndex];
+    unindexTask(board->search, index, line->text);
+    SDL_strlcpy(line->text, text, MAX_TEXT_LENGTH);
+    indexTask(board->search, index, line);
+    markTaskDirty(&board->store, index);
+    if (board->sync != NULL) {
+        shareChangedTask(board, index, SYNC_TEXT);
+    }
+}
+
+// Fonction pour ajouter à la fin d'un autre tableau une copie d'une tâche passée dans column
+// (voir transferTask, qui retire ensuite l'originale)
+TextLine *copyTask(const Board *from, int index, Board *to, int column) {
+    TextLine task = from->lines[index - from->baseIndex];
+    task.column = column;
+    if (column != DONE_COLUMN) {
+        task.doneAt = 0;
+    } else if (task.doneAt == 0) {
+        task.doneAt = (Uint32)time(NULL);
+    }
+    return appendTask(to, &task);
+}
+
+// Fonction pour déplacer une tâche vers un autre tableau (par exemple vers la colonne "Done")
+bool transferTask(Board *from, int index, Board *to, int column) {
+    if (copyTask(from, index, to, column) == NULL) {
+        return false;
+    }
+    deleteTask(from, index);
+    return true;
+}
+
+// Fonction pour déplacer vers un autre tableau count tâches, ajoutées à la fin de to dans
+// l'ordre de indices. Renvoie le nombre de tâches déplacées.
+int transferTasks(Board *from, const int *indices, int count, Board *to, int column) {
+    int moved = 0;
+    while (moved < count && transferTask(from, indices[moved], to, column)) {
+        moved++;
+    }
+    return moved;
+}
+
+// Fonction pour changer une tâche de colonne sans la faire changer de tableau, en tenant à
+// jour la vue filtrée (qui peut porter sur la colonne)
+void setTaskColumn(Board *board, int index, int column) {
+    TextLine *line = &board->lines[index - board->baseIndex];
+    line->column = column;
+    markTaskDirty(&board->store, index);
+    TrigramIndex *search = board->search;
+    if (search != NULL && index >= search->titleBase && index < search->titleBase + search->numTitles) {
+        search->fields[index - search->titleBase].column = column;
+    }
+    if (search != NULL && search->view.codeLength > 0) {
+        removeFromTagBitmap(&search->filtered, (Uint32)index);
+        if (runQuery(&search->view, search, line, (Uint32)index)) {
+            addToTagBitmap(&search->filtered, (Uint32)index);
+        }
+    }
+    if (board->sync != NULL) {
+        shareChangedTask(board, index, SYNC_PLACE);
+    }
+}
+
+// Fonction pour libérer la mémoire du tableau de tâches
+void freeBoard(Board *board) {
+    SDL_free(board->lines);
+    SDL_free(board->freeSlots);
+    SDL_free(board->order);
+    SDL_free(board->store.dirtyPages);
+    SDL_free(board->store.pageCrcs);
+    SDL_free(board->store.pageTasks);
+    memset(board, 0, sizeof(*board));
+}
+
+// Fonctions pour lire et écrire un entier 32 bits en little-endian
+void writeLE32(Uint8 *dst, Uint32 value) {
+    value = SDL_SwapLE32(value);
+    memcpy(dst, &value, 4);
+}
+
+Uint32 readLE32(const Uint8 *src) {
+    Uint32 value;
+    memcpy(&value, src, 4);
+    return SDL_SwapLE32(value);
+}
+
+// Fonctions pour lire et écrire un entier 64 bits en little-endian
+void writeLE64(Uint8 *dst, Uint64 value) {
+    value = SDL_SwapLE64(value);
+    memcpy(dst, &value, 8);
+}
+
+Uint64 readLE64(const Uint8 *src) {
+    Uint64 value;
+    memcpy(&value, src, 8);
+    return SDL_SwapLE64(value);
+}
+
+// Table pour le calcul du CRC32 (polynôme 0xEDB88320) par tranches de 8 octets
+Uint32 crcTable[8][256];
+bool crcTableReady = false;
+
+// Fonction pour initialiser la table du CRC32
+void initCrc32Table(void) {
+    for (Uint32 i = 0; i < 256; ++i) {
+        Uint32 crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? 0xEDB88320 ^ (crc >> 1) : crc >> 1;
+        }
+        crcTable[0][i] = crc;
+    }
+    for (int i = 0; i < 256; ++i) {
+        for (int slice = 1; slice < 8; ++slice) {
+            crcTable[slice][i] = (crcTable[slice - 1][i] >> 8) ^ crcTable[0][crcTable[slice - 1][i] & 0xFF];
+        }
+    }
+    crcTableReady = true;
+}
+
+// Fonction pour calculer le CRC32 d'un bloc de données (8 octets par itération)
+Uint32 crc32(const void *data, size_t length) {
+    if (!crcTableReady) {
+        initCrc32Table();
+    }
+    const Uint8 *p = data;
+    Uint32 crc = 0xFFFFFFFF;
+    while (length >= 8) {
+        Uint32 one = crc ^ ((Uint32)p[0] | (Uint32)p[1] << 8 | (Uint32)p[2] << 16 | (Uint32)p[3] << 24);
+        Uint32 two = (Uint32)p[4] | (Uint32)p[5] << 8 | (Uint32)p[6] << 16 | (Uint32)p[7] << 24;
+        crc = crcTable[7][one & 0xFF] ^ crcTable[6][(one >> 8) & 0xFF] ^ crcTable[5][(one >> 16) & 0xFF] ^ crcTable[4][one >> 24] ^
+              crcTable[3][two & 0xFF] ^ crcTable[2][(two >> 8) & 0xFF] ^ crcTable[1][(two >> 16) & 0xFF] ^ crcTable[0][two >> 24];
+        p += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = crcTable[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// Fonction pour calculer le CRC d'un enregistrement : colonne, dates, clé d'ordre et texte
+// jusqu'à son zéro final (le reste de l'emplacement n'est que du remplissage)
+Uint32 recordCrc(const Uint8 *record) {
+    const Uint8 *end = memchr(record + RECORD_HEADER_SIZE, 0, MAX_TEXT_LENGTH);
+    size_t textLength = end != NULL ? (size_t)(end - (record + RECORD_HEADER_SIZE)) + 1 : MAX_TEXT_LENGTH;
+    return crc32(record + 4, RECORD_HEADER_SIZE - 4 + textLength);
+}
+
+// Fonction pour savoir si un enregistrement est un emplacement libre (rempli de zéros)
+bool isRecordFree(const Uint8 *record) {
+    for (int i = 0; i < RECORD_SIZE; ++i) {
+        if (record[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Fonction pour calculer le CRC d'une page à partir des CRC de ses enregistrements
+Uint32 pageCrc(const Uint8 *page) {
+    Uint8 crcs[RECORDS_PER_PAGE * 4];
+    for (int r = 0; r < RECORDS_PER_PAGE; ++r) {
+        memcpy(crcs + r * 4, page + r * RECORD_SIZE, 4);
+    }
+    return crc32(crcs, sizeof(crcs));
+}
+
+// Fonction pour obtenir le nombre de pages de données nécessaires
+int countPages(int numLines) {
+    return (numLines + RECORDS_PER_PAGE - 1) / RECORDS_PER_PAGE;
+}
+
+// Fonctions pour calculer la position des pages dans le fichier
+Sint64 tablePageOffset(int segment) {
+    return (Sint64)PAGE_SIZE * (1 + (Sint64)segment * (PAGES_PER_SEGMENT + 1));
+}
+
+Sint64 dataPageOffset(int page) {
+    return tablePageOffset(page / PAGES_PER_SEGMENT) + (Sint64)PAGE_SIZE * (1 + page % PAGES_PER_SEGMENT);
+}
+
+// Fonction pour obtenir le nombre d'emplacements (tâches ou emplacements libres) d'une page
+int pageRecordCount(int numLines, int page) {
+    int remaining = numLines - page * RECORDS_PER_PAGE;
+    if (remaining <= 0) {
+        return 0;
+    }
+    return remaining < RECORDS_PER_PAGE ? remaining : RECORDS_PER_PAGE;
+}
+
+// Fonction pour remplir une page de données à partir des tâches (chaque enregistrement :
+// CRC32, colonne, dates, clé d'ordre, texte ; un emplacement libre reste à zéro) et
+// mémoriser son CRC et son nombre de tâches. Une page restée sur disque n'est réécrite
+// que vidée par l'archivage.
+void encodeDataPage(Uint8 *page, Board *board, int pageIndex) {
+    memset(page, 0, PAGE_SIZE);
+    int first = pageIndex * RECORDS_PER_PAGE;
+    int count = first >= board->baseIndex ? pageRecordCount(board->numLines, pageIndex) : 0;
+    int tasks = 0;
+    for (int k = 0; k < count; ++k) {
+        const TextLine *line = &board->lines[first + k - board->baseIndex];
+        if (line->isFree) {
+            continue;
+        }
+        Uint8 *record = page + k * RECORD_SIZE;
+        writeLE32(record + 4, (Uint32)line->column);
+        writeLE32(record + 8, line->createdAt);
+        writeLE32(record + 12, line->doneAt);
+        writeLE64(record + 16, line->orderKey);
+        SDL_strlcpy((char *)record + RECORD_HEADER_SIZE, line->text, MAX_TEXT_LENGTH);
+        writeLE32(record, recordCrc(record));
+        tasks++;
+    }
+    board->store.pageCrcs[pageIndex] = pageCrc(page);
+    board->store.pageTasks[pageIndex] = (Uint8)tasks;
+}
+
+// Fonction pour remplir la page de table d'un segment (nombre de tâches et CRC
+// de chaque page), terminée par le CRC de la table elle-même
+void encodeTablePage(Uint8 *page, const Board *board, int segment) {
+    memset(page, 0, PAGE_SIZE);
+    for (int k = 0; k < PAGES_PER_SEGMENT; ++k) {
+        int p = segment * PAGES_PER_SEGMENT + k;
+        bool used = pageRecordCount(board->numLines, p) > 0;
+        writeLE32(page + k * PAGE_ENTRY_SIZE, used ? board->store.pageTasks[p] : 0);
+        writeLE32(page + k * PAGE_ENTRY_SIZE + 4, used ? board->store.pageCrcs[p] : 0);
+    }
+    writeLE32(page + PAGES_PER_SEGMENT * PAGE_ENTRY_SIZE, crc32(page, PAGES_PER_SEGMENT * PAGE_ENTRY_SIZE));
+}
+
+// Fonction pour écrire une page à sa position dans le fichier
+bool writePage(PageStore *store, SDL_RWops *rw, Sint64 offset, const Uint8 *page) {
+    if (SDL_RWseek(rw, offset, RW_SEEK_SET) < 0 || SDL_RWwrite(rw, page, PAGE_SIZE, 1) != 1) {
+        return false;
+    }
+    store->bytesWritten += PAGE_SIZE;
+    store->pagesWritten++;
+    return true;
+}
+
+// Fonction pour agrandir la liste des pages d'une version de la chronologie : les pages
+// ajoutées sont marquées absentes
+bool reserveTimelinePages(TimelinePage **pages, int *capacity, int numPages) {
+    if (numPages <= *capacity) {
+        return true;
+    }
+    int newCapacity = *capacity > 0 ? *capacity : 64;
+    while (newCapacity < numPages) {
+        newCapacity *= 2;
+    }
+    TimelinePage *newPages = SDL_realloc(*pages, (size_t)newCapacity * sizeof(TimelinePage));
+    if (newPages == NULL) {
+        printf("Error allocating memory for %d timeline pages.\n", newCapacity);
+        return false;
+    }
+    for (int p = *capacity; p < newCapacity; ++p) {
+        newPages[p] = (TimelinePage){TIMELINE_NO_PAGE, 0};
+    }
+    *pages = newPages;
+    *capacity = newCapacity;
+    return true;
+}
+
+// Fonction pour compacter une page de données avant de la recopier dans la chronologie :
+// sa taille, puis pour chaque enregistrement son CRC, sa colonne, ses dates, sa clé d'ordre
+// et son texte jusqu'au zéro final (le reste n'est que du remplissage). Renvoie la taille, complétée
+// jusqu'à un multiple de TIMELINE_COPY_ALIGN octets.
+int packTimelinePage(const Uint8 *page, Uint8 *out) {
+    int size = 4;
+    for (int r = 0; r < RECORDS_PER_PAGE; ++r) {
+        const Uint8 *record = page + r * RECORD_SIZE;
+        const Uint8 *end = memchr(record + RECORD_HEADER_SIZE, 0, MAX_TEXT_LENGTH);
+        int length = RECORD_HEADER_SIZE + (end != NULL ? (int)(end - (record + RECORD_HEADER_SIZE)) + 1 : MAX_TEXT_LENGTH);
+        memcpy(out + size, record, length);
+        size += length;
+    }
+    writeLE32(out, (Uint32)size);
+    while (size % TIMELINE_COPY_ALIGN != 0) {
+        out[size++] = 0;
+    }
+    return size;
+}
+
+// Fonction pour reconstituer une page de données à partir de sa copie compactée (available
+// octets lus). Renvoie false si la copie est tronquée.
+bool unpackTimelinePage(const Uint8 *data, int available, Uint8 *page) {
+    memset(page, 0, PAGE_SIZE);
+    int size = available >= 4 ? (int)readLE32(data) : 0;
+    if (size < 4 || size > available) {
+        return false;
+    }
+    int offset = 4;
+    for (int r = 0; r < RECORDS_PER_PAGE; ++r) {
+        Uint8 *record = page + r * RECORD_SIZE;
+        if (offset + RECORD_HEADER_SIZE > size) {
+            return false;
+        }
+        memcpy(record, data + offset, RECORD_HEADER_SIZE);
+        offset += RECORD_HEADER_SIZE;
+        int maxLength = size - offset < MAX_TEXT_LENGTH ? size - offset : MAX_TEXT_LENGTH;
+        const Uint8 *end = memchr(data + offset, 0, maxLength);
+        int length = end != NULL ? (int)(end - (data + offset)) + 1 : MAX_TEXT_LENGTH;
+        if (offset + length > size) {
+            return false;
+        }
+        memcpy(record + RECORD_HEADER_SIZE, data + offset, length);
+        offset += length;
+    }
+    return true;
+}
+
+// Fonction pour commencer une entrée de la chronologie : ouvre le fichier des pages
+// (complété si une écriture a été interrompue au milieu d'une copie)
+void beginTimelineDelta(TimelineWriter *writer) {
+    writer->numChanged = 0;
+    writer->pagesFile = NULL;
+    if (writer->failed) {
+        return;
+    }
+    writer->pagesFile = SDL_RWFromFile(writer->pagesPath, "ab");
+    if (writer->pagesFile == NULL) {
+        printf("Error opening %s for writing.\n", writer->pagesPath);
+        writer->failed = true;
+        return;
+    }
+    Sint64 size = SDL_RWsize(writer->pagesFile);
+    Uint8 padding[TIMELINE_COPY_ALIGN] = {0};
+    if (size < 0 || (size % TIMELINE_COPY_ALIGN != 0 &&
+                     SDL_RWwrite(writer->pagesFile, padding, TIMELINE_COPY_ALIGN - size % TIMELINE_COPY_ALIGN, 1) != 1)) {
+        writer->failed = true;
+    }
+    writer->nextCopy = (Uint32)((size + TIMELINE_COPY_ALIGN - 1) / TIMELINE_COPY_ALIGN);
+}
+
+// Fonction pour recopier une page enregistrée dans la chronologie, sauf si elle n'a pas
+// changé depuis la version précédente
+void recordTimelinePage(TimelineWriter *writer, int page, const Uint8 *data, Uint32 crc) {
+    if (writer->pagesFile == NULL || writer->failed) {
+        return;
+    }
+    if (page < countPages(writer->numLines) && writer->pages[page].crc == crc && writer->pages[page].copy != TIMELINE_NO_PAGE) {
+        return;
+    }
+    if (writer->numChanged + 3 > writer->changedCapacity) {
+        int newCapacity = writer->changedCapacity > 0 ? writer->changedCapacity * 2 : 96;
+        Uint32 *changed = SDL_realloc(writer->changed, (size_t)newCapacity * sizeof(Uint32));
+        if (changed == NULL) {
+            writer->failed = true;
+            return;
+        }
+        writer->changed = changed;
+        writer->changedCapacity = newCapacity;
+    }
+    Uint8 packed[PAGE_SIZE];
+    int size = packTimelinePage(data, packed);
+    if (SDL_RWwrite(writer->pagesFile, packed, size, 1) != 1) {
+        writer->failed = true;
+        return;
+    }
+    writer->changed[writer->numChanged++] = (Uint32)page;
+    writer->changed[writer->numChanged++] = writer->nextCopy;
+    writer->nextCopy += (Uint32)size / TIMELINE_COPY_ALIGN;
+    writer->changed[writer->numChanged++] = crc;
+}
+
+// Fonction pour terminer une entrée de la chronologie : les pages recopiées passent dans
+// la dernière version, puis l'entrée (ou une image clé) est ajoutée au journal. Sans page
+// modifiée ni changement du nombre de tâches, rien n'est écrit.
+void endTimelineDelta(TimelineWriter *writer, int numLines, bool saved) {
+    bool opened = writer->pagesFile != NULL;
+    if (opened && SDL_RWclose(writer->pagesFile) != 0) {
+        writer->failed = true;
+    }
+    writer->pagesFile = NULL;
+    if (!opened || writer->failed || !saved) {
+        return;
+    }
+    int numPages = countPages(numLines);
+    int numChanged = writer->numChanged / 3;
+    if (numChanged == 0 && numLines == writer->numLines && writer->started) {
+        return;
+    }
+    if (!reserveTimelinePages(&writer->pages, &writer->capacity, numPages)) {
+        writer->failed = true;
+        return;
+    }
+    for (int p = countPages(writer->numLines); p < numPages; ++p) {
+        writer->pages[p] = (TimelinePage){TIMELINE_NO_PAGE, 0};
+    }
+    for (int c = 0; c < numChanged; ++c) {
+        int p = (int)writer->changed[c * 3];
+        if (p < numPages) {
+            writer->pages[p] = (TimelinePage){writer->changed[c * 3 + 1], writer->changed[c * 3 + 2]};
+        }
+    }
+    writer->numLines = numLines;
+
+    // Image clé pour la première entrée du tableau, puis quand les entrées depuis la
+    // précédente sont assez nombreuses et assez lourdes
+    size_t keyframeBytes = TIMELINE_HEADER_SIZE + (size_t)numPages * 8 + 4;
+    bool keyframe = !writer->started || (writer->deltas >= TIMELINE_KEYFRAME_DELTAS && writer->deltaBytes * 4 >= keyframeBytes);
+    size_t size = keyframe ? keyframeBytes : TIMELINE_HEADER_SIZE + (size_t)numChanged * 12 + 4;
+    Uint8 *entry = SDL_malloc(size);
+    if (entry == NULL) {
+        writer->failed = true;
+        return;
+    }
+    Uint32 now = writer->now != 0 ? writer->now : (Uint32)time(NULL);
+    writeLE32(entry, (Uint32)(keyframe ? TIMELINE_KEYFRAME : TIMELINE_DELTA) | (Uint32)writer->slot << 8);
+    writeLE32(entry + 4, now);
+    writeLE32(entry + 8, (Uint32)numLines);
+    writeLE32(entry + 12, (Uint32)(keyframe ? numPages : numChanged));
+    Uint8 *payload = entry + TIMELINE_HEADER_SIZE;
+    if (keyframe) {
+        for (int p = 0; p < numPages; ++p) {
+            writeLE32(payload + p * 8, writer->pages[p].copy);
+            writeLE32(payload + p * 8 + 4, writer->pages[p].crc);
+        }
+    } else {
+        for (int i = 0; i < numChanged * 3; ++i) {
+            writeLE32(payload + i * 4, writer->changed[i]);
+        }
+    }
+    writeLE32(entry + size - 4, crc32(entry, size - 4));
+
+    // Le journal commence par son propre en-tête
+    SDL_RWops *rw = SDL_RWFromFile(writer->logPath, "ab");
+    bool ok = rw != NULL;
+    if (ok && SDL_RWsize(rw) == 0) {
+        Uint8 header[8];
+        writeLE32(header, TIMELINE_MAGIC);
+        writeLE32(header + 4, TIMELINE_VERSION);
+        ok = SDL_RWwrite(rw, header, sizeof(header), 1) == 1;
+    }
+    ok = ok && SDL_RWwrite(rw, entry, size, 1) == 1;
+    if (rw != NULL && SDL_RWclose(rw) != 0) {
+        ok = false;
+    }
+    SDL_free(entry);
+    if (!ok) {
+        printf("Error writing %s.\n", writer->logPath);
+        writer->failed = true;
+        return;
+    }
+    writer->started = true;
+    writer->deltas = keyframe ? 0 : writer->deltas + 1;
+    writer->deltaBytes = keyframe ? 0 : writer->deltaBytes + size;
+}
+
+// Fonction pour libérer la mémoire de l'enregistrement de la chronologie
+void freeTimelineWriter(TimelineWriter *writer) {
+    SDL_free(writer->pages);
+    SDL_free(writer->changed);
+    memset(writer, 0, sizeof(*writer));
+}
+
+// Fonction pour sauvegarder uniquement les pages modifiées depuis le dernier enregistrement
+bool saveDirtyPages(Board *board) {
+    const char *path = board->path;
+    PageStore *store = &board->store;
+    SDL_RWops *rw = NULL;
+    if (!store->rewriteAll) {
+        rw = SDL_RWFromFile(path, "r+b");
+    }
+    if (board->baseIndex > 0 && (rw == NULL || store->rewriteAll)) {
+        // Impossible de tout réécrire sans les pages restées sur disque
+        printf("Error opening %s for writing.\n", path);
+        return false;
+    }
+    if (rw == NULL) {
+        rw = SDL_RWFromFile(path, "w+b");
+        store->rewriteAll = true;
+    }
+    if (rw == NULL) {
+        printf("Error opening %s for writing.\n", path);
+        return false;
+    }
+
+    int numPages = countPages(board->numLines);
+    int oldPages = countPages(store->savedNumLines);
+    int numSegments = ((numPages > oldPages ? numPages : oldPages) + PAGES_PER_SEGMENT - 1) / PAGES_PER_SEGMENT;
+    Uint8 *dirtySegments = SDL_calloc(numSegments + 1, 1);
+    if (dirtySegments == NULL || !reservePages(store, numPages)) {
+        SDL_free(dirtySegments);
+        SDL_RWclose(rw);
+        printf("Error allocating memory for saving.\n");
+        return false;
+    }
+
+    Uint8 page[PAGE_SIZE];
+    bool ok = true;
+    store->bytesWritten = 0;
+    store->pagesWritten = 0;
+    if (board->timeline != NULL) {
+        beginTimelineDelta(board->timeline);
+    }
+
+    // Pages de données modifiées, recopiées aussi dans la chronologie (seul l'intervalle des
+    // pages marquées est parcouru : un ajout à la fin d'un grand tableau ne relit pas tout le suivi)
+    int firstPage = store->rewriteAll ? 0 : store->dirtyFrom;
+    int lastPage = store->rewriteAll || store->dirtyTo > numPages ? numPages : store->dirtyTo;
+    for (int p = firstPage; p < lastPage && ok; ++p) {
+        if (!store->rewriteAll && !store->dirtyPages[p]) {
+            continue;
+        }
+        // Une page restée sur disque n'est réécrite que vidée (voir archiveDonePages)
+        if (p * RECORDS_PER_PAGE < board->baseIndex && store->pageTasks[p] != 0) {
+            continue;
+        }
+        encodeDataPage(page, board, p);
+        ok = writePage(store, rw, dataPageOffset(p), page);
+        dirtySegments[p / PAGES_PER_SEGMENT] = 1;
+        if (board->timeline != NULL) {
+            recordTimelinePage(board->timeline, p, page, store->pageCrcs[p]);
+        }
+    }
+
+    // Si le nombre de tâches a changé, les compteurs des dernières pages changent aussi
+    bool headerChanged = store->rewriteAll || board->numLines != store->savedNumLines;
+    if (headerChanged) {
+        if (oldPages > 0) {
+            dirtySegments[(oldPages - 1) / PAGES_PER_SEGMENT] = 1;
+        }
+        if (numPages > 0) {
+            dirtySegments[(numPages - 1) / PAGES_PER_SEGMENT] = 1;
+        }
+    }
+
+    // Pages de table des segments touchés
+    for (int s = 0; s < numSegments && ok; ++s) {
+        if (dirtySegments[s]) {
+            encodeTablePage(page, board, s);
+            ok = writePage(store, rw, tablePageOffset(s), page);
+        }
+    }
+
+    // En-tête
+    if (ok && headerChanged) {
+        memset(page, 0, PAGE_SIZE);
+        writeLE32(page, DB_MAGIC);
+        writeLE32(page + 4, DB_VERSION);
+        writeLE32(page + 8, (Uint32)board->numLines);
+        writeLE32(page + 12, PAGE_SIZE);
+        writeLE32(page + 16, RECORDS_PER_PAGE);
+        writeLE32(page + 20, crc32(page, 20));
+        ok = writePage(store, rw, 0, page);
+    }
+
+    SDL_free(dirtySegments);
+    if (SDL_RWclose(rw) != 0) {
+        ok = false;
+    }
+    if (board->timeline != NULL) {
+        endTimelineDelta(board->timeline, board->numLines, ok);
+    }
+    if (!ok) {
+        printf("Error writing %s.\n", path);
+        return false;
+    }
+
+    if (store->dirtyTo > store->dirtyFrom) {
+        memset(store->dirtyPages + store->dirtyFrom, 0, (size_t)(store->dirtyTo - store->dirtyFrom));
+    }
+    store->dirtyFrom = store->dirtyTo = 0;
+    store->savedNumLines = board->numLines;
+    store->savedChanges = store->changes;
+    store->rewriteAll = false;
+    if (!store->quiet) {
+        printf("Tasks saved to file (%d pages, %llu bytes).\n", store->pagesWritten, (unsigned long long)store->bytesWritten);
+    }
+    return true;
+}
+
+// Fonction pour décoder les count emplacements d'une page de données, ajoutés après ceux
+// en mémoire. Chaque enregistrement est vérifié : un emplacement rempli de zéros est libre,
+// et un enregistrement illisible est écarté en laissant son emplacement libre (les tâches
+// suivantes gardent le leur). Ceux d'une page dont le CRC ne correspond pas à celui de la
+// table sont comptés comme récupérés. Renvoie le nombre de tâches décodées.
+int decodeDataPage(Board *board, const Uint8 *page, int count, bool pageValid, RecoveryStats *stats) {
+    int tasks = 0;
+    for (int r = 0; r < count; ++r) {
+        const Uint8 *record = page + r * RECORD_SIZE;
+        TextLine *line = &board->lines[loadedTasks(board)];
+        int index = board->numLines++;
+        if (readLE32(record) != recordCrc(record)) {
+            if (!isRecordFree(record)) {
+                stats->recordsDiscarded++;
+            }
+            memset(line, 0, sizeof(*line));
+            line->isFree = true;
+            board->numFree++;
+            noteFreeSlot(board, index);
+            continue;
+        }
+        if (!pageValid) {
+            stats->recordsSalvaged++;
+        }
+        line->column = (int)readLE32(record + 4);
+        line->createdAt = readLE32(record + 8);
+        line->doneAt = readLE32(record + 12);
+        line->orderKey = readLE64(record + 16);
+        memcpy(line->text, record + RECORD_HEADER_SIZE, MAX_TEXT_LENGTH);
+        line->text[MAX_TEXT_LENGTH - 1] = '\0';
+        line->isEditing = false;
+        line->isDragging = false;
+        line->isFree = false;
+        line->id = 0;
+        line->inputText[0] = '\0';
+        board->lastOrderKey = line->orderKey > board->lastOrderKey ? line->orderKey : board->lastOrderKey;
+        tasks++;
+    }
+    return tasks;
+}
+
+// Fonction pour charger les tâches depuis le fichier paginé en vérifiant les CRC.
+// Avec tailPages >= 0, seules les dernières pages sont lues : les autres restent
+// sur disque (seuls leur CRC et leur nombre de tâches sont lus dans la table).
+bool loadTasksFromDb(Board *board, RecoveryStats *stats, int tailPages) {
+    const char *path = board->path;
+    memset(stats, 0, sizeof(*stats));
+    SDL_RWops *rw = SDL_RWFromFile(path, "rb");
+    if (rw == NULL) {
+        return false;
+    }
+    Sint64 fileSize = SDL_RWsize(rw);
+
+    Uint8 page[PAGE_SIZE];
+    if (SDL_RWread(rw, page, PAGE_SIZE, 1) != 1 || readLE32(page) != DB_MAGIC) {
+        printf("Invalid task file %s.\n", path);
+        SDL_RWclose(rw);
+        return false;
+    }
+
+    // Nombre d'emplacements attendu, inconnu si l'en-tête est endommagé
+    int expected = -1;
+    if (readLE32(page + 20) == crc32(page, 20)) {
+        if (readLE32(page + 4) != DB_VERSION || readLE32(page + 12) != PAGE_SIZE || readLE32(page + 16) != RECORDS_PER_PAGE) {
+            printf("Unsupported task file %s (version %u).\n", path, readLE32(page + 4));
+            SDL_RWclose(rw);
+            return false;
+        }
+        expected = (int)readLE32(page + 8);
+    } else {
+        stats->headerDamaged = true;
+    }
+
+    // Avec un en-tête endommagé, tout le fichier est lu pour le récupérer
+    int firstPage = 0;
+    if (expected >= 0 && tailPages >= 0) {
+        firstPage = countPages(expected) - tailPages;
+        firstPage = firstPage < 0 ? 0 : firstPage;
+    }
+    if (!reserveTasks(board, (expected >= 0 ? expected : 0) - firstPage * RECORDS_PER_PAGE)) {
+        SDL_RWclose(rw);
+        return false;
+    }
+
+    Uint8 table[PAGE_SIZE];
+    bool tableValid = false;
+    board->numLines = 0;
+    board->baseIndex = 0;
+    board->numFree = 0;
+    board->numFreeSlots = 0;
+    board->lastOrderKey = 0;
+    stats->recordsLoaded = 0;
+    // Chaque page garde ses emplacements, même illisibles : aucune tâche ne change de numéro
+    for (int p = 0; expected < 0 || p < countPages(expected); ++p) {
+        int k = p % PAGES_PER_SEGMENT;
+        if (k == 0) {
+            if (SDL_RWseek(rw, tablePageOffset(p / PAGES_PER_SEGMENT), RW_SEEK_SET) < 0 || SDL_RWread(rw, table, PAGE_SIZE, 1) != 1) {
+                stats->truncated = expected >= 0;
+                break;
+            }
+            tableValid = readLE32(table + PAGES_PER_SEGMENT * PAGE_ENTRY_SIZE) == crc32(table, PAGES_PER_SEGMENT * PAGE_ENTRY_SIZE);
+            if (!tableValid) {
+                stats->pagesDamaged++;
+            }
+        }
+
+        // Sans en-tête fiable, la page est supposée pleine (les emplacements libres de la
+        // fin sont retirés après la lecture)
+        int slots = expected >= 0 ? pageRecordCount(expected, p) : RECORDS_PER_PAGE;
+        int tasks = slots;
+        Uint32 expectedCrc = 0;
+        if (tableValid) {
+            tasks = (int)readLE32(table + k * PAGE_ENTRY_SIZE);
+            expectedCrc = readLE32(table + k * PAGE_ENTRY_SIZE + 4);
+            tasks = tasks > slots ? slots : tasks;
+        }
+        if (!reservePages(&board->store, p + 1)) {
+            break;
+        }
+
+        // Page laissée sur disque ; une table douteuse oblige à tout charger à partir d'ici
+        if (p < firstPage && !tableValid) {
+            firstPage = p;
+        }
+        if (p < firstPage) {
+            board->store.pageCrcs[p] = expectedCrc;
+            board->store.pageTasks[p] = (Uint8)tasks;
+            board->numLines += slots;
+            board->numFree += slots - tasks;
+            board->baseIndex = board->numLines;
+            continue;
+        }
+
+        if (dataPageOffset(p) + PAGE_SIZE > fileSize || SDL_RWseek(rw, dataPageOffset(p), RW_SEEK_SET) < 0 ||
+            SDL_RWread(rw, page, PAGE_SIZE, 1) != 1) {
+            stats->truncated = expected >= 0;
+            break;
+        }
+        bool pageValid = tableValid && pageCrc(page) == expectedCrc;
+        if (tableValid && !pageValid) {
+            stats->pagesDamaged++;
+        }
+        if (!reserveTasks(board, loadedTasks(board) + slots)) {
+            break;
+        }
+        int discarded = stats->recordsDiscarded;
+        board->store.pageTasks[p] = (Uint8)decodeDataPage(board, page, slots, pageValid, stats);
+        stats->recordsLoaded += board->store.pageTasks[p];
+        board->store.pageCrcs[p] = pageValid ? expectedCrc : 0;
+        if ((!pageValid || stats->recordsDiscarded != discarded) && board->baseIndex > 0) {
+            markPageDirty(&board->store, p);
+        }
+    }
+    SDL_RWclose(rw);
+    if (expected < 0) {
+        // Emplacements libres de la fin : pages jamais écrites
+        while (loadedTasks(board) > 0 && board->lines[loadedTasks(board) - 1].isFree) {
+            board->numLines--;
+            board->numFree--;
+        }
+    } else if (board->numLines < expected && board->baseIndex > 0) {
+        // Fichier tronqué : les emplacements manquants restent libres pour que les pages
+        // restées sur disque gardent leur place
+        if (reserveTasks(board, expected - board->baseIndex) && reservePages(&board->store, countPages(expected))) {
+            memset(&board->lines[loadedTasks(board)], 0, (size_t)(expected - board->numLines) * sizeof(TextLine));
+            for (int i = loadedTasks(board); i < expected - board->baseIndex; ++i) {
+                board->lines[i].isFree = true;
+            }
+            for (int p = board->numLines / RECORDS_PER_PAGE; p < countPages(expected); ++p) {
+                board->store.pageTasks[p] = p * RECORDS_PER_PAGE < board->numLines ? board->store.pageTasks[p] : 0;
+                markPageDirty(&board->store, p);
+            }
+            board->numFree += expected - board->numLines;
+            board->numLines = expected;
+        }
+    }
+    board->ordered = false;
+
+    bool damaged = stats->headerDamaged || stats->truncated || stats->pagesDamaged > 0 || stats->recordsDiscarded > 0;
+    if (damaged) {
+        printf("Task file %s was damaged: %d tasks loaded (%d salvaged), %d discarded.\n",
+               path, stats->recordsLoaded, stats->recordsSalvaged, stats->recordsDiscarded);
+    }
+    if (board->baseIndex > 0) {
+        // Tableau chargé en partie : les pages réparées sont déjà marquées et l'en-tête
+        // reste valable, chaque tâche gardant son emplacement
+        board->store.savedNumLines = expected;
+    } else if (damaged) {
+        // Réécrire un fichier sain au prochain enregistrement
+        board->store.rewriteAll = true;
+    } else {
+        board->store.savedNumLines = board->numLines;
+    }
+    if (!board->store.quiet) {
+        printf("Tasks loaded from file.\n");
+    }
+    return true;
+}
+
+// Fonction pour charger les pages qui précèdent la partie en mémoire d'un tableau
+// chargé partiellement (défilement de la colonne "Done"). Toutes les pages sont lues
+// avant de toucher au tableau : si une lecture échoue, rien n'est décodé ni marqué
+// à réécrire et le tableau reste tel quel. Les pages sans tâche (vidées par l'archivage
+// et pas encore enregistrées) ne sont pas lues : leurs emplacements restent libres.
+bool loadEarlierPages(Board *board, int numPages) {
+    int endPage = board->baseIndex / RECORDS_PER_PAGE;
+    int firstPage = endPage - numPages < 0 ? 0 : endPage - numPages;
+    if (firstPage == endPage) {
+        return true;
+    }
+    SDL_RWops *rw = SDL_RWFromFile(board->path, "rb");
+    if (rw == NULL) {
+        printf("Error opening %s for reading.\n", board->path);
+        return false;
+    }
+    int count = (endPage - firstPage) * RECORDS_PER_PAGE;
+    Uint8 *pages = SDL_malloc((size_t)(endPage - firstPage) * PAGE_SIZE);
+    bool ok = pages != NULL;
+    for (int p = firstPage; p < endPage && ok; ++p) {
+        ok = board->store.pageTasks[p] == 0 ||
+             (SDL_RWseek(rw, dataPageOffset(p), RW_SEEK_SET) >= 0 && SDL_RWread(rw, pages + (size_t)(p - firstPage) * PAGE_SIZE, PAGE_SIZE, 1) == 1);
+    }
+    SDL_RWclose(rw);
+    int loaded = loadedTasks(board);
+    if (!ok || !reserveTasks(board, loaded + count)) {
+        printf("Error reading %s.\n", board->path);
+        SDL_free(pages);
+        return false;
+    }
+
+    // Décaler les tâches déjà chargées et décoder les pages lues dans l'espace libéré
+    memmove(board->lines + count, board->lines, (size_t)loaded * sizeof(TextLine));
+    int numLines = board->numLines;
+    board->baseIndex = firstPage * RECORDS_PER_PAGE;
+    board->numLines = board->baseIndex;
+    RecoveryStats stats = {0};
+    for (int p = firstPage; p < endPage; ++p) {
+        Uint8 *page = pages + (size_t)(p - firstPage) * PAGE_SIZE;
+        if (board->store.pageTasks[p] == 0) {
+            // Emplacements libres déjà comptés
+            TextLine *lines = &board->lines[loadedTasks(board)];
+            memset(lines, 0, RECORDS_PER_PAGE * sizeof(TextLine));
+            for (int r = 0; r < RECORDS_PER_PAGE; ++r) {
+                lines[r].isFree = true;
+                noteFreeSlot(board, board->numLines++);
+            }
+            continue;
+        }
+        bool pageValid = pageCrc(page) == board->store.pageCrcs[p];
+        int discarded = stats.recordsDiscarded;
+        int tasks = decodeDataPage(board, page, RECORDS_PER_PAGE, pageValid, &stats);
+        // Les emplacements libres attendus de la page étaient déjà comptés
+        board->numFree -= RECORDS_PER_PAGE - board->store.pageTasks[p];
+        if (!pageValid || stats.recordsDiscarded != discarded || tasks != board->store.pageTasks[p]) {
+            board->store.pageTasks[p] = (Uint8)tasks;
+            markPageDirty(&board->store, p);
+        }
+    }
+    SDL_free(pages);
+    board->numLines = numLines;
+    board->ordered = false;
+    for (int i = 0; i < count; ++i) {
+        if (!board->lines[i].isFree) {
+            indexTask(board->search, board->baseIndex + i, &board->lines[i]);
+        }
+    }
+
+    if (stats.recordsDiscarded > 0) {
+        printf("Task file %s was damaged: %d tasks discarded.\n", board->path, stats.recordsDiscarded);
+    }
+    return true;
+}
+
+// Fonction pour charger les données depuis l'ancien fichier texte ("colonne texte" par ligne),
+// en ignorant les lignes mal formées au lieu de s'arrêter à la première
+void loadTasksFromFile(Board *board, const char *path, RecoveryStats *stats) {
+    FILE *file = fopen(path, "r");
+    if (file != NULL) {
+        char buffer[MAX_TEXT_LENGTH + 16];
+        board->numLines = 0;
+        while (fgets(buffer, sizeof(buffer), file) != NULL) {
+            // Ligne trop longue : ignorer la fin
+            if (strchr(buffer, '\n') == NULL && !feof(file)) {
+                int c;
+                while ((c = fgetc(file)) != '\n' && c != EOF) {
+                }
+            }
+            if (!reserveTasks(board, board->numLines + 1)) {
+                break;
+            }
+            TextLine *line = &board->lines[board->numLines];
+            int fields = sscanf(buffer, "%d %255[^\n]", &line->column, line->text);
+            if (fields == 2) {
+                line->text[strcspn(line->text, "\r")] = '\0';
+                line->createdAt = (Uint32)time(NULL);
+                line->doneAt = 0;
+                ++board->numLines;
+            } else if (fields != EOF) {
+                stats->linesSkipped++;
+            }
+        }
+        fclose(file);
+        if (stats->linesSkipped > 0) {
+            printf("Skipped %d malformed lines in %s.\n", stats->linesSkipped, path);
+        }
+        if (!board->store.quiet) {
+            printf("Tasks loaded from file.\n");
+        }
+
+        // Le fichier paginé n'existe pas encore : tout sera écrit au prochain enregistrement
+        board->store.rewriteAll = true;
+    } else if (!board->store.quiet) {
+        printf("Error opening %s for reading.\n", path);
+    }
+}
+
+// Fonction pour vérifier un fichier de tâches et afficher le bilan de la récupération
+int runVerify(const char *path) {
+    Board board = {0};
+    RecoveryStats stats;
+    board.path = path;
+    Uint64 start = SDL_GetPerformanceCounter();
+    bool ok = loadTasksFromDb(&board, &stats, -1);
+    double ms = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+    bool damaged = board.store.rewriteAll;
+    freeBoard(&board);
+    if (!ok) {
+        printf("Error reading %s.\n", path);
+        return 1;
+    }
+    printf("%s: %d tasks verified in %.2f ms, %d salvaged, %d discarded, %d damaged pages%s%s\n",
+           path, stats.recordsLoaded, ms, stats.recordsSalvaged, stats.recordsDiscarded, stats.pagesDamaged,
+           stats.headerDamaged ? ", damaged header" : "", stats.truncated ? ", truncated" : "");
+    return damaged ? 2 : 0;
+}
+
+// Fonction pour comparer la place de deux tâches dans l'ordre d'affichage (qsort sur des
+// pointeurs de tâches) : clé d'ordre, puis identifiant, puis emplacement
+int compareTaskOrder(const void *a, const void *b) {
+    const TextLine *first = *(TextLine *const *)a;
+    const TextLine *second = *(TextLine *const *)b;
+    if (first->orderKey != second->orderKey) {
+        return first->orderKey < second->orderKey ? -1 : 1;
+    }
+    if (first->id != second->id) {
+        return first->id < second->id ? -1 : 1;
+    }
+    return (first > second) - (first < second);
+}
+
+// Fonction pour ranger les tâches en mémoire dans l'ordre d'affichage (sorted : une place
+// par emplacement en mémoire). Renvoie le nombre de tâches rangées.
+int sortTasksByOrder(Board *board, TextLine **sorted) {
+    int count = 0;
+    for (int i = 0; i < loadedTasks(board); ++i) {
+        if (!board->lines[i].isFree) {
+            sorted[count++] = &board->lines[i];
+        }
+    }
+    qsort(sorted, (size_t)count, sizeof(TextLine *), compareTaskOrder);
+    return count;
+}
+
+// Fonction pour placer les zones de texte dans leur colonne après le chargement, dans
+// l'ordre des clés (un emplacement repris peut se trouver avant des tâches plus anciennes)
+void layoutTasks(Board *board) {
+    Uint64 zone = beginTraceZone();
+    ArenaMark mark = arenaMark(&frameArena);
+    TextLine **sorted = arenaAlloc(&frameArena, ((size_t)loadedTasks(board) + 1) * sizeof(TextLine *));
+    int count = sorted != NULL ? sortTasksByOrder(board, sorted) : 0;
+    int rows[3] = {0, 0, 0};
+    for (int k = 0; k < count; ++k) {
+        TextLine *line = sorted[k];
+        if (line->column < 0 || line->column > 2) {
+            line->column = 0;
+        }
+        line->rect = (SDL_Rect){line->column * WIDTH / 3 + 10, 40 + rows[line->column]++ * (MIN_TEXTBOX_HEIGHT + 5), TEXTBOX_WIDTH, MIN_TEXTBOX_HEIGHT};
+        line->isEditing = false;
+        line->isDragging = false;
+        line->inputText[0] = '\0';
+    }
+    arenaRelease(&frameArena, mark);
+    endTraceZone(zone, "layout");
+}
+
+// Fonction pour savoir si une tâche de la colonne "Done" est à archiver
+bool isTaskArchivable(const TextLine *line, Uint32 cutoff) {
+    return line->doneAt != 0 && line->doneAt < cutoff && !line->isEditing && !line->isDragging;
+}
+
+// Fonction pour archiver les tâches terminées avant cutoff par pages entières, en partant
+// des plus anciennes : une page n'est vidée que si toutes ses tâches sont à archiver, et
+// l'archivage s'arrête à la première page qui en garde une. Les pages restées sur disque
+// sont lues sans être chargées, puis vidées. Renvoie le nombre de tâches archivées.
+int archiveDonePages(Board *done, Board *archive, Uint32 cutoff) {
+    SDL_RWops *rw = NULL;
+    int archived = 0;
+    bool more = true;
+    for (int p = 0; p < countPages(done->numLines) && more; ++p) {
+        int first = p * RECORDS_PER_PAGE;
+        int slots = pageRecordCount(done->numLines, p);
+        if (first >= done->baseIndex) {
+            for (int k = 0; k < slots && more; ++k) {
+                const TextLine *line = &done->lines[first + k - done->baseIndex];
+                more = line->isFree || isTaskArchivable(line, cutoff);
+            }
+            for (int k = 0; k < slots && more; ++k) {
+                if (!done->lines[first + k - done->baseIndex].isFree) {
+                    more = transferTask(done, first + k, archive, DONE_COLUMN);
+                    archived += more;
+                }
+            }
+            continue;
+        }
+        if (done->store.pageTasks[p] == 0) {
+            continue;
+        }
+        // Page restée sur disque : une page illisible est laissée telle quelle
+        Uint8 page[PAGE_SIZE];
+        TextLine lines[RECORDS_PER_PAGE];
+        Board pageBoard = {.lines = lines, .capacity = RECORDS_PER_PAGE, .appendOnly = true};
+        RecoveryStats stats = {0};
+        rw = rw != NULL ? rw : SDL_RWFromFile(done->path, "rb");
+        more = rw != NULL && SDL_RWseek(rw, dataPageOffset(p), RW_SEEK_SET) >= 0 && SDL_RWread(rw, page, PAGE_SIZE, 1) == 1 &&
+               pageCrc(page) == done->store.pageCrcs[p] &&
+               decodeDataPage(&pageBoard, page, slots, true, &stats) == done->store.pageTasks[p] &&
+               reserveTasks(archive, loadedTasks(archive) + done->store.pageTasks[p]);
+        for (int k = 0; k < slots && more; ++k) {
+            more = lines[k].isFree || isTaskArchivable(&lines[k], cutoff);
+        }
+        if (!more) {
+            break;
+        }
+        for (int k = 0; k < slots; ++k) {
+            if (!lines[k].isFree) {
+                appendTask(archive, &lines[k]);
+            }
+        }
+        archived += done->store.pageTasks[p];
+        done->numFree += done->store.pageTasks[p];
+        done->store.pageTasks[p] = 0;
+        markTaskDirty(&done->store, first);
+    }
+    if (rw != NULL) {
+        SDL_RWclose(rw);
+    }
+    return archived;
+}
+
+// Fonction pour ranger les tâches en mémoire d'un tableau partagé dans l'ordre de leurs
+// clés, que l'ordre des emplacements ne suit pas (tâches reçues avec leur clé). Le
+// classement est gardé jusqu'au prochain changement.
+bool orderBoardTasks(Board *board) {
+    if (board->ordered) {
+        return true;
+    }
+    if (loadedTasks(board) > board->orderCapacity) {
+        TextLine **order = SDL_realloc(board->order, (size_t)loadedTasks(board) * sizeof(TextLine *));
+        if (order == NULL) {
+            return false;
+        }
+        board->order = order;
+        board->orderCapacity = loadedTasks(board);
+    }
+    board->numOrdered = sortTasksByOrder(board, board->order);
+    board->ordered = true;
+    return true;
+}
+
+// Fonction pour charger les pages de la colonne "Done" nécessaires à l'affichage à partir
+// de scroll (les plus récentes en haut) et placer ses tâches. Rien n'est archivé ici : les
+// tâches anciennes le sont au chargement (voir loadDoneBoards).
+void scrollDoneColumn(Board *done, int *scroll) {
+    Uint64 zone = beginTraceZone();
+    int rowHeight = MIN_TEXTBOX_HEIGHT + 5;
+    int maxScroll = countTasks(done) * rowHeight - (HEIGHT - 80);
+    *scroll = *scroll > maxScroll ? maxScroll : *scroll;
+    *scroll = *scroll < 0 ? 0 : *scroll;
+
+    int neededRows = (*scroll + HEIGHT) / rowHeight + 1;
+    int loadedRows = 0;
+    for (int i = 0; i < loadedTasks(done); ++i) {
+        loadedRows += !done->lines[i].isFree;
+    }
+    while (done->baseIndex > 0 && loadedRows < neededRows) {
+        Uint64 loadZone = beginTraceZone();
+        bool loaded = loadEarlierPages(done, 1);
+        endTraceZone(loadZone, "load pages");
+        if (!loaded) {
+            break;
+        }
+        for (int i = 0; i < RECORDS_PER_PAGE; ++i) {
+            loadedRows += !done->lines[i].isFree;
+        }
+    }
+
+    // Placer les tâches affichées, la plus récemment terminée en haut : dans l'ordre des
+    // emplacements, sauf dans un tableau partagé où des tâches arrivent avec leur clé
+    bool shared = done->sync != NULL && orderBoardTasks(done);
+    int count = shared ? done->numOrdered : loadedTasks(done);
+    int row = 0;
+    for (int k = count - 1; k >= 0; --k) {
+        TextLine *line = shared ? done->order[k] : &done->lines[k];
+        if (!isTaskShown(done, (int)(line - done->lines))) {
+            continue;
+        }
+        if (!line->isDragging) {
+            line->rect = (SDL_Rect){DONE_COLUMN * WIDTH / 3 + 10, 40 + row * rowHeight - *scroll, TEXTBOX_WIDTH, MIN_TEXTBOX_HEIGHT};
+        }
+        row++;
+    }
+    endTraceZone(zone, "layout done column");
+}
+
+// Fonction pour ouvrir les tableaux "Done" et archive (seules les dernières pages sont
+// chargées), y déplacer les tâches terminées de l'ancien format et archiver les pages de
+// tâches terminées avant cutoff (0 : ne rien archiver)
+void loadDoneBoards(const BoardFiles *files, Board *board, Board *done, Board *archive, Uint32 cutoff) {
+    RecoveryStats stats;
+    done->path = files->done;
+    done->appendOnly = true;
+    if (!loadTasksFromDb(done, &stats, DONE_PAGES_AT_STARTUP)) {
+        done->store.rewriteAll = true;
+    }
+    archive->path = files->archive;
+    archive->appendOnly = true;
+    if (!loadTasksFromDb(archive, &stats, 1)) {
+        archive->store.rewriteAll = true;
+    }
+    // Tâches terminées de l'ancien format, déplacées dans leur ordre
+    ArenaMark mark = arenaMark(&frameArena);
+    TextLine **sorted = arenaAlloc(&frameArena, ((size_t)loadedTasks(board) + 1) * sizeof(TextLine *));
+    if (sorted != NULL) {
+        int count = sortTasksByOrder(board, sorted);
+        for (int k = 0; k < count; ++k) {
+            if (sorted[k]->column == DONE_COLUMN) {
+                transferTask(board, taskSlot(board, sorted[k]), done, DONE_COLUMN);
+            }
+        }
+    }
+    arenaRelease(&frameArena, mark);
+    if (cutoff > 0) {
+        archiveDonePages(done, archive, cutoff);
+    }
+}
+
+// Fonction pour archiver les tâches terminées depuis plus de days jours, par pages entières
+// comme au chargement (voir archiveDonePages). La colonne "Done" est ensuite compactée
+// (emplacements libres retirés) dans un fichier temporaire qui remplace l'ancien d'un
+// coup : une interruption laisse l'un ou l'autre, jamais un mélange.
+int runArchive(const BoardFiles *files, int days) {
+    Board board = {0};
+    Board done = {0};
+    Board archive = {0};
+    RecoveryStats stats;
+    board.path = files->tasks;
+    if (!loadTasksFromDb(&board, &stats, -1)) {
+        board.store.rewriteAll = true;
+    }
+    loadDoneBoards(files, &board, &done, &archive, 0);
+
+    // Charger toute la colonne "Done" pour la parcourir en entier
+    bool ok = loadEarlierPages(&done, done.baseIndex / RECORDS_PER_PAGE) && done.baseIndex == 0;
+    Uint32 cutoff = (Uint32)time(NULL) - (Uint32)days * 86400;
+    int archived = ok ? archiveDonePages(&done, &archive, cutoff) : 0;
+    // L'archive est enregistrée avant que les tâches quittent la colonne "Done"
+    ok = ok && saveDirtyPages(&archive) && saveDirtyPages(&board);
+
+    char temporary[FILENAME_MAX];
+    SDL_snprintf(temporary, sizeof(temporary), "%s.tmp", files->done);
+    Board compacted = {0};
+    compacted.path = temporary;
+    compacted.appendOnly = true;
+    compacted.store.quiet = true;
+    ok = ok && reserveTasks(&compacted, countTasks(&done));
+    for (int i = 0; ok && i < done.numLines; ++i) {
+        if (!done.lines[i].isFree) {
+            compacted.lines[compacted.numLines++] = done.lines[i];
+        }
+    }
+    compacted.store.rewriteAll = true;
+    ok = ok && saveDirtyPages(&compacted) && rename(temporary, files->done) == 0;
+    if (!ok) {
+        remove(temporary);
+    }
+    printf("%d tasks archived to %s, %d tasks left in Done.\n", archived, files->archive, compacted.numLines);
+    freeBoard(&board);
+    freeBoard(&done);
+    freeBoard(&archive);
+    freeBoard(&compacted);
+    return ok ? 0 : 1;
+}
+
+// Fonction pour lire le journal de la chronologie et relever ses entrées. Le journal est
+// tronqué à la première entrée incomplète ou dont le CRC est faux (écriture interrompue).
+// Sans journal, il n'y a aucune entrée ; renvoie false si le fichier n'est pas un journal.
+bool readTimelineLog(const char *path, Uint8 **log, size_t *size, TimelineEntry **entries, int *numEntries) {
+    *log = NULL;
+    *size = 0;
+    *entries = NULL;
+    *numEntries = 0;
+    SDL_RWops *rw = SDL_RWFromFile(path, "rb");
+    if (rw == NULL) {
+        return true;
+    }
+    Sint64 fileSize = SDL_RWsize(rw);
+    Uint8 *data = fileSize >= 8 ? SDL_malloc((size_t)fileSize) : NULL;
+    if (data == NULL || SDL_RWread(rw, data, (size_t)fileSize, 1) != 1 || readLE32(data) != TIMELINE_MAGIC ||
+        readLE32(data + 4) != TIMELINE_VERSION) {
+        printf("Invalid timeline file %s.\n", path);
+        SDL_free(data);
+        SDL_RWclose(rw);
+        return false;
+    }
+    SDL_RWclose(rw);
+
+    TimelineEntry *list = NULL;
+    int count = 0;
+    int capacity = 0;
+    int keyframes[2] = {-1, -1};
+    int latest[2] = {-1, -1};
+    Uint32 lastTime = 0;
+    size_t offset = 8;
+    while (offset + TIMELINE_HEADER_SIZE + 4 <= (size_t)fileSize) {
+        const Uint8 *entry = data + offset;
+        int kind = (int)(readLE32(entry) & 0xFF);
+        int slot = (int)(readLE32(entry) >> 8);
+        size_t numPages = readLE32(entry + 12);
+        size_t entrySize = TIMELINE_HEADER_SIZE + numPages * (kind == TIMELINE_KEYFRAME ? 8 : 12) + 4;
+        if ((kind != TIMELINE_DELTA && kind != TIMELINE_KEYFRAME) || slot > 1 || numPages > (size_t)fileSize ||
+            entrySize > (size_t)fileSize - offset || readLE32(entry + entrySize - 4) != crc32(entry, entrySize - 4)) {
+            break;
+        }
+        if (count == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 256;
+            TimelineEntry *newList = SDL_realloc(list, (size_t)capacity * sizeof(TimelineEntry));
+            if (newList == NULL) {
+                printf("Error allocating memory for the timeline.\n");
+                break;
+            }
+            list = newList;
+        }
+        TimelineEntry *e = &list[count];
+        e->offset = offset;
+        e->time = readLE32(entry + 4) > lastTime ? readLE32(entry + 4) : lastTime;
+        e->slot = (Uint8)slot;
+        e->kind = (Uint8)kind;
+        if (kind == TIMELINE_KEYFRAME) {
+            keyframes[slot] = count;
+        }
+        // Sans image clé (journal abîmé), les entrées sont rejouées depuis le début
+        e->keyframe = keyframes[slot] >= 0 ? keyframes[slot] : 0;
+        latest[slot] = count;
+        e->latest[0] = latest[0];
+        e->latest[1] = latest[1];
+        lastTime = e->time;
+        count++;
+        offset += entrySize;
+    }
+
+    // Retirer la fin illisible pour que les prochaines entrées la suivent directement
+    if (offset < (size_t)fileSize) {
+        printf("Timeline file %s was damaged: %d versions kept.\n", path, count);
+        rw = SDL_RWFromFile(path, "wb");
+        if (rw == NULL || SDL_RWwrite(rw, data, offset, 1) != 1) {
+            printf("Error writing %s.\n", path);
+        }
+        if (rw != NULL) {
+            SDL_RWclose(rw);
+        }
+    }
+    *log = data;
+    *size = offset;
+    *entries = list;
+    *numEntries = count;
+    return true;
+}
+
+// Fonction pour reconstruire la liste des pages d'un tableau à l'entrée target du journal
+// en rejouant, depuis la dernière image clé, les entrées du même tableau. Renvoie le
+// nombre de tâches de cette version (0 si target vaut -1), -1 en cas d'erreur.
+int replayTimeline(const Uint8 *log, const TimelineEntry *entries, int target, TimelinePage **pages, int *capacity) {
+    if (target < 0) {
+        return 0;
+    }
+    int slot = entries[target].slot;
+    int numLines = 0;
+    for (int i = entries[target].keyframe; i <= target; ++i) {
+        if (entries[i].slot != slot) {
+            continue;
+        }
+        const Uint8 *entry = log + entries[i].offset;
+        const Uint8 *payload = entry + TIMELINE_HEADER_SIZE;
+        int newLines = (int)readLE32(entry + 8);
+        int count = (int)readLE32(entry + 12);
+        newLines = newLines < 0 ? 0 : newLines;
+        int numPages = countPages(newLines);
+        if (!reserveTimelinePages(pages, capacity, numPages)) {
+            return -1;
+        }
+        if (entries[i].kind == TIMELINE_KEYFRAME) {
+            numLines = 0;
+        }
+        for (int p = countPages(numLines); p < numPages; ++p) {
+            (*pages)[p] = (TimelinePage){TIMELINE_NO_PAGE, 0};
+        }
+        numLines = newLines;
+        if (entries[i].kind == TIMELINE_KEYFRAME) {
+            for (int p = 0; p < count && p < numPages; ++p) {
+                (*pages)[p] = (TimelinePage){readLE32(payload + p * 8), readLE32(payload + p * 8 + 4)};
+            }
+        } else {
+            for (int c = 0; c < count; ++c) {
+                Uint32 p = readLE32(payload + c * 12);
+                if (p < (Uint32)numPages) {
+                    (*pages)[p] = (TimelinePage){readLE32(payload + c * 12 + 4), readLE32(payload + c * 12 + 8)};
+                }
+            }
+        }
+    }
+    return numLines;
+}
+
+// Fonction pour reprendre la chronologie d'un tableau qui vient d'être chargé : sa dernière
+// version est reconstruite, puis les pages du fichier qui en diffèrent (tableau modifié
+// sans la chronologie, par un import ou l'archivage) y sont recopiées
+void attachTimeline(TimelineWriter *writer, Board *board, const Uint8 *log, const TimelineEntry *entries, int numEntries, int slot) {
+    writer->slot = slot;
+    board->timeline = writer;
+    int last = numEntries > 0 ? entries[numEntries - 1].latest[slot] : -1;
+    writer->started = last >= 0;
+    if (last >= 0) {
+        writer->numLines = replayTimeline(log, entries, last, &writer->pages, &writer->capacity);
+        if (writer->numLines < 0) {
+            writer->numLines = 0;
+            writer->failed = true;
+            return;
+        }
+        for (int i = entries[last].keyframe + 1; i <= last; ++i) {
+            if (entries[i].slot == slot && entries[i].kind == TIMELINE_DELTA) {
+                writer->deltas++;
+                writer->deltaBytes += TIMELINE_HEADER_SIZE + (size_t)readLE32(log + entries[i].offset + 12) * 12 + 4;
+            }
+        }
+    }
+
+    // Un fichier à réécrire entièrement sera recopié au prochain enregistrement
+    const PageStore *store = &board->store;
+    if (store->rewriteAll) {
+        return;
+    }
+    int numPages = countPages(store->savedNumLines);
+    SDL_RWops *rw = numPages > 0 ? SDL_RWFromFile(board->path, "rb") : NULL;
+    beginTimelineDelta(writer);
+    for (int p = 0; p < numPages && rw != NULL; ++p) {
+        if (p < countPages(writer->numLines) && store->pageCrcs[p] != 0 && writer->pages[p].crc == store->pageCrcs[p] &&
+            writer->pages[p].copy != TIMELINE_NO_PAGE) {
+            continue;
+        }
+        Uint8 page[PAGE_SIZE];
+        if (SDL_RWseek(rw, dataPageOffset(p), RW_SEEK_SET) < 0 || SDL_RWread(rw, page, PAGE_SIZE, 1) != 1) {
+            memset(page, 0, PAGE_SIZE);
+        }
+        recordTimelinePage(writer, p, page, pageCrc(page));
+    }
+    int copied = writer->numChanged / 3;
+    endTimelineDelta(writer, store->savedNumLines, rw != NULL || numPages == 0);
+    if (rw != NULL) {
+        SDL_RWclose(rw);
+    }
+    if (copied > 0) {
+        printf("%d pages of %s added to the timeline.\n", copied, board->path);
+    }
+}
+
+// Fonction pour reprendre la chronologie des tâches actives et de la colonne "Done" d'un
+// tableau ouvert (rien n'est enregistré si le journal n'est pas lisible)
+void openTimeline(OpenBoard *open) {
+    Uint8 *log;
+    size_t size;
+    TimelineEntry *entries;
+    int numEntries;
+    if (!readTimelineLog(open->files.timelineLog, &log, &size, &entries, &numEntries)) {
+        return;
+    }
+    Board *boards[2] = {&open->tasks, &open->done};
+    for (int b = 0; b < 2; ++b) {
+        open->timeline[b].logPath = open->files.timelineLog;
+        open->timeline[b].pagesPath = open->files.timelinePages;
+        attachTimeline(&open->timeline[b], boards[b], log, entries, numEntries, b);
+    }
+    SDL_free(log);
+    SDL_free(entries);
+}
+
+// Fonction pour fermer la vue de la chronologie
+void closeTimelineView(TimelineView *view) {
+    SDL_free(view->log);
+    SDL_free(view->entries);
+    for (int b = 0; b < 2; ++b) {
+        freeBoard(&view->boards[b]);
+        SDL_free(view->pages[b]);
+        SDL_free(view->shown[b]);
+    }
+    memset(view, 0, sizeof(*view));
+}
+
+// Fonction pour trouver la dernière entrée de la chronologie datée au plus de time
+// (la première si elles sont toutes plus récentes)
+int findTimelineEntry(const TimelineView *view, Uint32 time) {
+    int low = 0;
+    int high = view->numEntries;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (view->entries[middle].time <= time) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low > 0 ? low - 1 : 0;
+}
+
+// Fonction pour afficher la version des tableaux à l'entrée position de la chronologie :
+// les listes de pages sont reconstruites, puis seules les pages qui diffèrent de la
+// version affichée sont relues et décodées
+void seekTimeline(TimelineView *view, int position) {
+    position = position < 0 ? 0 : (position >= view->numEntries ? view->numEntries - 1 : position);
+    view->position = position;
+    SDL_RWops *rw = SDL_RWFromFile(view->pagesPath, "rb");
+    for (int b = 0; b < 2; ++b) {
+        Board *board = &view->boards[b];
+        int numLines = replayTimeline(view->log, view->entries, view->entries[position].latest[b], &view->pages[b], &view->capacity[b]);
+        int numPages = countPages(numLines);
+        // Pour la colonne "Done", seules les dernières pages sont affichées
+        int first = b == 1 && numPages > TIMELINE_DONE_PAGES ? numPages - TIMELINE_DONE_PAGES : 0;
+        if (numLines < 0 || !reserveTasks(board, (numPages - first) * RECORDS_PER_PAGE) ||
+            !reserveTimelinePages(&view->shown[b], &view->shownCapacity[b], numPages)) {
+            numLines = numPages = first = 0;
+        }
+        if (first * RECORDS_PER_PAGE != board->baseIndex) {
+            for (int p = 0; p < view->shownCapacity[b]; ++p) {
+                view->shown[b][p].copy = TIMELINE_NO_PAGE;
+            }
+        }
+        board->baseIndex = first * RECORDS_PER_PAGE;
+        RecoveryStats stats = {0};
+        for (int p = first; p < numPages; ++p) {
+            Uint32 copy = view->pages[b][p].copy;
+            if (copy == view->shown[b][p].copy && copy != TIMELINE_NO_PAGE) {
+                continue;
+            }
+            Uint8 packed[PAGE_SIZE];
+            Uint8 page[PAGE_SIZE];
+            size_t available = 0;
+            if (copy != TIMELINE_NO_PAGE && rw != NULL && SDL_RWseek(rw, (Sint64)copy * TIMELINE_COPY_ALIGN, RW_SEEK_SET) >= 0) {
+                available = SDL_RWread(rw, packed, 1, PAGE_SIZE);
+            }
+            unpackTimelinePage(packed, (int)available, page);
+            board->numLines = p * RECORDS_PER_PAGE;
+            decodeDataPage(board, page, pageRecordCount(numLines, p), false, &stats);
+            view->shown[b][p].copy = copy;
+        }
+        board->numLines = numLines;
+        // Les pages non affichées ne comptent pas : seules les tâches en mémoire sont défilées
+        board->numFree = board->baseIndex;
+        for (int i = 0; i < loadedTasks(board); ++i) {
+            board->numFree += board->lines[i].isFree;
+        }
+    }
+    if (rw != NULL) {
+        SDL_RWclose(rw);
+    }
+    layoutTasks(&view->boards[0]);
+    view->doneScroll = 0;
+    scrollDoneColumn(&view->boards[1], &view->doneScroll);
+}
+
+// Fonction pour ouvrir la vue de la chronologie d'un tableau, à sa dernière version
+bool openTimelineView(TimelineView *view, const BoardFiles *files) {
+    memset(view, 0, sizeof(*view));
+    if (!readTimelineLog(files->timelineLog, &view->log, &view->logSize, &view->entries, &view->numEntries)) {
+        return false;
+    }
+    if (view->numEntries == 0) {
+        printf("No timeline recorded for board %s.\n", files->name);
+        closeTimelineView(view);
+        return false;
+    }
+    SDL_strlcpy(view->pagesPath, files->timelinePages, sizeof(view->pagesPath));
+    // Vue en lecture seule : aucun emplacement libre n'est repris
+    view->boards[0].appendOnly = true;
+    view->boards[1].appendOnly = true;
+    view->open = true;
+    seekTimeline(view, view->numEntries - 1);
+    return true;
+}
+
+// Fonction pour parcourir la chronologie affichée : flèches et molette pour la version
+// précédente ou suivante, Page précédente / suivante pour un jour plus tôt ou plus tard,
+// Début et Fin pour la première et la dernière. Renvoie false pour quitter la vue.
+bool handleTimelineEvent(TimelineView *view, const SDL_Event *event) {
+    int position = view->position;
+    Uint32 time = view->entries[position].time;
+    if (event->type == SDL_MOUSEWHEEL) {
+        position -= event->wheel.y;
+    } else if (event->type == SDL_KEYDOWN) {
+        SDL_Keycode key = event->key.keysym.sym;
+        if (key == SDLK_ESCAPE || ((event->key.keysym.mod & KMOD_CTRL) && key == SDLK_h)) {
+            return false;
+        } else if (key == SDLK_LEFT || key == SDLK_UP) {
+            position--;
+        } else if (key == SDLK_RIGHT || key == SDLK_DOWN) {
+            position++;
+        } else if (key == SDLK_PAGEUP) {
+            position = findTimelineEntry(view, time > 86400 ? time - 86400 : 0);
+        } else if (key == SDLK_PAGEDOWN) {
+            position = findTimelineEntry(view, time + 86400);
+            position = position > view->position ? position : view->position + 1;
+        } else if (key == SDLK_HOME) {
+            position = 0;
+        } else if (key == SDLK_END) {
+            position = view->numEntries - 1;
+        }
+    }
+    position = position < 0 ? 0 : (position >= view->numEntries ? view->numEntries - 1 : position);
+    if (position != view->position) {
+        seekTimeline(view, position);
+    }
+    return true;
+}
+
+// Fonction pour lire les lignes complètes de tasks.txt à partir de start et les ajouter
+// à la liste des lignes connues. Une dernière ligne sans retour à la ligne (script en
+// train d'écrire) sera lue au prochain passage.
+bool readInboxLines(InboxWatcher *watcher, FILE *file, long start) {
+    if (fseek(file, start, SEEK_SET) != 0) {
+        return false;
+    }
+    char buffer[MAX_TEXT_LENGTH + 16];
+    char text[MAX_TEXT_LENGTH];
+    long offset = start;
+    while (fgets(buffer, sizeof(buffer), file) != NULL) {
+        if (strchr(buffer, '\n') == NULL) {
+            if (feof(file)) {
+                break;
+            }
+            // Ligne trop longue : ignorer la fin
+            int c;
+            while ((c = fgetc(file)) != '\n' && c != EOF) {
+            }
+            if (c == EOF) {
+                break;
+            }
+        }
+        if (watcher->numLines == watcher->capacity) {
+            int newCapacity = watcher->capacity > 0 ? watcher->capacity * 2 : 64;
+            InboxLine *lines = SDL_realloc(watcher->lines, (size_t)newCapacity * sizeof(InboxLine));
+            if (lines == NULL) {
+                printf("Error allocating memory for %d lines of %s.\n", newCapacity, watcher->path);
+                return false;
+            }
+            watcher->lines = lines;
+            watcher->capacity = newCapacity;
+        }
+        InboxLine *line = &watcher->lines[watcher->numLines++];
+        line->offset = offset;
+        line->column = -1;
+        line->hash = 0;
+        if (sscanf(buffer, "%d %255[^\n]", &line->column, text) == 2) {
+            text[strcspn(text, "\r")] = '\0';
+            line->hash = crc32(text, strlen(text));
+        } else {
+            line->column = -1;
+        }
+        offset = ftell(file);
+    }
+
+    // Garder la fin de la partie lue pour reconnaître un simple ajout la prochaine fois
+    watcher->seenSize = offset;
+    watcher->tailLength = offset < INBOX_TAIL_SIZE ? (int)offset : INBOX_TAIL_SIZE;
+    if (fseek(file, offset - watcher->tailLength, SEEK_SET) != 0 ||
+        fread(watcher->tail, 1, (size_t)watcher->tailLength, file) != (size_t)watcher->tailLength) {
+        watcher->tailLength = 0;
+    }
+    return true;
+}
+
+// Fonction pour commencer à surveiller la boîte de réception d'un tableau : son contenu
+// actuel est considéré comme déjà lu
+void startInboxWatcher(InboxWatcher *watcher, const char *path) {
+    memset(watcher, 0, sizeof(*watcher));
+    watcher->path = path;
+    watcher->inotifyFd = -1;
+    FILE *file = fopen(path, "rb");
+    if (file != NULL) {
+        readInboxLines(watcher, file, 0);
+        fclose(file);
+    }
+    struct stat info;
+    if (stat(path, &info) == 0) {
+        watcher->seenMtime = info.st_mtime;
+    }
+#ifdef __linux__
+    // Surveiller le dossier plutôt que le fichier, qui peut être remplacé par un renommage
+    watcher->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watcher->inotifyFd >= 0 && inotify_add_watch(watcher->inotifyFd, ".", IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO) < 0) {
+        close(watcher->inotifyFd);
+        watcher->inotifyFd = -1;
+    }
+#endif
+}
+
+// Fonction pour arrêter la surveillance de tasks.txt
+void stopInboxWatcher(InboxWatcher *watcher) {
+#ifdef __linux__
+    if (watcher->inotifyFd >= 0) {
+        close(watcher->inotifyFd);
+    }
+#endif
+    SDL_free(watcher->lines);
+    memset(watcher, 0, sizeof(*watcher));
+}
+
+// Fonction pour savoir si tasks.txt a pu être modifié depuis le dernier appel
+// (événements inotify sous Linux, date et taille interrogées périodiquement ailleurs)
+bool checkInbox(InboxWatcher *watcher) {
+    bool changed = false;
+#ifdef __linux__
+    if (watcher->inotifyFd >= 0) {
+        char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+        ssize_t length;
+        while ((length = read(watcher->inotifyFd, events, sizeof(events))) > 0) {
+            for (char *p = events; p < events + length; p += sizeof(struct inotify_event) + ((struct inotify_event *)p)->len) {
+                const struct inotify_event *event = (const struct inotify_event *)p;
+                if (event->len > 0 && strcmp(event->name, watcher->path) == 0) {
+                    changed = true;
+                }
+            }
+        }
+        return changed;
+    }
+#endif
+    if (SDL_GetTicks() - watcher->lastPoll < INBOX_POLL_MS) {
+        return false;
+    }
+    watcher->lastPoll = SDL_GetTicks();
+    struct stat info;
+    if (stat(watcher->path, &info) == 0 && (info.st_mtime != watcher->seenMtime || (long)info.st_size != watcher->seenSize)) {
+        watcher->seenMtime = info.st_mtime;
+        changed = true;
+    }
+    return changed;
+}
+
+// Fonction pour comparer deux lignes de tasks.txt (tri par texte puis par colonne)
+int compareInboxLines(const void *a, const void *b) {
+    const InboxLine *x = a;
+    const InboxLine *y = b;
+    if (x->hash != y->hash) {
+        return x->hash < y->hash ? -1 : 1;
+    }
+    return (x->column > y->column) - (x->column < y->column);
+}
+
+// Fonction pour retrouver la tâche qui correspond à une ligne de tasks.txt
+TextLine *findInboxTask(Board **boards, int numBoards, const InboxLine *inboxLine, int *boardIndex, int *index) {
+    for (int b = 0; b < numBoards; ++b) {
+        for (int i = loadedTasks(boards[b]) - 1; i >= 0; --i) {
+            TextLine *line = &boards[b]->lines[i];
+            if (line->column == inboxLine->column && crc32(line->text, strlen(line->text)) == inboxLine->hash) {
+                *boardIndex = b;
+                *index = boards[b]->baseIndex + i;
+                return line;
+            }
+        }
+    }
+    return NULL;
+}
+
+// Fonction pour placer une tâche (venue de tasks.txt ou déplacée par la palette) sous la
+// dernière tâche de sa colonne, sans déplacer les autres (bottoms contient le bas de chaque colonne, -1 s'il n'est pas encore calculé)
+void placeAtColumnBottom(Board *board, TextLine *line, int bottoms[3]) {
+    if (bottoms[0] < 0) {
+        bottoms[0] = bottoms[1] = bottoms[2] = 40;
+        for (int i = 0; i < loadedTasks(board); ++i) {
+            const TextLine *other = &board->lines[i];
+            if (other != line && !other->isDragging && isTaskShown(board, i) && other->rect.y + other->rect.h + 5 > bottoms[other->column]) {
+                bottoms[other->column] = other->rect.y + other->rect.h + 5;
+            }
+        }
+    }
+    line->rect = (SDL_Rect){line->column * WIDTH / 3 + 10, bottoms[line->column], TEXTBOX_WIDTH, MIN_TEXTBOX_HEIGHT};
+    bottoms[line->column] += MIN_TEXTBOX_HEIGHT + 5;
+}
+
+// Fonction pour ajouter la tâche d'une nouvelle ligne de tasks.txt
+bool addInboxTask(FILE *file, const InboxLine *inboxLine, Board *board, Board *done, int bottoms[3]) {
+    char buffer[MAX_TEXT_LENGTH + 16];
+    TextLine task = {0};
+    if (inboxLine->column < 0 || fseek(file, inboxLine->offset, SEEK_SET) != 0 || fgets(buffer, sizeof(buffer), file) == NULL ||
+        sscanf(buffer, "%d %255[^\n]", &task.column, task.text) != 2) {
+        return false;
+    }
+    task.text[strcspn(task.text, "\r")] = '\0';
+    task.column = task.column < 0 || task.column > 2 ? 0 : task.column;
+    task.createdAt = (Uint32)time(NULL);
+    if (task.column == DONE_COLUMN) {
+        // Placée avec le reste de la colonne "Done" par scrollDoneColumn
+        task.doneAt = task.createdAt;
+        return appendTask(done, &task) != NULL;
+    }
+    TextLine *line = appendTask(board, &task);
+    if (line == NULL) {
+        return false;
+    }
+    placeAtColumnBottom(board, line, bottoms);
+    return true;
+}
+
+// Fonction pour déplacer ou supprimer la tâche d'une ligne de tasks.txt modifiée ou retirée
+// (column vaut -1 pour une suppression)
+bool updateInboxTask(const InboxLine *inboxLine, int column, Board *board, Board *done, int bottoms[3]) {
+    Board *boards[2] = {board, done};
+    int b, index;
+    TextLine *line = findInboxTask(boards, 2, inboxLine, &b, &index);
+    if (line == NULL) {
+        // Tâche déjà modifiée dans l'application, ou restée sur disque dans la colonne "Done"
+        return false;
+    }
+    if (column < 0) {
+        deleteTask(boards[b], index);
+    } else if (boards[b] == board && column == DONE_COLUMN) {
+        transferTask(board, index, done, column);
+    } else if (boards[b] == done && column != DONE_COLUMN) {
+        if (transferTask(done, index, board, column)) {
+            placeAtColumnBottom(board, &board->lines[loadedTasks(board) - 1], bottoms);
+        }
+    } else {
+        setTaskColumn(boards[b], index, column);
+        placeAtColumnBottom(board, line, bottoms);
+    }
+    return true;
+}
+
+// Fonction pour appliquer les modifications de tasks.txt faites par d'autres programmes.
+// Si le fichier a seulement grandi, seule la fin est lue ; sinon son contenu est comparé
+// aux lignes déjà connues et seules les tâches concernées sont ajoutées, déplacées ou
+// supprimées. Renvoie le nombre de tâches modifiées.
+int syncInbox(InboxWatcher *watcher, Board *board, Board *done) {
+    FILE *file = fopen(watcher->path, "rb");
+    if (file == NULL) {
+        // Fichier supprimé ou en cours de remplacement : tout ce qui réapparaîtra sera nouveau
+        watcher->numLines = 0;
+        watcher->seenSize = 0;
+        watcher->tailLength = 0;
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+
+    // Ajout en fin de fichier : la fin de la partie déjà lue n'a pas changé
+    bool appended = false;
+    if (size >= watcher->seenSize) {
+        char tail[INBOX_TAIL_SIZE];
+        appended = fseek(file, watcher->seenSize - watcher->tailLength, SEEK_SET) == 0 &&
+                   fread(tail, 1, (size_t)watcher->tailLength, file) == (size_t)watcher->tailLength &&
+                   memcmp(tail, watcher->tail, (size_t)watcher->tailLength) == 0;
+    }
+
+    int oldCount = watcher->numLines;
+    int changes = 0;
+    int bottoms[3] = {-1, -1, -1};
+    if (appended) {
+        readInboxLines(watcher, file, watcher->seenSize);
+        for (int i = oldCount; i < watcher->numLines; ++i) {
+            changes += addInboxTask(file, &watcher->lines[i], board, done, bottoms);
+        }
+        fclose(file);
+        return changes;
+    }
+
+    // Relire tout le fichier après les lignes connues, puis ignorer le début et la fin communs
+    if (!readInboxLines(watcher, file, 0)) {
+        watcher->numLines = oldCount;
+        fclose(file);
+        return 0;
+    }
+    InboxLine *oldLines = watcher->lines;
+    InboxLine *newLines = watcher->lines + oldCount;
+    int newCount = watcher->numLines - oldCount;
+    int prefix = 0;
+    while (prefix < oldCount && prefix < newCount && compareInboxLines(&oldLines[prefix], &newLines[prefix]) == 0) {
+        prefix++;
+    }
+    int suffix = 0;
+    while (suffix < oldCount - prefix && suffix < newCount - prefix &&
+           compareInboxLines(&oldLines[oldCount - 1 - suffix], &newLines[newCount - 1 - suffix]) == 0) {
+        suffix++;
+    }
+
+    // Comparer les parties restantes triées : lignes retirées d'un côté, ajoutées de l'autre
+    int removedCount = oldCount - prefix - suffix;
+    int addedCount = newCount - prefix - suffix;
+    ArenaMark mark = arenaMark(&frameArena);
+    InboxLine *removed = arenaAlloc(&frameArena, (size_t)(removedCount + addedCount + 1) * sizeof(InboxLine));
+    if (removed == NULL) {
+        watcher->numLines = oldCount;
+        fclose(file);
+        return 0;
+    }
+    InboxLine *added = removed + removedCount;
+    memcpy(removed, oldLines + prefix, (size_t)removedCount * sizeof(InboxLine));
+    memcpy(added, newLines + prefix, (size_t)addedCount * sizeof(InboxLine));
+    SDL_qsort(removed, (size_t)removedCount, sizeof(InboxLine), compareInboxLines);
+    SDL_qsort(added, (size_t)addedCount, sizeof(InboxLine), compareInboxLines);
+    int r = 0, a = 0, numRemoved = 0, numAdded = 0;
+    while (r < removedCount || a < addedCount) {
+        int order = r == removedCount ? 1 : (a == addedCount ? -1 : compareInboxLines(&removed[r], &added[a]));
+        if (order < 0) {
+            removed[numRemoved++] = removed[r++];
+        } else if (order > 0) {
+            added[numAdded++] = added[a++];
+        } else {
+            r++;
+            a++;
+        }
+    }
+
+    // Même texte dans une autre colonne : déplacer la tâche plutôt que la recréer
+    r = 0;
+    a = 0;
+    while (r < numRemoved && a < numAdded) {
+        if (removed[r].hash < added[a].hash) {
+            r++;
+        } else if (removed[r].hash > added[a].hash) {
+            a++;
+        } else {
+            if (added[a].column >= 0 && removed[r].column >= 0) {
+                changes += updateInboxTask(&removed[r], added[a].column, board, done, bottoms);
+            }
+            removed[r++].column = -1;
+            added[a++].column = -1;
+        }
+    }
+    for (r = 0; r < numRemoved; ++r) {
+        if (removed[r].column >= 0) {
+            changes += updateInboxTask(&removed[r], -1, board, done, bottoms);
+        }
+    }
+    for (a = 0; a < numAdded; ++a) {
+        changes += addInboxTask(file, &added[a], board, done, bottoms);
+    }
+    arenaRelease(&frameArena, mark);
+    fclose(file);
+
+    // Les lignes lues deviennent les lignes connues
+    memmove(watcher->lines, newLines, (size_t)newCount * sizeof(InboxLine));
+    watcher->numLines = newCount;
+    return changes;
+}
+
+// Fonction pour libérer les pages en mémoire déjà enregistrées d'un tableau,
+// sauf la dernière page incomplète qui reste nécessaire aux ajouts
+void evictSavedPages(Board *board) {
+    int keepFrom = board->numLines / RECORDS_PER_PAGE * RECORDS_PER_PAGE;
+    if (keepFrom <= board->baseIndex) {
+        return;
+    }
+    memmove(board->lines, board->lines + (keepFrom - board->baseIndex), (size_t)(board->numLines - keepFrom) * sizeof(TextLine));
+    board->baseIndex = keepFrom;
+    board->ordered = false;
+}
+
+// Fonction pour parcourir toutes les tâches d'un fichier paginé page par page,
+// sans jamais garder plus d'une page en mémoire
+bool forEachStoredTask(const char *path, bool (*callback)(const TextLine *task, void *userdata), void *userdata) {
+    Board board = {0};
+    RecoveryStats stats;
+    board.path = path;
+    if (!loadTasksFromDb(&board, &stats, 0)) {
+        return false;
+    }
+    SDL_RWops *rw = SDL_RWFromFile(path, "rb");
+    bool ok = rw != NULL;
+
+    // Pages restées sur disque, décodées une à une dans un petit tableau temporaire
+    TextLine lines[RECORDS_PER_PAGE];
+    Board pageBoard = {0};
+    pageBoard.lines = lines;
+    pageBoard.capacity = RECORDS_PER_PAGE;
+    pageBoard.appendOnly = true;
+    for (int p = 0; ok && p * RECORDS_PER_PAGE < board.baseIndex; ++p) {
+        Uint8 page[PAGE_SIZE];
+        if (SDL_RWseek(rw, dataPageOffset(p), RW_SEEK_SET) < 0 || SDL_RWread(rw, page, PAGE_SIZE, 1) != 1) {
+            ok = false;
+            break;
+        }
+        pageBoard.numLines = 0;
+        decodeDataPage(&pageBoard, page, RECORDS_PER_PAGE, pageCrc(page) == board.store.pageCrcs[p], &stats);
+        for (int i = 0; ok && i < pageBoard.numLines; ++i) {
+            ok = lines[i].isFree || callback(&lines[i], userdata);
+        }
+    }
+    // Dernières pages, déjà chargées
+    for (int i = 0; ok && i < loadedTasks(&board); ++i) {
+        ok = board.lines[i].isFree || callback(&board.lines[i], userdata);
+    }
+    if (rw != NULL) {
+        SDL_RWclose(rw);
+    }
+    freeBoard(&board);
+    return ok;
+}
+
+// Structure pour l'export CSV ou JSON
+typedef struct {
+    FILE *file;
+    bool json;
+    int count;
+} ExportWriter;
+
+// Fonction pour écrire une tâche dans le fichier d'export
+bool writeExportTask(const TextLine *task, void *userdata) {
+    ExportWriter *writer = userdata;
+    FILE *file = writer->file;
+    const char *text = task->text;
+    if (writer->json) {
+        fprintf(file, "%s\n  {\"column\": %d, \"createdAt\": %u, \"doneAt\": %u, \"text\": \"",
+                writer->count > 0 ? "," : "", task->column, (unsigned)task->createdAt, (unsigned)task->doneAt);
+        for (const char *p = text; *p != '\0'; ++p) {
+            unsigned char c = (unsigned char)*p;
+            if (c == '"' || c == '\\') {
+                fputc('\\', file);
+                fputc(c, file);
+            } else if (c == '\n') {
+                fputs("\\n", file);
+            } else if (c == '\r') {
+                fputs("\\r", file);
+            } else if (c == '\t') {
+                fputs("\\t", file);
+            } else if (c < 0x20) {
+                fprintf(file, "\\u%04x", c);
+            } else {
+                fputc(c, file);
+            }
+        }
+        fputs("\"}", file);
+    } else {
+        // Le texte est entre guillemets si besoin, les guillemets internes sont doublés
+        fprintf(file, "%d,", task->column);
+        if (strpbrk(text, ",\"\r\n") != NULL) {
+            fputc('"', file);
+            for (const char *p = text; *p != '\0'; ++p) {
+                if (*p == '"') {
+                    fputc('"', file);
+                }
+                fputc(*p, file);
+            }
+            fputc('"', file);
+        } else {
+            fputs(text, file);
+        }
+        fprintf(file, ",%u,%u\n", (unsigned)task->createdAt, (unsigned)task->doneAt);
+    }
+    writer->count++;
+    return !ferror(file);
+}
+
+// Fonction pour exporter les tâches actives puis terminées (archive, puis colonne "Done")
+// en CSV ou JSON (selon l'extension)
+int runExport(const BoardFiles *files, const char *path) {
+    ExportWriter writer = {0};
+    const char *extension = strrchr(path, '.');
+    writer.json = extension != NULL && strcmp(extension, ".json") == 0;
+    writer.file = fopen(path, "wb");
+    if (writer.file == NULL) {
+        printf("Error opening %s for writing.\n", path);
+        return 1;
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+    fputs(writer.json ? "[" : "column,text,created_at,done_at\n", writer.file);
+
+    // Un fichier absent correspond à une colonne vide
+    bool ok = true;
+    const char *sources[3] = {files->tasks, files->archive, files->done};
+    for (int s = 0; s < 3 && ok; ++s) {
+        SDL_RWops *rw = SDL_RWFromFile(sources[s], "rb");
+        if (rw != NULL) {
+            SDL_RWclose(rw);
+            ok = forEachStoredTask(sources[s], writeExportTask, &writer);
+        }
+    }
+
+    if (writer.json) {
+        fputs(writer.count > 0 ? "\n]\n" : "]\n", writer.file);
+    }
+    long bytes = ftell(writer.file);
+    if (fclose(writer.file) != 0 || !ok) {
+        printf("Error writing %s.\n", path);
+        return 1;
+    }
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    printf("%d tasks exported to %s (%.1f MB/s).\n", writer.count, path, bytes / 1e6 / (seconds > 0 ? seconds : 1e-9));
+    return 0;
+}
+
+// Structure pour lire un fichier par blocs (mémoire constante quelle que soit sa taille)
+typedef struct {
+    FILE *file;
+    char buffer[IMPORT_CHUNK_SIZE];
+    size_t length;
+    size_t position;
+    Uint64 offset; // Position du début du bloc dans le fichier
+} ChunkReader;
+
+// Fonction pour lire le caractère suivant (-1 en fin de fichier)
+int readerNext(ChunkReader *reader) {
+    if (reader->position == reader->length) {
+        reader->offset += reader->length;
+        reader->length = fread(reader->buffer, 1, IMPORT_CHUNK_SIZE, reader->file);
+        reader->position = 0;
+        if (reader->length == 0) {
+            return -1;
+        }
+    }
+    return (unsigned char)reader->buffer[reader->position++];
+}
+
+// Fonction pour regarder le caractère suivant sans le consommer
+int readerPeek(ChunkReader *reader) {
+    int c = readerNext(reader);
+    if (c != -1) {
+        reader->position--;
+    }
+    return c;
+}
+
+// Structure pour regrouper les tâches importées avant de les ajouter aux tableaux
+typedef struct {
+    TextLine *tasks;
+    int count;
+    Board *board;
+    Board *done;
+    int imported;
+    int skipped;
+    bool failed;
+} ImportBatch;
+
+// Fonction pour ajouter le lot aux tableaux, l'enregistrer et libérer les pages écrites
+void flushImportBatch(ImportBatch *batch) {
+    for (int i = 0; i < batch->count && !batch->failed; ++i) {
+        Board *target = batch->tasks[i].column == DONE_COLUMN ? batch->done : batch->board;
+        batch->failed = appendTask(target, &batch->tasks[i]) == NULL;
+    }
+    batch->imported += batch->count;
+    batch->count = 0;
+    if (!batch->failed && saveDirtyPages(batch->board) && saveDirtyPages(batch->done)) {
+        evictSavedPages(batch->board);
+        evictSavedPages(batch->done);
+    } else {
+        batch->failed = true;
+    }
+}
+
+// Fonction pour ajouter une tâche importée au lot courant
+void addImportedTask(ImportBatch *batch, int column, const char *text, long long createdAt, long long doneAt) {
+    if (column < 0 || column > 2) {
+        batch->skipped++;
+        return;
+    }
+    TextLine *task = &batch->tasks[batch->count++];
+    memset(task, 0, sizeof(*task));
+    task->column = column;
+    SDL_strlcpy(task->text, text, MAX_TEXT_LENGTH);
+    task->createdAt = createdAt > 0 ? (Uint32)createdAt : (Uint32)time(NULL);
+    task->doneAt = column != DONE_COLUMN ? 0 : (doneAt > 0 ? (Uint32)doneAt : (Uint32)time(NULL));
+    if (batch->count == IMPORT_BATCH_SIZE) {
+        flushImportBatch(batch);
+    }
+}
+
+// Fonction pour lire un champ CSV (guillemets doublés à l'intérieur d'un champ entre
+// guillemets) ; renvoie le caractère qui le termine : ',', '\n' ou -1
+int readCsvField(ChunkReader *reader, char *out, size_t outSize) {
+    size_t length = 0;
+    int c = readerNext(reader);
+    if (c == '"') {
+        while ((c = readerNext(reader)) != -1) {
+            if (c == '"') {
+                if (readerPeek(reader) != '"') {
+                    c = readerNext(reader);
+                    break;
+                }
+                readerNext(reader);
+            }
+            if (length + 1 < outSize) {
+                out[length++] = (char)c;
+            }
+        }
+        // Ignorer ce qui suit le guillemet fermant jusqu'au séparateur
+        while (c != ',' && c != '\n' && c != -1) {
+            c = readerNext(reader);
+        }
+    } else {
+        while (c != ',' && c != '\n' && c != -1) {
+            if (c != '\r' && length + 1 < outSize) {
+                out[length++] = (char)c;
+            }
+            c = readerNext(reader);
+        }
+    }
+    out[length] = '\0';
+    return c;
+}
+
+// Fonction pour importer un fichier CSV "column,text,created_at,done_at"
+bool importCsv(ChunkReader *reader, ImportBatch *batch) {
+    char fields[4][MAX_TEXT_LENGTH];
+    char extra[MAX_TEXT_LENGTH];
+    bool firstRecord = true;
+    int end = 0;
+    while (end != -1 && !batch->failed) {
+        int numFields = 0;
+        do {
+            end = readCsvField(reader, numFields < 4 ? fields[numFields] : extra, MAX_TEXT_LENGTH);
+            numFields++;
+        } while (end == ',');
+
+        // Ligne vide ou ligne d'en-tête
+        if (numFields == 1 && fields[0][0] == '\0') {
+            continue;
+        }
+        if (firstRecord && strcmp(fields[0], "column") == 0) {
+            firstRecord = false;
+            continue;
+        }
+        firstRecord = false;
+
+        char *endNumber;
+        long column = strtol(fields[0], &endNumber, 10);
+        if (numFields < 2 || endNumber == fields[0]) {
+            batch->skipped++;
+            continue;
+        }
+        addImportedTask(batch, (int)column, fields[1], numFields > 2 ? strtoll(fields[2], NULL, 10) : 0,
+                        numFields > 3 ? strtoll(fields[3], NULL, 10) : 0);
+    }
+    return !batch->failed;
+}
+
+// Fonction pour ignorer les espaces JSON
+int skipJsonSpaces(ChunkReader *reader) {
+    int c = readerPeek(reader);
+    while (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        readerNext(reader);
+        c = readerPeek(reader);
+    }
+    return c;
+}
+
+// Fonction pour lire 4 chiffres hexadécimaux d'un échappement \uXXXX
+long readJsonHex(ChunkReader *reader) {
+    long value = 0;
+    for (int i = 0; i < 4; ++i) {
+        int c = readerNext(reader);
+        int digit = c >= '0' && c <= '9' ? c - '0' : (c >= 'a' && c <= 'f' ? c - 'a' + 10 : (c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1));
+        if (digit < 0) {
+            return -1;
+        }
+        value = value * 16 + digit;
+    }
+    return value;
+}
+
+// Fonction pour lire une chaîne JSON (le guillemet ouvrant est le prochain caractère) ;
+// la chaîne est tronquée à outSize - 1 octets mais toujours consommée en entier
+bool readJsonString(ChunkReader *reader, char *out, size_t outSize) {
+    size_t length = 0;
+    if (readerNext(reader) != '"') {
+        return false;
+    }
+    for (;;) {
+        int c = readerNext(reader);
+        if (c == -1) {
+            return false;
+        }
+        if (c == '"') {
+            break;
+        }
+        char utf8[4];
+        int numBytes = 1;
+        utf8[0] = (char)c;
+        if (c == '\\') {
+            c = readerNext(reader);
+            switch (c) {
+                case 'n': utf8[0] = '\n'; break;
+                case 'r': utf8[0] = '\r'; break;
+                case 't': utf8[0] = '\t'; break;
+                case 'b': utf8[0] = '\b'; break;
+                case 'f': utf8[0] = '\f'; break;
+                case '"': case '\\': case '/': utf8[0] = (char)c; break;
+                case 'u': {
+                    long code = readJsonHex(reader);
+                    // Paire de substitution UTF-16
+                    if (code >= 0xD800 && code <= 0xDBFF && readerNext(reader) == '\\' && readerNext(reader) == 'u') {
+                        long low = readJsonHex(reader);
+                        code = low >= 0xDC00 && low <= 0xDFFF ? 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00) : -1;
+                    }
+                    if (code < 0) {
+                        return false;
+                    }
+                    if (code < 0x80) {
+                        utf8[0] = (char)code;
+                    } else if (code < 0x800) {
+                        utf8[0] = (char)(0xC0 | (code >> 6));
+                        utf8[1] = (char)(0x80 | (code & 0x3F));
+                        numBytes = 2;
+                    } else if (code < 0x10000) {
+                        utf8[0] = (char)(0xE0 | (code >> 12));
+                        utf8[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+                        utf8[2] = (char)(0x80 | (code & 0x3F));
+                        numBytes = 3;
+                    } else {
+                        utf8[0] = (char)(0xF0 | (code >> 18));
+                        utf8[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+                        utf8[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+                        utf8[3] = (char)(0x80 | (code & 0x3F));
+                        numBytes = 4;
+                    }
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        if (length + numBytes < outSize) {
+            memcpy(out + length, utf8, numBytes);
+            length += numBytes;
+        }
+    }
+    out[length] = '\0';
+    return true;
+}
+
+// Fonction pour ignorer une valeur JSON quelconque (clé inconnue)
+bool skipJsonValue(ChunkReader *reader, int depth) {
+    int c = skipJsonSpaces(reader);
+    if (c == '"') {
+        char ignored[1];
+        return readJsonString(reader, ignored, sizeof(ignored));
+    }
+    if (c == '{' || c == '[') {
+        int close = c == '{' ? '}' : ']';
+        readerNext(reader);
+        if (depth > 64) {
+            return false;
+        }
+        if (skipJsonSpaces(reader) == close) {
+            readerNext(reader);
+            return true;
+        }
+        for (;;) {
+            if (c == '{') {
+                char ignored[1];
+                if (skipJsonSpaces(reader) != '"' || !readJsonString(reader, ignored, sizeof(ignored)) ||
+                    skipJsonSpaces(reader) != ':') {
+                    return false;
+                }
+                readerNext(reader);
+            }
+            if (!skipJsonValue(reader, depth + 1)) {
+                return false;
+            }
+            int next = skipJsonSpaces(reader);
+            readerNext(reader);
+            if (next == close) {
+                return true;
+            }
+            if (next != ',') {
+                return false;
+            }
+        }
+    }
+    // Nombre, true, false ou null
+    bool any = false;
+    while ((c = readerPeek(reader)) != -1 && c != ',' && c != '}' && c != ']' && c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+        readerNext(reader);
+        any = true;
+    }
+    return any;
+}
+
+// Fonction pour lire un nombre JSON et le convertir en entier
+bool readJsonInteger(ChunkReader *reader, long long *value) {
+    char digits[32];
+    size_t length = 0;
+    int c = skipJsonSpaces(reader);
+    while ((c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E' || (c >= '0' && c <= '9')) && length + 1 < sizeof(digits)) {
+        digits[length++] = (char)readerNext(reader);
+        c = readerPeek(reader);
+    }
+    digits[length] = '\0';
+    char *end;
+    *value = (long long)strtod(digits, &end);
+    return length > 0 && *end == '\0';
+}
+
+// Fonction pour importer un tableau JSON d'objets {"column", "text", "createdAt", "doneAt"}
+bool importJson(ChunkReader *reader, ImportBatch *batch) {
+    if (skipJsonSpaces(reader) != '[') {
+        return false;
+    }
+    readerNext(reader);
+    if (skipJsonSpaces(reader) == ']') {
+        return true;
+    }
+    while (!batch->failed) {
+        if (skipJsonSpaces(reader) != '{') {
+            return false;
+        }
+        readerNext(reader);
+        long long column = -1, createdAt = 0, doneAt = 0;
+        char text[MAX_TEXT_LENGTH] = "";
+        if (skipJsonSpaces(reader) == '}') {
+            readerNext(reader);
+        } else {
+            for (;;) {
+                char key[16];
+                if (skipJsonSpaces(reader) != '"' || !readJsonString(reader, key, sizeof(key)) || skipJsonSpaces(reader) != ':') {
+                    return false;
+                }
+                readerNext(reader);
+                bool ok;
+                if (strcmp(key, "column") == 0) {
+                    ok = readJsonInteger(reader, &column);
+                } else if (strcmp(key, "createdAt") == 0) {
+                    ok = readJsonInteger(reader, &createdAt);
+                } else if (strcmp(key, "doneAt") == 0) {
+                    ok = readJsonInteger(reader, &doneAt);
+                } else if (strcmp(key, "text") == 0) {
+                    ok = skipJsonSpaces(reader) == '"' && readJsonString(reader, text, sizeof(text));
+                } else {
+                    ok = skipJsonValue(reader, 0);
+                }
+                int next = skipJsonSpaces(reader);
+                readerNext(reader);
+                if (!ok || (next != ',' && next != '}')) {
+                    return false;
+                }
+                if (next == '}') {
+                    break;
+                }
+            }
+        }
+        addImportedTask(batch, (int)column, text, createdAt, doneAt);
+
+        int next = skipJsonSpaces(reader);
+        readerNext(reader);
+        if (next == ']') {
+            return true;
+        }
+        if (next != ',') {
+            return false;
+        }
+    }
+    return false;
+}
+
+// Fonction pour importer un fichier CSV ou JSON (selon l'extension) dans les tableaux,
+// par lots enregistrés au fur et à mesure
+int runImport(const BoardFiles *files, const char *path) {
+    ChunkReader *reader = SDL_calloc(1, sizeof(ChunkReader));
+    ImportBatch batch = {0};
+    batch.tasks = SDL_malloc(IMPORT_BATCH_SIZE * sizeof(TextLine));
+    if (reader == NULL || batch.tasks == NULL) {
+        printf("Error allocating memory for import.\n");
+        SDL_free(reader);
+        SDL_free(batch.tasks);
+        return 1;
+    }
+    reader->file = fopen(path, "rb");
+    if (reader->file == NULL) {
+        printf("Error opening %s for reading.\n", path);
+        SDL_free(reader);
+        SDL_free(batch.tasks);
+        return 1;
+    }
+
+    // Seule la dernière page de chaque tableau est nécessaire pour ajouter des tâches
+    Board board = {0};
+    Board done = {0};
+    RecoveryStats stats;
+    board.path = files->tasks;
+    done.path = files->done;
+    done.appendOnly = true;
+    if (!loadTasksFromDb(&board, &stats, 1)) {
+        loadTasksFromFile(&board, files->inbox, &stats);
+    }
+    if (!loadTasksFromDb(&done, &stats, 1)) {
+        done.store.rewriteAll = true;
+    }
+    batch.board = &board;
+    batch.done = &done;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    const char *extension = strrchr(path, '.');
+    bool ok = extension != NULL && strcmp(extension, ".json") == 0 ? importJson(reader, &batch) : importCsv(reader, &batch);
+    if (!ok && !batch.failed) {
+        printf("Syntax error in %s near byte %llu.\n", path, (unsigned long long)(reader->offset + reader->position));
+    }
+    flushImportBatch(&batch);
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    Uint64 bytes = reader->offset + reader->length;
+
+    printf("%d tasks imported from %s, %d skipped (%.1f MB/s).\n", batch.imported, path, batch.skipped,
+           bytes / 1e6 / (seconds > 0 ? seconds : 1e-9));
+    fclose(reader->file);
+    SDL_free(reader);
+    SDL_free(batch.tasks);
+    freeBoard(&board);
+    freeBoard(&done);
+    return ok && !batch.failed ? 0 : 1;
+}
+
+// Fonction pour mesurer le coût d'un enregistrement après la modification d'une seule tâche
+int runSaveBenchmark(int numTasks) {
+    const char *path = "bench_tasks.db";
+    Board board = {0};
+    board.path = path;
+    if (!reserveTasks(&board, numTasks)) {
+        return 1;
+    }
+    for (int i = 0; i < numTasks; ++i) {
+        board.lines[i].column = i % 3;
+        snprintf(board.lines[i].text, MAX_TEXT_LENGTH, "Task %d", i);
+    }
+    board.numLines = numTasks;
+    board.store.rewriteAll = true;
+    remove(path);
+
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 start = SDL_GetPerformanceCounter();
+    bool ok = saveDirtyPages(&board);
+    double fullMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+    Uint64 fullBytes = board.store.bytesWritten;
+
+    // Modifier une seule tâche au milieu du tableau puis réenregistrer
+    snprintf(board.lines[numTasks / 2].text, MAX_TEXT_LENGTH, "Edited task");
+    markTaskDirty(&board.store, numTasks / 2);
+    start = SDL_GetPerformanceCounter();
+    ok = ok && saveDirtyPages(&board);
+    double editMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+    Uint64 editBytes = board.store.bytesWritten;
+    int editPages = board.store.pagesWritten;
+
+    // Supprimer la première tâche puis en ajouter une, qui reprend son emplacement : seules
+    // les pages de cet emplacement sont réécrites
+    deleteTask(&board, 0);
+    start = SDL_GetPerformanceCounter();
+    ok = ok && saveDirtyPages(&board);
+    double deleteMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+    Uint64 deleteBytes = board.store.bytesWritten;
+    int deletePages = board.store.pagesWritten;
+    TextLine task = {0};
+    snprintf(task.text, MAX_TEXT_LENGTH, "Inserted task");
+    ok = ok && appendTask(&board, &task) == &board.lines[0];
+    start = SDL_GetPerformanceCounter();
+    ok = ok && saveDirtyPages(&board);
+    double insertMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+
+    if (ok) {
+        printf("Full save of %d tasks: %llu bytes in %.2f ms\n", numTasks, (unsigned long long)fullBytes, fullMs);
+        printf("Save after editing one task: %llu bytes (%d pages) in %.3f ms\n", (unsigned long long)editBytes, editPages, editMs);
+        printf("Save after deleting the first task: %llu bytes (%d pages) in %.3f ms\n", (unsigned long long)deleteBytes, deletePages, deleteMs);
+        printf("Save after adding a task: %llu bytes (%d pages) in %.3f ms\n",
+               (unsigned long long)board.store.bytesWritten, board.store.pagesWritten, insertMs);
+    }
+    freeBoard(&board);
+    remove(path);
+    return ok ? 0 : 1;
+}
+
+// Fonction pour indexer toutes les tâches en mémoire d'un tableau et l'associer à son index
+void buildSearchIndex(Board *board, TrigramIndex *index) {
+    board->search = index;
+    index->board = board;
+    for (int i = 0; i < loadedTasks(board); ++i) {
+        if (!board->lines[i].isFree) {
+            indexTask(index, board->baseIndex + i, &board->lines[i]);
+        }
+    }
+}
+
+// Fonction pour comparer deux listes de tâches par longueur
+int comparePostingCounts(const void *a, const void *b) {
+    const Posting *x = *(const Posting *const *)a;
+    const Posting *y = *(const Posting *const *)b;
+    return (x->count > y->count) - (x->count < y->count);
+}
+
+// Fonction pour ne garder dans les résultats que les tâches présentes dans la liste d'un
+// trigramme. Une liste bien plus courte que les résultats est parcourue en cherchant chacune
+// de ses tâches par dichotomie dans les résultats ; sinon les résultats, triés, sont
+// parcourus avec les conteneurs de la liste.
+void intersectMatches(TrigramIndex *index, const Posting *posting) {
+    const TagBitmap *ids = &posting->ids;
+    int kept = 0;
+    ArenaMark mark = arenaMark(&frameArena);
+    Uint32 *list = posting->count * 16 < index->numMatches ? arenaAlloc(&frameArena, (size_t)posting->count * sizeof(Uint32) + 1) : NULL;
+    if (list != NULL) {
+        int count = tagBitmapIds(ids, list);
+        for (int k = 0, from = 0; k < count && from < index->numMatches; ++k) {
+            from += lowerBound(index->matches + from, index->numMatches - from, list[k]);
+            if (from < index->numMatches && index->matches[from] == list[k]) {
+                index->matches[kept++] = list[k];
+            }
+        }
+        index->numMatches = kept;
+        arenaRelease(&frameArena, mark);
+        return;
+    }
+    int c = 0, at = 0;
+    for (int m = 0; m < index->numMatches; ++m) {
+        Uint32 id = index->matches[m];
+        while (c < ids->numContainers && ids->containers[c].key < (id >> 16)) {
+            ++c;
+            at = 0;
+        }
+        if (c == ids->numContainers) {
+            break;
+        }
+        const TagContainer *container = &ids->containers[c];
+        if (container->key != (id >> 16)) {
+            continue;
+        }
+        bool found;
+        if (container->bits != NULL) {
+            found = (container->bits[(Uint16)id >> 6] >> (id & 63)) & 1;
+        } else {
+            while (at < container->count && container->values[at] < (Uint16)id) {
+                ++at;
+            }
+            found = at < container->count && container->values[at] == (Uint16)id;
+        }
+        if (found) {
+            index->matches[kept++] = id;
+        }
+    }
+    index->numMatches = kept;
+}
+
+// Fonction pour rechercher les tâches d'un tableau dont le texte contient query. Les listes
+// des trigrammes de la requête sont croisées en partant de la plus courte. Si la requête
+// prolonge la précédente et que l'index n'a pas changé, seuls ses nouveaux trigrammes sont
+// croisés avec les résultats précédents. Les candidats obtenus contiennent tous les
+// trigrammes sans forcément former la requête : ils sont vérifiés par petits lots
+// (verifySearchMatches), sauf pour une requête de 3 caractères où ils sont exacts.
+// En dessous de 3 caractères, rien n'est filtré.
+void searchTasks(TrigramIndex *index, const char *query) {
+    char lowerQuery[MAX_TEXT_LENGTH];
+    size_t length = 0;
+    for (; query[length] != '\0' && length < MAX_TEXT_LENGTH - 1; ++length) {
+        Uint8 c = (Uint8)query[length];
+        lowerQuery[length] = (char)(c >= 'A' && c <= 'Z' ? c + 32 : c);
+    }
+    lowerQuery[length] = '\0';
+    if (length < 3) {
+        index->active = false;
+        index->query[0] = '\0';
+        return;
+    }
+
+    flushPendingPostings(index);
+    size_t previousLength = strlen(index->query);
+    bool refine = index->active && !index->stale && strncmp(lowerQuery, index->query, previousLength) == 0;
+    Uint32 trigrams[MAX_TEXT_LENGTH];
+    int numTrigrams = extractTrigrams(refine ? lowerQuery + previousLength - 2 : lowerQuery, trigrams);
+    Posting *postings[MAX_TEXT_LENGTH];
+    for (int t = 0; t < numTrigrams; ++t) {
+        postings[t] = findPosting(index, trigrams[t], false);
+        if (postings[t] == NULL || postings[t]->count == 0) {
+            numTrigrams = -1;
+            break;
+        }
+    }
+    SDL_strlcpy(index->query, lowerQuery, sizeof(index->query));
+    index->active = true;
+    index->stale = false;
+    if (numTrigrams < 0) {
+        // Un trigramme absent : aucune tâche ne peut correspondre
+        index->numMatches = index->numVerified = index->nextToVerify = 0;
+        return;
+    }
+    SDL_qsort(postings, (size_t)numTrigrams, sizeof(Posting *), comparePostingCounts);
+
+    if (refine) {
+        // Les résultats précédents, vérifiés ou non, redeviennent des candidats
+        memmove(index->matches + index->numVerified, index->matches + index->nextToVerify,
+                (size_t)(index->numMatches - index->nextToVerify) * sizeof(Uint32));
+        index->numMatches = index->numVerified + index->numMatches - index->nextToVerify;
+    } else {
+        if (postings[0]->count > index->matchCapacity) {
+            Uint32 *matches = SDL_realloc(index->matches, (size_t)postings[0]->count * sizeof(Uint32));
+            if (matches == NULL) {
+                index->active = false;
+                return;
+            }
+            index->matches = matches;
+            index->matchCapacity = postings[0]->count;
+        }
+        index->numMatches = tagBitmapIds(&postings[0]->ids, index->matches);
+    }
+    for (int t = refine ? 0 : 1; t < numTrigrams && index->numMatches > 0; ++t) {
+        intersectMatches(index, postings[t]);
+    }
+    index->nextToVerify = length == 3 ? index->numMatches : 0;
+    index->numVerified = index->nextToVerify;
+}
+
+// Fonction pour vérifier au plus budget candidats de la recherche en cours (appelée à chaque
+// image jusqu'à ce que le nombre de résultats soit exact)
+void verifySearchMatches(TrigramIndex *index, const Board *board, int budget) {
+    if (!index->active) {
+        return;
+    }
+    int end = index->nextToVerify + budget < index->numMatches ? index->nextToVerify + budget : index->numMatches;
+    for (; index->nextToVerify < end; ++index->nextToVerify) {
+        Uint32 id = index->matches[index->nextToVerify];
+        int i = (int)id - board->baseIndex;
+        if (i >= 0 && i < loadedTasks(board) && containsIgnoreCase(board->lines[i].text, index->query)) {
+            index->matches[index->numVerified++] = id;
+        }
+    }
+}
+
+// Fonction pour compter les résultats de la recherche en cours (exact une fois tous les
+// candidats vérifiés)
+int countSearchMatches(const TrigramIndex *index) {
+    return index->active ? index->numVerified + index->numMatches - index->nextToVerify : 0;
+}
+
+// Fonction pour savoir si une tâche fait partie des résultats de la recherche en cours :
+// une tâche pas encore vérifiée l'est directement
+bool isSearchMatch(const TrigramIndex *index, const Board *board, int id) {
+    if (index == NULL || !index->active) {
+        return false;
+    }
+    int position = lowerBound(index->matches, index->numVerified, (Uint32)id);
+    if (position < index->numVerified && index->matches[position] == (Uint32)id) {
+        return true;
+    }
+    int remaining = index->numMatches - index->nextToVerify;
+    position = lowerBound(index->matches + index->nextToVerify, remaining, (Uint32)id);
+    return position < remaining && index->matches[index->nextToVerify + position] == (Uint32)id &&
+           containsIgnoreCase(board->lines[id - board->baseIndex].text, index->query);
+}
+
+// Fonction pour relancer la recherche dans les tâches actives et la colonne "Done" d'un tableau
+void updateSearch(OpenBoard *open, const char *query) {
+    searchTasks(&open->taskIndex, query);
+    searchTasks(&open->doneIndex, query);
+}
+
+// Fonction pour mesurer la recherche sur numTasks tâches : construction de l'index, frappe
+// d'une requête caractère par caractère, puis modifications de tâches. Le programme se
+// termine en erreur si une frappe ou une modification dépasse son budget.
+int runSearchBenchmark(int numTasks) {
+    static const char *words[] = {"fix", "write", "review", "deploy", "call", "email", "update", "design",
+                                  "test", "plan", "refactor", "meeting", "invoice", "report", "bug", "release",
+                                  "budget", "client", "server", "docs", "backup", "onboard", "sprint", "audit"};
+    const int numWords = (int)(sizeof(words) / sizeof(words[0]));
+    Board board = {0};
+    TrigramIndex index = {0};
+    if (!reserveTasks(&board, numTasks)) {
+        return 1;
+    }
+    Uint32 seed = 12345;
+    for (int i = 0; i < numTasks; ++i) {
+        int w[3];
+        for (int k = 0; k < 3; ++k) {
+            seed = seed * 1664525u + 1013904223u;
+            w[k] = (int)(seed >> 16) % numWords;
+        }
+        board.lines[i].column = i % 2;
+        snprintf(board.lines[i].text, MAX_TEXT_LENGTH, "%s %s %s #%d", words[w[0]], words[w[1]], words[w[2]], i);
+    }
+    board.numLines = numTasks;
+
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 start = SDL_GetPerformanceCounter();
+    buildSearchIndex(&board, &index);
+    double buildMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+    printf("Indexed %d tasks in %.1f ms (%.1f MB of postings)\n", numTasks, buildMs, index.idBytes / 1e6);
+
+    // Budgets prévus pour un million de tâches, plus larges pour un tableau plus grand
+    double scale = numTasks > 1000000 ? numTasks / 1e6 : 1.0;
+    bool ok = true;
+
+    // Frappe d'une requête sélective puis d'une requête très fréquente
+    const char *queries[] = {"#123456", "invoice aud", "review"};
+    for (int q = 0; q < 3; ++q) {
+        char typed[MAX_TEXT_LENGTH] = "";
+        double worstMs = 0;
+        for (size_t k = 0; queries[q][k] != '\0'; ++k) {
+            typed[k] = queries[q][k];
+            typed[k + 1] = '\0';
+            start = SDL_GetPerformanceCounter();
+            searchTasks(&index, typed);
+            double ms = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+            worstMs = ms > worstMs ? ms : worstMs;
+        }
+        int candidates = countSearchMatches(&index);
+        start = SDL_GetPerformanceCounter();
+        verifySearchMatches(&index, &board, index.numMatches);
+        double verifyMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+        bool fast = worstMs <= SEARCH_KEYSTROKE_BUDGET_MS * scale;
+        ok = ok && fast;
+        printf("Query \"%s\": slowest keystroke %.3f ms, %d candidates, %d matches after %.2f ms of verification, %s\n",
+               queries[q], worstMs, candidates, countSearchMatches(&index), verifyMs, fast ? "within budget" : "OVER BUDGET");
+        searchTasks(&index, "");
+    }
+
+    // Modifier, ajouter et supprimer des tâches : l'index est mis à jour à chaque fois
+    start = SDL_GetPerformanceCounter();
+    for (int k = 0; k < 1000; ++k) {
+        int id = nextLiveTask(&board, (int)((Uint32)k * 2654435761u % (Uint32)board.numLines));
+        unindexTask(&index, id, board.lines[id].text);
+        snprintf(board.lines[id].text, MAX_TEXT_LENGTH, "edited task %d", k);
+        indexTask(&index, id, &board.lines[id]);
+        TextLine task = {0};
+        snprintf(task.text, MAX_TEXT_LENGTH, "new task %d", k);
+        appendTask(&board, &task);
+        deleteTask(&board, id);
+    }
+    double updateMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+    bool fast = updateMs / 3000 <= SEARCH_UPDATE_BUDGET_MS * scale;
+    ok = ok && fast;
+    printf("1000 edits, adds and deletes: %.3f ms per operation, %s\n", updateMs / 3000, fast ? "within budget" : "OVER BUDGET");
+
+    freeTrigramIndex(&index);
+    freeBoard(&board);
+    return ok ? 0 : 1;
+}
+
+// Fonction pour reconnaître un mot-clé (AND, OR, NOT, sans tenir compte de la casse) ou un
+// symbole au début d'une expression de filtre, et le passer
+bool acceptFilterWord(const char **cursor, const char *word) {
+    while (**cursor == ' ') {
+        ++*cursor;
+    }
+    size_t length = strlen(word);
+    if (SDL_strncasecmp(*cursor, word, length) != 0 || (isTagChar(word[0]) && isTagChar((*cursor)[length]))) {
+        return false;
+    }
+    *cursor += length;
+    return true;
+}
+
+// Fonction pour ajouter un nœud à l'arbre d'une expression. Renvoie son numéro, -1 si l'arbre est plein.
+int addQueryNode(QueryParser *parser, int type, int left, int right) {
+    if (parser->numNodes == MAX_QUERY_NODES) {
+        return -1;
+    }
+    QueryNode *node = &parser->nodes[parser->numNodes];
+    memset(node, 0, sizeof(*node));
+    node->type = type;
+    node->left = left;
+    node->right = right;
+    return parser->numNodes++;
+}
+
+// Fonction pour ajouter une chaîne (nom d'étiquette ou texte cherché) à une vue filtrée.
+// Renvoie son numéro, -1 s'il n'y a plus de place.
+int addQueryString(QueryParser *parser, const char *text) {
+    Query *query = parser->query;
+    for (int i = 0; i < query->numStrings; ++i) {
+        if (strcmp(query->strings[i], text) == 0) {
+            return i;
+        }
+    }
+    if (query->numStrings == MAX_QUERY_STRINGS) {
+        return -1;
+    }
+    SDL_strlcpy(query->strings[query->numStrings], text, MAX_QUERY_STRING);
+    return query->numStrings++;
+}
+
+// Fonction pour lire un nombre, suivi pour un âge d'une unité (s, m, h, d ou w ; jours par défaut)
+bool readQueryNumber(const char **cursor, int field, Sint32 *value) {
+    while (**cursor == ' ') {
+        ++*cursor;
+    }
+    if (**cursor < '0' || **cursor > '9') {
+        return false;
+    }
+    Sint64 number = 0;
+    for (; **cursor >= '0' && **cursor <= '9' && number < 100000000; ++*cursor) {
+        number = number * 10 + (**cursor - '0');
+    }
+    if (field != QUERY_FIELD_COLUMN) {
+        const char *units = "smhdw";
+        static const Sint64 seconds[] = {1, 60, 3600, 86400, 604800};
+        const char *unit = **cursor != '\0' ? strchr(units, **cursor) : NULL;
+        number *= seconds[unit != NULL ? unit - units : 3];
+        *cursor += unit != NULL;
+    }
+    if (isTagChar(**cursor) || number > 0x7FFFFFFF) {
+        return false;
+    }
+    *value = (Sint32)number;
+    return true;
+}
+
+int parseQueryOr(QueryParser *parser);
+
+// Fonction pour lire un terme : #tag, champ comparé à un nombre, text ~ "...", NOT terme
+// ou expression entre parenthèses. Renvoie le numéro de son nœud, -1 en cas d'erreur.
+int parseQueryFactor(QueryParser *parser) {
+    const char **cursor = &parser->cursor;
+    if (acceptFilterWord(cursor, "NOT") || acceptFilterWord(cursor, "!")) {
+        int child = parseQueryFactor(parser);
+        return child < 0 ? -1 : addQueryNode(parser, FILTER_NOT, child, -1);
+    }
+    if (acceptFilterWord(cursor, "(")) {
+        int node = parseQueryOr(parser);
+        return node >= 0 && acceptFilterWord(cursor, ")") ? node : -1;
+    }
+    if (acceptFilterWord(cursor, "#")) {
+        char name[MAX_TAG_LENGTH];
+        if (readTagName(cursor, name) == 0 || name[0] < 'a' || name[0] > 'z') {
+            return -1;
+        }
+        int node = addQueryNode(parser, FILTER_TAG, -1, -1);
+        if (node >= 0 && (parser->nodes[node].value = addQueryString(parser, name)) < 0) {
+            return -1;
+        }
+        return node;
+    }
+    if (acceptFilterWord(cursor, "text")) {
+        // Texte entre guillemets, ou un seul mot
+        char text[MAX_QUERY_STRING];
+        int length = 0;
+        if (!acceptFilterWord(cursor, "~")) {
+            return -1;
+        }
+        bool quoted = acceptFilterWord(cursor, "\"");
+        for (; **cursor != '\0' && (quoted ? **cursor != '"' : isTagChar(**cursor)); ++*cursor) {
+            if (length < MAX_QUERY_STRING - 1) {
+                Uint8 c = (Uint8)**cursor;
+                text[length++] = (char)(c >= 'A' && c <= 'Z' ? c + 32 : c);
+            }
+        }
+        text[length] = '\0';
+        if ((quoted && !acceptFilterWord(cursor, "\"")) || length == 0) {
+            return -1;
+        }
+        int node = addQueryNode(parser, FILTER_TEXT, -1, -1);
+        if (node >= 0 && (parser->nodes[node].value = addQueryString(parser, text)) < 0) {
+            return -1;
+        }
+        return node;
+    }
+
+    // Champ comparé à un nombre
+    int field;
+    if (acceptFilterWord(cursor, "column")) {
+        field = QUERY_FIELD_COLUMN;
+    } else if (acceptFilterWord(cursor, "age")) {
+        field = QUERY_FIELD_AGE;
+    } else if (acceptFilterWord(cursor, "done")) {
+        field = QUERY_FIELD_DONE;
+    } else {
+        return -1;
+    }
+    static const char *operators[] = {"==", "!=", "<=", ">=", "=", "<", ">"};
+    static const int compares[] = {QUERY_EQUAL, QUERY_NOT_EQUAL, QUERY_LESS_EQUAL, QUERY_GREATER_EQUAL, QUERY_EQUAL, QUERY_LESS, QUERY_GREATER};
+    int compare = -1;
+    for (int o = 0; o < 7 && compare < 0; ++o) {
+        compare = acceptFilterWord(cursor, operators[o]) ? compares[o] : -1;
+    }
+    Sint32 value;
+    if (compare < 0 || !readQueryNumber(cursor, field, &value)) {
+        return -1;
+    }
+    int node = addQueryNode(parser, FILTER_COMPARE, -1, -1);
+    if (node >= 0) {
+        parser->nodes[node].field = field;
+        parser->nodes[node].compare = compare;
+        parser->nodes[node].value = value;
+    }
+    return node;
+}
+
+// Fonction pour lire des termes reliés par AND (ou simplement juxtaposés)
+int parseQueryAnd(QueryParser *parser) {
+    const char **cursor = &parser->cursor;
+    int node = parseQueryFactor(parser);
+    while (node >= 0) {
+        bool and = acceptFilterWord(cursor, "AND") || acceptFilterWord(cursor, "&");
+        // Sans AND, les termes juxtaposés s'arrêtent à la fin, à une parenthèse fermante ou à OR
+        const char *next = *cursor;
+        if (!and && (**cursor == '\0' || **cursor == ')' || acceptFilterWord(&next, "OR") || acceptFilterWord(&next, "|"))) {
+            break;
+        }
+        int right = parseQueryFactor(parser);
+        node = right < 0 ? -1 : addQueryNode(parser, FILTER_AND, node, right);
+    }
+    return node;
+}
+// Fonction pour lire des termes reliés par OR
+int parseQueryOr(QueryParser *parser) {
+    int node = parseQueryAnd(parser);
+    while (node >= 0 && (acceptFilterWord(&parser->cursor, "OR") || acceptFilterWord(&parser->cursor, "|"))) {
+        int right = parseQueryAnd(parser);
+        node = right < 0 ? -1 : addQueryNode(parser, FILTER_OR, node, right);
+    }
+    return node;
+}
+
+// Fonction pour estimer le coût d'évaluation d'un nœud sur une tâche : une comparaison est
+// moins chère qu'une étiquette (recherche dans un ensemble), elle-même moins chère qu'un texte
+int queryNodeCost(const QueryParser *parser, int n) {
+    const QueryNode *node = &parser->nodes[n];
+    if (node->type == FILTER_COMPARE) {
+        return 1;
+    }
+    if (node->type == FILTER_TAG) {
+        return 2;
+    }
+    if (node->type == FILTER_TEXT) {
+        return 16;
+    }
+    if (node->type == FILTER_NOT) {
+        return queryNodeCost(parser, node->left);
+    }
+    return queryNodeCost(parser, node->left) + queryNodeCost(parser, node->right);
+}
+
+// Fonction pour compiler un nœud en instructions. Pour AND et OR, le fils le moins cher est
+// évalué en premier et un saut évite l'autre quand le résultat est déjà connu.
+bool emitQueryCode(const QueryParser *parser, int n, Query *query) {
+    const QueryNode *node = &parser->nodes[n];
+    if (query->codeLength == MAX_QUERY_CODE) {
+        return false;
+    }
+    if (node->type == FILTER_AND || node->type == FILTER_OR) {
+        bool swap = queryNodeCost(parser, node->right) < queryNodeCost(parser, node->left);
+        if (!emitQueryCode(parser, swap ? node->right : node->left, query) || query->codeLength == MAX_QUERY_CODE) {
+            return false;
+        }
+        int jump = query->codeLength++;
+        query->code[jump] = (QueryInstr){node->type == FILTER_AND ? QUERY_OP_JUMP_IF_FALSE : QUERY_OP_JUMP_IF_TRUE, 0, 0, 0, 0};
+        if (!emitQueryCode(parser, swap ? node->left : node->right, query)) {
+            return false;
+        }
+        query->code[jump].target = (Uint8)query->codeLength;
+        return true;
+    }
+    if (node->type == FILTER_NOT) {
+        if (!emitQueryCode(parser, node->left, query) || query->codeLength == MAX_QUERY_CODE) {
+            return false;
+        }
+        query->code[query->codeLength++] = (QueryInstr){QUERY_OP_NOT, 0, 0, 0, 0};
+        return true;
+    }
+    Uint8 op = node->type == FILTER_TAG ? QUERY_OP_TAG : (node->type == FILTER_TEXT ? QUERY_OP_TEXT : QUERY_OP_COMPARE);
+    query->code[query->codeLength++] = (QueryInstr){op, (Uint8)node->field, (Uint8)node->compare, 0, node->value};
+    return true;
+}
+
+// Fonction pour compiler un nœud qui ne porte que sur des étiquettes en opérations postfixes
+// (« a AND NOT b » devient une différence, sans calculer le complément de b). Renvoie false
+// si le nœud porte sur autre chose.
+bool emitFilterOps(const QueryParser *parser, int n, Query *query) {
+    const QueryNode *node = &parser->nodes[n];
+    if (query->numOps == MAX_FILTER_OPS || node->type == FILTER_COMPARE || node->type == FILTER_TEXT) {
+        return false;
+    }
+    int op = node->type;
+    bool ok = true;
+    if (node->type == FILTER_AND && parser->nodes[node->right].type == FILTER_NOT) {
+        op = FILTER_AND_NOT;
+        ok = emitFilterOps(parser, node->left, query) && emitFilterOps(parser, parser->nodes[node->right].left, query);
+    } else if (node->type == FILTER_AND || node->type == FILTER_OR) {
+        ok = emitFilterOps(parser, node->left, query) && emitFilterOps(parser, node->right, query);
+    } else if (node->type == FILTER_NOT) {
+        ok = emitFilterOps(parser, node->left, query);
+    }
+    if (!ok || query->numOps == MAX_FILTER_OPS) {
+        return false;
+    }
+    query->ops[query->numOps++] = (FilterOp){op, node->type == FILTER_TAG ? node->value : -1};
+    return true;
+}
+
+// Fonction pour relever les étiquettes et les textes reliés à la racine par AND : toute tâche
+// de la vue les contient, leurs index donnent donc des candidats
+void collectQueryAnchors(const QueryParser *parser, int n, Query *query) {
+    const QueryNode *node = &parser->nodes[n];
+    if (node->type == FILTER_AND) {
+        collectQueryAnchors(parser, node->left, query);
+        collectQueryAnchors(parser, node->right, query);
+    } else if ((node->type == FILTER_TAG || node->type == FILTER_TEXT) && query->numAnchors < MAX_QUERY_STRINGS) {
+        query->anchors[query->numAnchors++] = (QueryInstr){node->type == FILTER_TAG ? QUERY_OP_TAG : QUERY_OP_TEXT, 0, 0, 0, node->value};
+    }
+}
+
+// Fonction pour compiler une expression de vue filtrée, par exemple
+// « column = 1 and age > 7d and text ~ "deploy" » ou « #backend AND NOT #blocked ».
+// L'expression est analysée une fois en arbre, puis compilée en code. Renvoie false si
+// elle est vide ou invalide.
+bool compileQuery(const char *expression, Query *query) {
+    memset(query, 0, sizeof(*query));
+    QueryParser parser;
+    parser.cursor = expression;
+    parser.numNodes = 0;
+    parser.query = query;
+    int root = parseQueryOr(&parser);
+    while (*parser.cursor == ' ') {
+        ++parser.cursor;
+    }
+    if (root < 0 || *parser.cursor != '\0' || !emitQueryCode(&parser, root, query)) {
+        memset(query, 0, sizeof(*query));
+        return false;
+    }
+    if (!emitFilterOps(&parser, root, query)) {
+        query->numOps = 0;
+    }
+    collectQueryAnchors(&parser, root, query);
+    return true;
+}
+
+// Fonction pour évaluer sur les ensembles compressés une vue qui ne porte que sur des étiquettes
+void evaluateFilterOps(TrigramIndex *index, const Query *query, TagBitmap *out) {
+    // Pile d'ensembles : ceux des étiquettes sont empruntés, les résultats intermédiaires
+    // sont gardés dans owned
+    const TagBitmap *stack[MAX_FILTER_OPS];
+    TagBitmap owned[MAX_FILTER_OPS];
+    int depth = 0;
+    for (int o = 0; o < query->numOps; ++o) {
+        const FilterOp *op = &query->ops[o];
+        TagBitmap result;
+        if (op->op == FILTER_TAG) {
+            memset(&owned[depth], 0, sizeof(TagBitmap));
+            stack[depth++] = &index->tags[query->tagIds[op->tag]].tasks;
+            continue;
+        }
+        if (op->op == FILTER_NOT) {
+            combineTagBitmaps(&index->indexed, stack[depth - 1], FILTER_AND_NOT, &result);
+        } else {
+            combineTagBitmaps(stack[depth - 2], stack[depth - 1], op->op, &result);
+            freeTagBitmap(&owned[--depth]);
+        }
+        freeTagBitmap(&owned[depth - 1]);
+        owned[depth - 1] = result;
+        stack[depth - 1] = &owned[depth - 1];
+    }
+    if (stack[0] == &owned[0]) {
+        *out = owned[0];
+    } else {
+        // Une seule étiquette : recopier son ensemble
+        TagBitmap empty = {0};
+        combineTagBitmaps(stack[0], &empty, FILTER_OR, out);
+    }
+}
+
+// Fonction pour appliquer une vue filtrée à un index (query NULL : l'enlever). Une vue sur des
+// étiquettes seulement est évaluée sur leurs ensembles ; sinon le code est évalué sur les
+// tâches en mémoire, ou seulement sur les candidats de l'index le plus sélectif (étiquette ou
+// trigramme le plus rare d'un texte) parmi les termes reliés à la racine par AND. Ensuite,
+// chaque tâche ajoutée ou modifiée est évaluée seule (tagTask, setTaskColumn).
+void applyQuery(TrigramIndex *index, const Query *query) {
+    freeTagBitmap(&index->filtered);
+    index->view.codeLength = 0;
+    const Board *board = index->board;
+    if (query == NULL || query->codeLength == 0 || board == NULL) {
+        return;
+    }
+    Query *view = &index->view;
+    *view = *query;
+    view->codeLength = 0;
+    for (int i = 0; i < view->numStrings; ++i) {
+        view->tagIds[i] = -1;
+    }
+    for (int pc = 0; pc < query->codeLength; ++pc) {
+        if (query->code[pc].op == QUERY_OP_TAG && (view->tagIds[query->code[pc].value] = findTag(index, view->strings[query->code[pc].value], true)) < 0) {
+            return;
+        }
+    }
+    view->now = (Uint32)time(NULL);
+    if (view->numOps > 0) {
+        evaluateFilterOps(index, view, &index->filtered);
+        view->codeLength = query->codeLength;
+        return;
+    }
+
+    // Candidats : la plus courte des listes données par les index
+    flushPendingPostings(index);
+    Uint32 *candidates = NULL;
+    int numCandidates = -1;
+    const TagBitmap *candidateTag = NULL;
+    for (int a = 0; a < view->numAnchors; ++a) {
+        const QueryInstr *anchor = &view->anchors[a];
+        if (anchor->op == QUERY_OP_TAG) {
+            const TagBitmap *tasks = &index->tags[view->tagIds[anchor->value]].tasks;
+            int count = tagBitmapCount(tasks);
+            if (numCandidates < 0 || count < numCandidates) {
+                candidateTag = tasks;
+                numCandidates = count;
+            }
+            continue;
+        }
+        Uint32 trigrams[MAX_QUERY_STRING];
+        int numTrigrams = extractTrigrams(view->strings[anchor->value], trigrams);
+        for (int t = 0; t < numTrigrams; ++t) {
+            const Posting *posting = findPosting(index, trigrams[t], false);
+            int count = posting != NULL ? posting->count : 0;
+            if (numCandidates < 0 || count < numCandidates) {
+                candidateTag = posting != NULL ? &posting->ids : NULL;
+                numCandidates = count;
+            }
+        }
+    }
+    ArenaMark mark = arenaMark(&frameArena);
+    if (candidateTag != NULL) {
+        candidates = arenaAlloc(&frameArena, (size_t)(numCandidates > 0 ? numCandidates : 1) * sizeof(Uint32));
+        numCandidates = candidates != NULL ? tagBitmapIds(candidateTag, candidates) : -1;
+    }
+
+    view->codeLength = query->codeLength;
+    int loaded = loadedTasks(board);
+    int count = numCandidates >= 0 ? numCandidates : loaded;
+    for (int k = 0; k < count; ++k) {
+        int i = numCandidates >= 0 ? (int)candidates[k] - board->baseIndex : k;
+        if (i >= 0 && i < loaded && !board->lines[i].isFree && runQuery(view, index, &board->lines[i], (Uint32)(board->baseIndex + i))) {
+            addToTagBitmap(&index->filtered, (Uint32)(board->baseIndex + i));
+        }
+    }
+    arenaRelease(&frameArena, mark);
+}
+
+// Fonction pour empiler en haut de leur colonne les tâches actives affichées, dans l'ordre
+// des clés (après un changement de vue filtrée)
+void stackShownTasks(Board *board) {
+    ArenaMark mark = arenaMark(&frameArena);
+    TextLine **sorted = arenaAlloc(&frameArena, ((size_t)loadedTasks(board) + 1) * sizeof(TextLine *));
+    int count = sorted != NULL ? sortTasksByOrder(board, sorted) : 0;
+    int rows[3] = {0, 0, 0};
+    for (int k = 0; k < count; ++k) {
+        TextLine *line = sorted[k];
+        if (isTaskShown(board, (int)(line - board->lines)) && !line->isDragging) {
+            line->rect = (SDL_Rect){line->column * WIDTH / 3 + 10, 40 + rows[line->column]++ * (MIN_TEXTBOX_HEIGHT + 5), TEXTBOX_WIDTH, line->rect.h};
+        }
+    }
+    arenaRelease(&frameArena, mark);
+}
+
+// Fonction pour afficher une vue filtrée des tâches actives et de la colonne "Done" d'un
+// tableau (expression vide : tout afficher). Une expression invalide laisse la vue en cours.
+bool updateFilterView(OpenBoard *open, const char *expression) {
+    Query query;
+    if (!compileQuery(expression, &query) && expression[0] != '\0') {
+        return false;
+    }
+    applyQuery(&open->taskIndex, &query);
+    applyQuery(&open->doneIndex, &query);
+    stackShownTasks(&open->tasks);
+    return true;
+}
+
+// Fonction pour mesurer les vues filtrées sur numTasks tâches : indexation des étiquettes,
+// évaluation sur les ensembles compressés comparée à un parcours de toutes les tâches, puis
+// mise à jour de la vue pendant des modifications
+int runTagBenchmark(int numTasks) {
+    // Étiquettes et pourcentage de tâches qui les portent
+    static const char *tagNames[] = {"backend", "frontend", "blocked", "bug", "urgent", "docs", "q3", "security"};
+    static const int tagPercents[] = {40, 35, 8, 20, 2, 5, 50, 1};
+    const int numTagNames = (int)(sizeof(tagNames) / sizeof(tagNames[0]));
+    Board board = {0};
+    TrigramIndex index = {0};
+    index.board = &board;
+    if (!reserveTasks(&board, numTasks)) {
+        return 1;
+    }
+    Uint32 seed = 12345;
+    for (int i = 0; i < numTasks; ++i) {
+        int length = snprintf(board.lines[i].text, MAX_TEXT_LENGTH, "task %d", i);
+        for (int t = 0; t < numTagNames; ++t) {
+            seed = seed * 1664525u + 1013904223u;
+            if ((int)((seed >> 16) % 100) < tagPercents[t]) {
+                length += snprintf(board.lines[i].text + length, MAX_TEXT_LENGTH - length, " #%s", tagNames[t]);
+            }
+        }
+    }
+    board.numLines = numTasks;
+
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < numTasks; ++i) {
+        tagTask(&index, i, board.lines[i].text, true);
+    }
+    double buildMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+    size_t bytes = tagBitmapBytes(&index.indexed);
+    for (int t = 0; t < index.numTags; ++t) {
+        bytes += tagBitmapBytes(&index.tags[t].tasks);
+    }
+    printf("Tagged %d tasks in %.1f ms (%d tags, %.2f MB of bitmaps)\n", numTasks, buildMs, index.numTags, bytes / 1e6);
+
+    const char *expressions[] = {"#backend AND NOT #blocked", "#urgent OR #security", "#bug #q3 !#docs", "NOT (#frontend OR #backend)"};
+    bool ok = true;
+    for (int e = 0; e < 4; ++e) {
+        Query query;
+        if (!compileQuery(expressions[e], &query)) {
+            printf("Invalid filter %s\n", expressions[e]);
+            ok = false;
+            continue;
+        }
+        start = SDL_GetPerformanceCounter();
+        applyQuery(&index, &query);
+        double bitmapMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+
+        // Même vue en évaluant le code sur chaque tâche
+        start = SDL_GetPerformanceCounter();
+        int scanned = 0;
+        for (int i = 0; i < numTasks; ++i) {
+            scanned += runQuery(&index.view, &index, &board.lines[i], (Uint32)i);
+        }
+        double scanMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+        int count = tagBitmapCount(&index.filtered);
+        ok = ok && count == scanned;
+        printf("%-28s %7d tasks: %.3f ms with bitmaps, %.1f ms evaluating each task%s\n", expressions[e], count, bitmapMs, scanMs,
+               count == scanned ? "" : " (MISMATCH)");
+    }
+
+    // Modifications avec une vue active : seule la tâche modifiée est évaluée
+    start = SDL_GetPerformanceCounter();
+    for (int k = 0; k < 10000; ++k) {
+        int id = (int)((Uint32)k * 2654435761u % (Uint32)numTasks);
+        tagTask(&index, id, board.lines[id].text, false);
+        snprintf(board.lines[id].text, MAX_TEXT_LENGTH, "edited %d #%s #%s", k, tagNames[k % numTagNames], tagNames[(k / 3) % numTagNames]);
+        tagTask(&index, id, board.lines[id].text, true);
+    }
+    double updateMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+    int incremental = tagBitmapCount(&index.filtered);
+    Query query = index.view;
+    applyQuery(&index, &query);
+    ok = ok && incremental == tagBitmapCount(&index.filtered);
+    printf("10000 edits with the view active: %.2f us per edit, view %s\n", updateMs * 1000.0 / 10000,
+           incremental == tagBitmapCount(&index.filtered) ? "consistent" : "INCONSISTENT");
+
+    freeTrigramIndex(&index);
+    freeBoard(&board);
+    return ok ? 0 : 1;
+}
+
+// Fonction pour mesurer les vues filtrées générales sur numTasks tâches : compilation, puis
+// évaluation avec les index comparée à l'évaluation du code sur toutes les tâches
+int runQueryBenchmark(int numTasks) {
+    static const char *words[] = {"fix", "write", "review", "deploy", "call", "email", "update", "design",
+                                  "test", "plan", "refactor", "invoice", "report", "release", "server", "docs"};
+    static const char *tagNames[] = {"backend", "frontend", "blocked", "urgent"};
+    Board board = {0};
+    TrigramIndex index = {0};
+    if (!reserveTasks(&board, numTasks)) {
+        return 1;
+    }
+    Uint32 now = (Uint32)time(NULL);
+    Uint32 seed = 12345;
+    for (int i = 0; i < numTasks; ++i) {
+        TextLine *line = &board.lines[i];
+        seed = seed * 1664525u + 1013904223u;
+        line->column = (int)(seed >> 16) % 3;
+        // Tâches créées dans les 60 derniers jours, terminées au plus 10 jours plus tard
+        line->createdAt = now - (seed >> 8) % (60 * 86400);
+        line->doneAt = line->column == DONE_COLUMN ? line->createdAt + (seed >> 4) % (10 * 86400) : 0;
+        line->doneAt = line->doneAt > now ? now : line->doneAt;
+        seed = seed * 1664525u + 1013904223u;
+        snprintf(line->text, MAX_TEXT_LENGTH, "%s %s #%s", words[(seed >> 16) % 16], words[(seed >> 20) % 16], tagNames[(seed >> 24) % 4]);
+    }
+    board.numLines = numTasks;
+
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 start = SDL_GetPerformanceCounter();
+    buildSearchIndex(&board, &index);
+    printf("Indexed %d tasks in %.1f ms\n", numTasks, (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency);
+
+    const char *expressions[] = {"column = 1 and age > 7d and text ~ \"deploy\"", "done < 1d or (column = 0 and age > 50d)",
+                                 "#backend and not #blocked and age < 30d", "text ~ invoice and column != 2",
+                                 "#urgent or text ~ \"release\""};
+    bool ok = true;
+    for (int e = 0; e < 5; ++e) {
+        Query query;
+        start = SDL_GetPerformanceCounter();
+        int compiles = 1000;
+        for (int k = 0; k < compiles; ++k) {
+            compileQuery(expressions[e], &query);
+        }
+        double compileUs = (double)(SDL_GetPerformanceCounter() - start) * 1e6 / frequency / compiles;
+        if (query.codeLength == 0) {
+            printf("Invalid filter %s\n", expressions[e]);
+            ok = false;
+            continue;
+        }
+        start = SDL_GetPerformanceCounter();
+        applyQuery(&index, &query);
+        double indexedMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+
+        // Même vue en évaluant le code sur toutes les tâches
+        start = SDL_GetPerformanceCounter();
+        int scanned = 0;
+        for (int i = 0; i < numTasks; ++i) {
+            scanned += runQuery(&index.view, &index, &board.lines[i], (Uint32)i);
+        }
+        double scanMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+        int count = tagBitmapCount(&index.filtered);
+        ok = ok && count == scanned;
+        printf("%-44s %7d tasks, %d instructions compiled in %.1f us: %.2f ms with the indexes, %.1f ms (%.1f ns per task) evaluating each task%s\n",
+               expressions[e], count, query.codeLength, compileUs, indexedMs, scanMs, scanMs * 1e6 / numTasks, count == scanned ? "" : " (MISMATCH)");
+    }
+
+    freeTrigramIndex(&index);
+    freeBoard(&board);
+    return ok ? 0 : 1;
+}
+
+// Fonction pour calculer le score d'un titre compact pour la requête de la palette (en
+// minuscules) : 0 si la requête n'en est pas une sous-séquence. Chaque caractère trouvé
+// rapporte 2 points, plus 3 en début de mot et 2 s'il suit le caractère précédent de la
+// requête ; le meilleur placement est retenu. Même calcul que fuzzyScoreBlock.
+int fuzzyScore(const Uint8 *row, const char *query, int queryLength) {
+    int ends[PALETTE_MAX_QUERY] = {0}; // Meilleur score avec query[k] placé sur le caractère précédent
+    int best[PALETTE_MAX_QUERY] = {0}; // Meilleur score avec query[0..k] placés jusqu'au caractère précédent
+    for (int c = 0; c < PALETTE_TITLE_WIDTH && row[c] != '\0'; ++c) {
+        Uint8 previous = c > 0 ? row[c - 1] : ' ';
+        int bonus = previous == ' ' || previous == '-' || previous == '_' || previous == '/' || previous == '.' ? 3 : 0;
+        for (int k = queryLength - 1; k >= 0; --k) {
+            int end = 0;
+            if (row[c] == (Uint8)query[k]) {
+                int before = k > 0 ? best[k - 1] : 1;
+                int chained = k > 0 ? ends[k - 1] : 0;
+                end = before > 0 ? before + 2 + bonus : 0;
+                if (chained > 0 && chained + 4 + bonus > end) {
+                    end = chained + 4 + bonus;
+                }
+            }
+            ends[k] = end;
+            best[k] = end > best[k] ? end : best[k];
+        }
+    }
+    return best[queryLength - 1] > 0 ? best[queryLength - 1] - 1 : 0;
+}
+
+#ifdef __SSE2__
+// Fonction pour transposer 16 x 16 octets : rows[i] octet j devient rows[j] octet i
+void transpose16x16(__m128i rows[16]) {
+    __m128i t[16];
+    for (int i = 0; i < 8; ++i) {
+        t[i] = _mm_unpacklo_epi8(rows[2 * i], rows[2 * i + 1]);
+        t[i + 8] = _mm_unpackhi_epi8(rows[2 * i], rows[2 * i + 1]);
+    }
+    for (int h = 0; h < 2; ++h) {
+        for (int i = 0; i < 4; ++i) {
+            rows[h * 8 + i] = _mm_unpacklo_epi16(t[h * 8 + 2 * i], t[h * 8 + 2 * i + 1]);
+            rows[h * 8 + i + 4] = _mm_unpackhi_epi16(t[h * 8 + 2 * i], t[h * 8 + 2 * i + 1]);
+        }
+    }
+    for (int q = 0; q < 4; ++q) {
+        for (int i = 0; i < 2; ++i) {
+            t[q * 4 + i] = _mm_unpacklo_epi32(rows[q * 4 + 2 * i], rows[q * 4 + 2 * i + 1]);
+            t[q * 4 + i + 2] = _mm_unpackhi_epi32(rows[q * 4 + 2 * i], rows[q * 4 + 2 * i + 1]);
+        }
+    }
+    // Après trois étapes, t[q * 4 + 2 * r + i] contient deux colonnes (à partir de
+    // 8 * (q / 2) + 4 * (q % 2) + 2 * r) des lignes 8 * i à 8 * i + 7
+    for (int q = 0; q < 4; ++q) {
+        int column = 8 * (q >> 1) + 4 * (q & 1);
+        for (int r = 0; r < 2; ++r) {
+            rows[column + 2 * r] = _mm_unpacklo_epi64(t[q * 4 + 2 * r], t[q * 4 + 2 * r + 1]);
+            rows[column + 2 * r + 1] = _mm_unpackhi_epi64(t[q * 4 + 2 * r], t[q * 4 + 2 * r + 1]);
+        }
+    }
+}
+
+// Fonction pour calculer le score de 16 titres compacts consécutifs à la fois : les titres
+// sont transposés pour qu'un registre contienne le même caractère des 16 titres, puis le
+// calcul de fuzzyScore est fait sur les 16 octets en parallèle (scores saturés à 255)
+void fuzzyScoreBlock(const Uint8 *rows, const char *query, int queryLength, Uint8 scores[16]) {
+    __m128i columns[PALETTE_TITLE_WIDTH];
+    for (int half = 0; half < PALETTE_TITLE_WIDTH / 16; ++half) {
+        for (int i = 0; i < 16; ++i) {
+            columns[half * 16 + i] = _mm_loadu_si128((const __m128i *)(rows + i * PALETTE_TITLE_WIDTH + half * 16));
+        }
+        transpose16x16(columns + half * 16);
+    }
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i ends[PALETTE_MAX_QUERY];
+    __m128i best[PALETTE_MAX_QUERY];
+    __m128i letters[PALETTE_MAX_QUERY];
+    for (int k = 0; k < queryLength; ++k) {
+        ends[k] = zero;
+        best[k] = zero;
+        letters[k] = _mm_set1_epi8(query[k]);
+    }
+    // reach : nombre de caractères de la requête déjà placés dans au moins un des titres ;
+    // query[k] ne peut être placé que si query[k - 1] l'a été sur un caractère précédent
+    int reach = 0;
+    __m128i previous = _mm_set1_epi8(' ');
+    for (int c = 0; c < PALETTE_TITLE_WIDTH; ++c) {
+        __m128i column = columns[c];
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(column, zero)) == 0xFFFF) {
+            break; // Fin des 16 titres
+        }
+        __m128i boundary = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(previous, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(previous, _mm_set1_epi8('-'))),
+                                        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(previous, _mm_set1_epi8('_')), _mm_cmpeq_epi8(previous, _mm_set1_epi8('/'))),
+                                                     _mm_cmpeq_epi8(previous, _mm_set1_epi8('.'))));
+        __m128i bonus = _mm_and_si128(boundary, _mm_set1_epi8(3));
+        __m128i step = _mm_adds_epu8(_mm_set1_epi8(2), bonus);
+        __m128i chainedStep = _mm_adds_epu8(step, _mm_set1_epi8(2));
+        for (int k = reach < queryLength - 1 ? reach : queryLength - 1; k >= 0; --k) {
+            __m128i match = _mm_cmpeq_epi8(column, letters[k]);
+            __m128i before = k > 0 ? best[k - 1] : one;
+            __m128i chained = k > 0 ? ends[k - 1] : zero;
+            // Un score nul signifie "pas de placement" : il ne doit pas être prolongé
+            __m128i end = _mm_andnot_si128(_mm_cmpeq_epi8(before, zero), _mm_adds_epu8(before, step));
+            end = _mm_max_epu8(end, _mm_andnot_si128(_mm_cmpeq_epi8(chained, zero), _mm_adds_epu8(chained, chainedStep)));
+            ends[k] = _mm_and_si128(match, end);
+            best[k] = _mm_max_epu8(best[k], ends[k]);
+        }
+        if (reach < queryLength && _mm_movemask_epi8(_mm_cmpeq_epi8(best[reach], zero)) != 0xFFFF) {
+            reach++;
+        }
+        if (queryLength - reach > PALETTE_TITLE_WIDTH - 1 - c) {
+            break; // Plus assez de caractères pour placer le reste de la requête
+        }
+        previous = column;
+    }
+    _mm_storeu_si128((__m128i *)scores, _mm_subs_epu8(best[queryLength - 1], one));
+}
+#endif
+
+// Fonction pour comparer deux résultats de la palette : meilleur score d'abord, puis ordre
+// d'apparition (commandes, puis tâches dans l'ordre du tableau)
+bool isBetterResult(const PaletteResult *a, const PaletteResult *b) {
+    return a->score > b->score || (a->score == b->score && a->order < b->order);
+}
+
+// Fonction pour proposer un résultat à la palette : les PALETTE_MAX_RESULTS meilleurs sont
+// gardés dans un tas dont la racine est le moins bon, sans trier l'ensemble des candidats
+void offerPaletteResult(Palette *palette, PaletteResult result) {
+    PaletteResult *heap = palette->results;
+    int i;
+    if (palette->numResults < PALETTE_MAX_RESULTS) {
+        // Remonter le nouveau résultat tant qu'il est moins bon que son parent
+        i = palette->numResults++;
+        while (i > 0 && isBetterResult(&heap[(i - 1) / 2], &result)) {
+            heap[i] = heap[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        heap[i] = result;
+        return;
+    }
+    if (!isBetterResult(&result, &heap[0])) {
+        return;
+    }
+    // Remplacer la racine et la faire descendre
+    i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= palette->numResults) {
+            break;
+        }
+        if (child + 1 < palette->numResults && isBetterResult(&heap[child], &heap[child + 1])) {
+            child++;
+        }
+        if (!isBetterResult(&result, &heap[child])) {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = result;
+}
+
+// Fonction pour trier les résultats gardés, du meilleur au moins bon
+int comparePaletteResults(const void *a, const void *b) {
+    return isBetterResult(a, b) ? -1 : (isBetterResult(b, a) ? 1 : 0);
+}
+
+// Fonction pour proposer les tâches d'un index à la palette. Avec narrow, seuls les blocs
+// de titres où la requête précédente a été trouvée sont parcourus.
+void scorePaletteTasks(Palette *palette, const TrigramIndex *index, int boardIndex, const char *query, int queryLength, bool narrow) {
+    int order = PALETTE_NUM_COMMANDS + MAX_OPEN_BOARDS + boardIndex * (1 << 30);
+    int numBlocks = narrow ? palette->numBlocks[boardIndex] : (index->numTitles + 15) / 16;
+    if (numBlocks > palette->blockCapacity[boardIndex]) {
+        int *blocks = SDL_realloc(palette->blocks[boardIndex], (size_t)numBlocks * sizeof(int));
+        if (blocks == NULL) {
+            return;
+        }
+        palette->blocks[boardIndex] = blocks;
+        palette->blockCapacity[boardIndex] = numBlocks;
+    }
+    int kept = 0;
+    for (int n = 0; n < numBlocks; ++n) {
+        int block = narrow ? palette->blocks[boardIndex][n] : n * 16;
+        const Uint8 *rows = index->titles + (size_t)block * PALETTE_TITLE_WIDTH;
+        Uint8 scores[16];
+#ifdef __SSE2__
+        fuzzyScoreBlock(rows, query, queryLength, scores);
+#else
+        for (int i = 0; i < 16; ++i) {
+            int score = fuzzyScore(rows + i * PALETTE_TITLE_WIDTH, query, queryLength);
+            scores[i] = (Uint8)(score > 255 ? 255 : score);
+        }
+#endif
+        // Ignorer les titres moins bons que le dernier résultat gardé
+        int threshold = palette->numResults == PALETTE_MAX_RESULTS ? palette->results[0].score : 0;
+        bool found = false;
+        for (int i = 0; i < 16 && block + i < index->numTitles; ++i) {
+            found = found || scores[i] > 0;
+            if (scores[i] > threshold) {
+                int id = index->titleBase + block + i;
+                offerPaletteResult(palette, (PaletteResult){scores[i], order + id, PALETTE_TASK, boardIndex, id});
+            }
+        }
+        if (found) {
+            palette->blocks[boardIndex][kept++] = block;
+        }
+    }
+    palette->numBlocks[boardIndex] = kept;
+}
+
+// Fonction pour mettre à jour les résultats de la palette : commandes et titres des tâches
+void updatePalette(Palette *palette, OpenBoard *open, const char **boardNames, int numBoardNames) {
+    static const char *commands[PALETTE_NUM_COMMANDS] = {"Add task", "Move to To Do", "Move to In Progress", "Move to Done", "Delete task",
+                                                         "Move filtered tasks to Done", "Delete filtered tasks", "Undo", "Redo"};
+    char query[PALETTE_MAX_QUERY + 1];
+    int queryLength = 0;
+    for (; palette->query[queryLength] != '\0' && queryLength < PALETTE_MAX_QUERY; ++queryLength) {
+        Uint8 c = (Uint8)palette->query[queryLength];
+        query[queryLength] = (char)(c >= 'A' && c <= 'Z' ? c + 32 : c);
+    }
+    query[queryLength] = '\0';
+    palette->numResults = 0;
+    palette->selected = 0;
+    palette->scroll = 0;
+
+    // Commandes (sans requête, elles sont toutes proposées)
+    for (int i = 0; i < PALETTE_NUM_COMMANDS + numBoardNames; ++i) {
+        char label[MAX_TEXT_LENGTH];
+        if (i < PALETTE_NUM_COMMANDS) {
+            SDL_strlcpy(label, commands[i], sizeof(label));
+        } else {
+            SDL_snprintf(label, sizeof(label), "Switch to board %s", boardNames[i - PALETTE_NUM_COMMANDS]);
+        }
+        Uint8 row[PALETTE_TITLE_WIDTH] = {0};
+        for (int k = 0; k < PALETTE_TITLE_WIDTH && label[k] != '\0'; ++k) {
+            row[k] = (Uint8)(label[k] >= 'A' && label[k] <= 'Z' ? label[k] + 32 : label[k]);
+        }
+        int score = queryLength > 0 ? fuzzyScore(row, query, queryLength) : 1;
+        if (score > 0) {
+            int action = i < PALETTE_NUM_COMMANDS ? i : PALETTE_SWITCH_BOARD;
+            offerPaletteResult(palette, (PaletteResult){score, i, action, 0, i - PALETTE_NUM_COMMANDS});
+        }
+    }
+
+    // Titres des tâches, une fois la requête commencée
+    const TrigramIndex *indexes[2] = {&open->taskIndex, &open->doneIndex};
+    size_t scannedLength = strlen(palette->scannedQuery);
+    for (int b = 0; b < 2 && queryLength > 0; ++b) {
+        bool narrow = palette->scannedBoard == open && scannedLength > 0 && strncmp(query, palette->scannedQuery, scannedLength) == 0 &&
+                      palette->versions[b] == indexes[b]->version;
+        scorePaletteTasks(palette, indexes[b], b, query, queryLength, narrow);
+        palette->versions[b] = indexes[b]->version;
+    }
+    palette->scannedBoard = open;
+    SDL_strlcpy(palette->scannedQuery, query, sizeof(palette->scannedQuery));
+    SDL_qsort(palette->results, (size_t)palette->numResults, sizeof(PaletteResult), comparePaletteResults);
+}
+
+// Fonction pour libérer les résultats de la palette
+void freePalette(Palette *palette) {
+    SDL_free(palette->results);
+    SDL_free(palette->blocks[0]);
+    SDL_free(palette->blocks[1]);
+    memset(palette, 0, sizeof(*palette));
+}
+
+// Fonction pour obtenir le texte affiché d'un résultat de la palette
+void paletteResultLabel(const PaletteResult *result, OpenBoard *open, const char **boardNames, char *label, size_t size) {
+    static const char *commands[PALETTE_NUM_COMMANDS] = {"Add task", "Move to To Do", "Move to In Progress", "Move to Done", "Delete task",
+                                                         "Move filtered tasks to Done", "Delete filtered tasks", "Undo", "Redo"};
+    static const char *columnNames[3] = {"To Do", "In Progress", "Done"};
+    if (result->action == PALETTE_TASK) {
+        const Board *board = result->board == 0 ? &open->tasks : &open->done;
+        const TextLine *line = &board->lines[result->id - board->baseIndex];
+        SDL_snprintf(label, size, "%s  [%s]", line->text, columnNames[line->column >= 0 && line->column < 3 ? line->column : 0]);
+    } else if (result->action == PALETTE_SWITCH_BOARD) {
+        SDL_snprintf(label, size, "Switch to board %s", boardNames[result->id]);
+    } else {
+        SDL_strlcpy(label, commands[result->action], size);
+    }
+}
+
+// Fonction pour mesurer la palette sur numTasks tâches : frappe d'une requête caractère par caractère
+int runPaletteBenchmark(int numTasks) {
+    static const char *words[] = {"fix", "write", "review", "deploy", "call", "email", "update", "design",
+                                  "test", "plan", "refactor", "meeting", "invoice", "report", "bug", "release"};
+    OpenBoard *open = SDL_calloc(1, sizeof(OpenBoard));
+    Palette palette = {0};
+    palette.results = SDL_malloc(PALETTE_MAX_RESULTS * sizeof(PaletteResult));
+    if (open == NULL || palette.results == NULL || !reserveTasks(&open->tasks, numTasks)) {
+        SDL_free(open);
+        SDL_free(palette.results);
+        return 1;
+    }
+    Uint32 seed = 12345;
+    for (int i = 0; i < numTasks; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        snprintf(open->tasks.lines[i].text, MAX_TEXT_LENGTH, "%s %s #%d", words[(seed >> 16) % 16], words[(seed >> 24) % 16], i);
+    }
+    open->tasks.numLines = numTasks;
+    buildSearchIndex(&open->tasks, &open->taskIndex);
+
+    // Vérifier que le calcul vectoriel donne les mêmes scores que le calcul simple
+    int mismatches = 0;
+    const char *check = "rvw";
+    for (int block = 0; block + 16 <= numTasks && block < 16 * 1000; block += 16) {
+        Uint8 scores[16];
+#ifdef __SSE2__
+        fuzzyScoreBlock(open->taskIndex.titles + (size_t)block * PALETTE_TITLE_WIDTH, check, 3, scores);
+#else
+        memset(scores, 0, sizeof(scores));
+#endif
+        for (int i = 0; i < 16; ++i) {
+            int score = fuzzyScore(open->taskIndex.titles + (size_t)(block + i) * PALETTE_TITLE_WIDTH, check, 3);
+            mismatches += scores[i] != score;
+        }
+    }
+#ifdef __SSE2__
+    printf("SSE2 scoring: %d mismatches against the scalar scoring\n", mismatches);
+#endif
+
+    const char *query = "rev inv 42";
+    const char *names[1] = {DEFAULT_BOARD_NAME};
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    for (size_t k = 1; k <= strlen(query); ++k) {
+        memcpy(palette.query, query, k);
+        palette.query[k] = '\0';
+        Uint64 start = SDL_GetPerformanceCounter();
+        updatePalette(&palette, open, names, 1);
+        double ms = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+        char label[MAX_TEXT_LENGTH] = "";
+        if (palette.numResults > 0) {
+            paletteResultLabel(&palette.results[0], open, names, label, sizeof(label));
+        }
+        printf("\"%s\": %.2f ms, best \"%s\" (score %d)\n", palette.query, ms, label, palette.numResults > 0 ? palette.results[0].score : 0);
+    }
+    freeTrigramIndex(&open->taskIndex);
+    freeBoard(&open->tasks);
+    SDL_free(open);
+    freePalette(&palette);
+    return mismatches == 0 ? 0 : 1;
+}
+
+// Fonction pour calculer la clé d'un texte rendu (texte, largeur de retour à la ligne et couleur)
+Uint32 textCacheHash(const char *text, SDL_Color color, int wrapWidth) {
+    Uint32 hash = crc32(text, strlen(text)) ^ ((Uint32)wrapWidth * 0x9E3779B1u) ^
+                  ((Uint32)color.r | (Uint32)color.g << 8 | (Uint32)color.b << 16 | (Uint32)color.a << 24);
+    return hash != 0 ? hash : 1;
+}
+
+// Fonction pour reconstruire la table du cache avec newCapacity emplacements. Avec
+// usedOnly, seules les textures dessinées pendant l'image en cours sont gardées.
+bool rehashTextCache(TextCache *cache, int newCapacity, bool usedOnly) {
+    TextCacheEntry *entries = SDL_calloc((size_t)newCapacity, sizeof(TextCacheEntry));
+    if (entries == NULL) {
+        return false;
+    }
+    cache->count = 0;
+    cache->bytes = 0;
+    for (int i = 0; i < cache->capacity; ++i) {
+        TextCacheEntry *entry = &cache->entries[i];
+        if (entry->hash == 0) {
+            continue;
+        }
+        if (usedOnly && entry->lastFrame != cache->frame) {
+            SDL_DestroyTexture(entry->texture);
+            continue;
+        }
+        int slot = (int)(entry->hash & (Uint32)(newCapacity - 1));
+        while (entries[slot].hash != 0) {
+            slot = (slot + 1) & (newCapacity - 1);
+        }
+        entries[slot] = *entry;
+        cache->count++;
+        cache->bytes += (size_t)entry->width * entry->height * 4;
+    }
+    SDL_free(cache->entries);
+    cache->entries = entries;
+    cache->capacity = newCapacity;
+    return true;
+}
+
+// Fonction pour chercher un texte dans le cache : son entrée, ou l'emplacement libre où l'ajouter
+TextCacheEntry *findTextCacheEntry(TextCache *cache, Uint32 hash, const char *text, SDL_Color color, int wrapWidth) {
+    int slot = (int)(hash & (Uint32)(cache->capacity - 1));
+    while (cache->entries[slot].hash != 0) {
+        TextCacheEntry *entry = &cache->entries[slot];
+        if (entry->hash == hash && entry->wrapWidth == wrapWidth && memcmp(&entry->color, &color, sizeof(color)) == 0 &&
+            strcmp(entry->text, text) == 0) {
+            return entry;
+        }
+        slot = (slot + 1) & (cache->capacity - 1);
+    }
+    return &cache->entries[slot];
+}
+
+// Fonction pour ranger la texture d'un texte dans l'emplacement libre entry du cache
+void storeTextTexture(TextCache *cache, TextCacheEntry *entry, Uint32 hash, const char *text, SDL_Color color, int wrapWidth, SDL_Texture *texture) {
+    entry->hash = hash;
+    entry->wrapWidth = wrapWidth;
+    entry->color = color;
+    entry->texture = texture;
+    SDL_QueryTexture(texture, NULL, NULL, &entry->width, &entry->height);
+    entry->lastFrame = cache->frame;
+    SDL_strlcpy(entry->text, text, sizeof(entry->text));
+    cache->count++;
+    cache->bytes += (size_t)entry->width * entry->height * 4;
+}
+
+// Fonction pour ajouter une valeur à une file sans verrou (false si elle est pleine)
+bool pushRasterQueue(RasterQueue *queue, int value) {
+    int position = SDL_AtomicGet(&queue->tail);
+    while (true) {
+        int index = position & (RASTER_QUEUE_SIZE - 1);
+        int diff = SDL_AtomicGet(&queue->sequence[index]) - position;
+        if (diff == 0) {
+            // Case libre : la réserver, puis publier la valeur avec le numéro de séquence
+            if (SDL_AtomicCAS(&queue->tail, position, position + 1)) {
+                queue->values[index] = value;
+                SDL_AtomicSet(&queue->sequence[index], position + 1);
+                return true;
+            }
+            position = SDL_AtomicGet(&queue->tail);
+        } else if (diff < 0) {
+            return false;
+        } else {
+            position = SDL_AtomicGet(&queue->tail);
+        }
+    }
+}
+
+// Fonction pour retirer la plus ancienne valeur d'une file sans verrou (false si elle est vide)
+bool popRasterQueue(RasterQueue *queue, int *value) {
+    int position = SDL_AtomicGet(&queue->head);
+    while (true) {
+        int index = position & (RASTER_QUEUE_SIZE - 1);
+        int diff = SDL_AtomicGet(&queue->sequence[index]) - (position + 1);
+        if (diff == 0) {
+            if (SDL_AtomicCAS(&queue->head, position, position + 1)) {
+                *value = queue->values[index];
+                // Rendre la case aux producteurs pour le tour suivant
+                SDL_AtomicSet(&queue->sequence[index], position + RASTER_QUEUE_SIZE);
+                return true;
+            }
+            position = SDL_AtomicGet(&queue->head);
+        } else if (diff < 0) {
+            return false;
+        } else {
+            position = SDL_AtomicGet(&queue->head);
+        }
+    }
+}
+
+// Fonction exécutée par chaque fil de rendu : rendre les textes confiés, avec sa propre police
+int runRasterWorker(void *data) {
+    RasterWorker *worker = data;
+    TextRaster *raster = worker->raster;
+    setAllocZone(ALLOC_RASTER);
+    nameTraceThread("text raster");
+    while (true) {
+        SDL_SemWait(raster->wake);
+        if (SDL_AtomicGet(&raster->quit)) {
+            return 0;
+        }
+        int index;
+        if (!popRasterQueue(&raster->queued, &index)) {
+            continue;
+        }
+        RasterJob *job = &raster->jobs[index];
+        Uint64 zone = beginTraceZone();
+        job->surface = TTF_RenderText_Blended_Wrapped(worker->font, job->text, job->color, (Uint32)job->wrapWidth);
+        endTraceZone(zone, "rasterize");
+        pushRasterQueue(&raster->finished, index);
+    }
+}
+
+// Fonction pour chercher un texte en cours de rendu : sa case dans la table, ou la case libre où l'ajouter
+int *findRasterPending(TextRaster *raster, Uint32 hash, const char *text, SDL_Color color, int wrapWidth) {
+    int mask = 2 * RASTER_QUEUE_SIZE - 1;
+    int slot = (int)(hash & (Uint32)mask);
+    while (raster->pending[slot] != 0) {
+        const RasterJob *job = &raster->jobs[raster->pending[slot] - 1];
+        if (job->hash == hash && job->wrapWidth == wrapWidth && memcmp(&job->color, &color, sizeof(color)) == 0 &&
+            strcmp(job->text, text) == 0) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return &raster->pending[slot];
+}
+
+// Fonction pour retirer une tâche de rendu de la table des textes en cours de rendu
+void removeRasterPending(TextRaster *raster, int index) {
+    int mask = 2 * RASTER_QUEUE_SIZE - 1;
+    int hole = (int)(raster->jobs[index].hash & (Uint32)mask);
+    while (raster->pending[hole] != index + 1) {
+        hole = (hole + 1) & mask;
+    }
+    // Recul des entrées suivantes qui ne sont plus séparées de leur case d'origine
+    for (int next = (hole + 1) & mask; raster->pending[next] != 0; next = (next + 1) & mask) {
+        int home = (int)(raster->jobs[raster->pending[next] - 1].hash & (Uint32)mask);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            raster->pending[hole] = raster->pending[next];
+            hole = next;
+        }
+    }
+    raster->pending[hole] = 0;
+}
+
+// Fonction pour confier un texte aux fils de rendu, s'il n'est pas déjà en cours de rendu.
+// Renvoie false si trop de textes sont en attente : il sera redemandé à l'image suivante.
+bool queueTextRaster(TextRaster *raster, Uint32 hash, const char *text, SDL_Color color, int wrapWidth) {
+    int *slot = findRasterPending(raster, hash, text, color, wrapWidth);
+    if (*slot != 0) {
+        return true;
+    }
+    if (raster->numFree == 0) {
+        return false;
+    }
+    int index = raster->freeJobs[--raster->numFree];
+    RasterJob *job = &raster->jobs[index];
+    job->hash = hash;
+    job->wrapWidth = wrapWidth;
+    job->color = color;
+    job->surface = NULL;
+    SDL_strlcpy(job->text, text, sizeof(job->text));
+    *slot = index + 1;
+    pushRasterQueue(&raster->queued, index);
+    SDL_SemPost(raster->wake);
+    return true;
+}
+
+// Fonction pour créer les textures des textes rendus par les fils, rangées dans le cache du
+// tableau affiché, jusqu'à épuisement du budget budgetUs (les suivantes attendent l'image
+// suivante). Renvoie le nombre de textes reçus.
+int uploadTextRaster(TextRaster *raster, SDL_Renderer *rend, TextCache *cache, int budgetUs) {
+    Uint64 zone = beginTraceZone();
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 budget = SDL_GetPerformanceFrequency() * (Uint64)budgetUs / 1000000;
+    int received = 0;
+    int index;
+    while (popRasterQueue(&raster->finished, &index)) {
+        RasterJob *job = &raster->jobs[index];
+        if (job->surface != NULL) {
+            SDL_Texture *texture = SDL_CreateTextureFromSurface(rend, job->surface);
+            SDL_FreeSurface(job->surface);
+            job->surface = NULL;
+            if (texture != NULL && (cache->count + 1) * 2 > cache->capacity &&
+                !rehashTextCache(cache, cache->capacity > 0 ? cache->capacity * 2 : 256, false)) {
+                SDL_DestroyTexture(texture);
+                texture = NULL;
+            }
+            if (texture != NULL) {
+                // Le texte a pu être rendu entre-temps sans attendre (texte en cours de modification)
+                TextCacheEntry *entry = findTextCacheEntry(cache, job->hash, job->text, job->color, job->wrapWidth);
+                if (entry->hash == 0) {
+                    storeTextTexture(cache, entry, job->hash, job->text, job->color, job->wrapWidth, texture);
+                    raster->uploaded++;
+                    renderCounters.rasterized++;
+                } else {
+                    SDL_DestroyTexture(texture);
+                }
+            }
+        }
+        removeRasterPending(raster, index);
+        job->hash = 0;
+        raster->freeJobs[raster->numFree++] = index;
+        raster->rendered++;
+        received++;
+        if (SDL_GetPerformanceCounter() - start >= budget) {
+            if (SDL_AtomicGet(&raster->finished.head) != SDL_AtomicGet(&raster->finished.tail)) {
+                raster->deferred++;
+            }
+            break;
+        }
+    }
+    raster->uploadTime += SDL_GetPerformanceCounter() - start;
+    endTraceZone(zone, "upload textures");
+    return received;
+}
+
+// Fonction pour arrêter les fils de rendu et libérer les textes qui n'ont pas été reçus
+void destroyTextRaster(TextRaster *raster) {
+    if (raster == NULL) {
+        return;
+    }
+    SDL_AtomicSet(&raster->quit, 1);
+    for (int i = 0; i < raster->numWorkers; ++i) {
+        SDL_SemPost(raster->wake);
+    }
+    for (int i = 0; i < raster->numWorkers; ++i) {
+        SDL_WaitThread(raster->workers[i].thread, NULL);
+    }
+    for (int i = 0; i < RASTER_MAX_WORKERS; ++i) {
+        if (raster->workers[i].font != NULL) {
+            TTF_CloseFont(raster->workers[i].font);
+        }
+    }
+    for (int i = 0; i < RASTER_QUEUE_SIZE; ++i) {
+        if (raster->jobs[i].surface != NULL) {
+            SDL_FreeSurface(raster->jobs[i].surface);
+        }
+    }
+    if (raster->wake != NULL) {
+        SDL_DestroySemaphore(raster->wake);
+    }
+    SDL_free(raster);
+}
+
+// Fonction pour démarrer les fils de rendu des textes, un par cœur en dehors de celui de
+// l'interface. Chaque fil ouvre sa propre police : une police SDL_ttf ne peut servir qu'à
+// un fil à la fois. Les polices sont ouvertes avant le démarrage des fils, FreeType
+// demandant que l'ouverture et la fermeture des polices ne se fassent pas en parallèle.
+// Renvoie NULL si aucun fil n'a pu démarrer : les textes sont alors rendus sans attendre.
+TextRaster *createTextRaster(const char *fontPath, int fontSize) {
+    TextRaster *raster = SDL_calloc(1, sizeof(TextRaster));
+    if (raster == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < RASTER_QUEUE_SIZE; ++i) {
+        SDL_AtomicSet(&raster->queued.sequence[i], i);
+        SDL_AtomicSet(&raster->finished.sequence[i], i);
+        raster->freeJobs[i] = RASTER_QUEUE_SIZE - 1 - i;
+    }
+    raster->numFree = RASTER_QUEUE_SIZE;
+    raster->wake = SDL_CreateSemaphore(0);
+    if (raster->wake == NULL) {
+        destroyTextRaster(raster);
+        return NULL;
+    }
+    int count = SDL_GetCPUCount() - 1;
+    count = count < 1 ? 1 : count > RASTER_MAX_WORKERS ? RASTER_MAX_WORKERS : count;
+    for (int i = 0; i < count; ++i) {
+        raster->workers[i].raster = raster;
+        raster->workers[i].font = TTF_OpenFont(fontPath, fontSize);
+        if (raster->workers[i].font == NULL) {
+            break;
+        }
+    }
+    while (raster->numWorkers < count && raster->workers[raster->numWorkers].font != NULL) {
+        RasterWorker *worker = &raster->workers[raster->numWorkers];
+        worker->thread = SDL_CreateThread(runRasterWorker, "text raster", worker);
+        if (worker->thread == NULL) {
+            break;
+        }
+        raster->numWorkers++;
+    }
+    if (raster->numWorkers == 0) {
+        destroyTextRaster(raster);
+        return NULL;
+    }
+    return raster;
+}
+
+// Fonction pour obtenir la texture d'un texte : elle n'est rendue qu'une fois, puis
+// réutilisée tant que le texte ne change pas. La texture appartient au cache.
+// Si le cache a des fils de rendu, un texte absent leur est confié (sauf urgent) et
+// NULL est renvoyé : la texture sera créée par uploadTextRaster à une image suivante.
+SDL_Texture *getTextTexture(TextCache *cache, SDL_Renderer *rend, TTF_Font *font, const char *text, SDL_Color color, int wrapWidth, bool urgent, int *width, int *height) {
+    if ((cache->count + 1) * 2 > cache->capacity && !rehashTextCache(cache, cache->capacity > 0 ? cache->capacity * 2 : 256, false)) {
+        return NULL;
+    }
+    Uint32 hash = textCacheHash(text, color, wrapWidth);
+    TextCacheEntry *entry = findTextCacheEntry(cache, hash, text, color, wrapWidth);
+    if (entry->hash != 0) {
+        entry->lastFrame = cache->frame;
+        renderCounters.cacheHits++;
+        *width = entry->width;
+        *height = entry->height;
+        return entry->texture;
+    }
+    renderCounters.cacheMisses++;
+    if (cache->raster != NULL && !urgent) {
+        queueTextRaster(cache->raster, hash, text, color, wrapWidth);
+        return NULL;
+    }
+
+    SDL_Surface *surface = TTF_RenderText_Blended_Wrapped(font, text, color, wrapWidth);
+    if (surface == NULL) {
+        return NULL;
+    }
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(rend, surface);
+    SDL_FreeSurface(surface);
+    if (texture == NULL) {
+        return NULL;
+    }
+    renderCounters.rasterized++;
+    storeTextTexture(cache, entry, hash, text, color, wrapWidth, texture);
+    *width = entry->width;
+    *height = entry->height;
+    return texture;
+}
+
+// Fonction pour obtenir la texture d'un libellé sur une ligne (titres des colonnes, bouton
+// "Add"), rendu sans lissage. Dans le cache, ces entrées ont une largeur de repli de -1 pour
+// ne pas être confondues avec celles des tâches ; sans cache, la texture est à détruire.
+SDL_Texture *getLabelTexture(TextCache *cache, SDL_Renderer *rend, TTF_Font *font, const char *text, SDL_Color color, int *width, int *height) {
+    if (cache == NULL) {
+        SDL_Surface *surface = TTF_RenderText_Solid(font, text, color);
+        SDL_Texture *texture = surface != NULL ? SDL_CreateTextureFromSurface(rend, surface) : NULL;
+        SDL_FreeSurface(surface);
+        renderCounters.rasterized++;
+        *width = *height = 0;
+        SDL_QueryTexture(texture, NULL, NULL, width, height);
+        return texture;
+    }
+    if ((cache->count + 1) * 2 > cache->capacity && !rehashTextCache(cache, cache->capacity > 0 ? cache->capacity * 2 : 256, false)) {
+        return NULL;
+    }
+    Uint32 hash = textCacheHash(text, color, -1);
+    TextCacheEntry *entry = findTextCacheEntry(cache, hash, text, color, -1);
+    if (entry->hash == 0) {
+        renderCounters.cacheMisses++;
+        SDL_Surface *surface = TTF_RenderText_Solid(font, text, color);
+        SDL_Texture *texture = surface != NULL ? SDL_CreateTextureFromSurface(rend, surface) : NULL;
+        SDL_FreeSurface(surface);
+        if (texture == NULL) {
+            return NULL;
+        }
+        renderCounters.rasterized++;
+        storeTextTexture(cache, entry, hash, text, color, -1, texture);
+    } else {
+        renderCounters.cacheHits++;
+    }
+    entry->lastFrame = cache->frame;
+    *width = entry->width;
+    *height = entry->height;
+    return entry->texture;
+}
+
+// Fonction pour libérer les textures du cache qui n'ont pas servi pendant l'image en cours
+void trimTextCache(TextCache *cache) {
+    if (cache->capacity > 0) {
+        rehashTextCache(cache, cache->capacity, true);
+    }
+}
+
+// Fonction pour libérer toutes les textures du cache
+void freeTextCache(TextCache *cache) {
+    for (int i = 0; i < cache->capacity; ++i) {
+        if (cache->entries[i].hash != 0) {
+            SDL_DestroyTexture(cache->entries[i].texture);
+        }
+    }
+    SDL_free(cache->entries);
+    memset(cache, 0, sizeof(*cache));
+}
+
+// Fonction pour vider l'historique des modifications
+void clearUndoLog(UndoLog *log) {
+    log->numRecords = 0;
+    log->cursor = 0;
+    log->textLength = 0;
+}
+
+// Fonction pour libérer l'historique des modifications
+void freeUndoLog(UndoLog *log) {
+    SDL_free(log->records);
+    SDL_free(log->texts);
+    memset(log, 0, sizeof(*log));
+}
+
+// Fonction pour agrandir un tampon de synchronisation si nécessaire
+bool reserveSyncBuffer(SyncBuffer *buffer, size_t length) {
+    if (length <= buffer->capacity) {
+        return true;
+    }
+    size_t newCapacity = buffer->capacity > 0 ? buffer->capacity : 4096;
+    while (newCapacity < length) {
+        newCapacity *= 2;
+    }
+    Uint8 *data = SDL_realloc(buffer->data, newCapacity);
+    if (data == NULL) {
+        return false;
+    }
+    buffer->data = data;
+    buffer->capacity = newCapacity;
+    return true;
+}
+
+// Fonction pour ajouter des octets à la fin d'un tampon
+bool appendSyncBytes(SyncBuffer *buffer, const void *data, size_t length) {
+    if (!reserveSyncBuffer(buffer, buffer->length + length)) {
+        return false;
+    }
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+    return true;
+}
+
+// Fonction pour ajouter un entier à un tampon, 7 bits par octet (le bit de poids fort indique
+// qu'un autre octet suit)
+bool writeSyncVarint(SyncBuffer *buffer, Uint64 value) {
+    Uint8 bytes[10];
+    size_t length = 0;
+    do {
+        bytes[length] = (Uint8)(value & 0x7F);
+        value >>= 7;
+        bytes[length++] |= value != 0 ? 0x80 : 0;
+    } while (value != 0);
+    return appendSyncBytes(buffer, bytes, length);
+}
+
+// Fonction pour lire un entier écrit par writeSyncVarint. Renvoie false s'il est tronqué.
+bool readSyncVarint(const Uint8 *data, size_t length, size_t *offset, Uint64 *value) {
+    *value = 0;
+    for (int shift = 0; shift < 64 && *offset < length; shift += 7) {
+        Uint8 byte = data[(*offset)++];
+        *value |= (Uint64)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Fonction pour ajouter une entrée à un tampon : type et identifiant, puis pour une tâche les
+// dates de ses registres, sa clé, sa colonne, ses dates et son texte sans le zéro final
+bool writeSyncEntry(SyncBuffer *buffer, const TextLine *task, bool deleted) {
+    Uint8 kind = deleted ? SYNC_ENTRY_DELETED : SYNC_ENTRY_TASK;
+    if (!appendSyncBytes(buffer, &kind, 1) || !writeSyncVarint(buffer, task->id)) {
+        return false;
+    }
+    if (deleted) {
+        return true;
+    }
+    for (int r = SYNC_TEXT; r <= SYNC_ORDER; ++r) {
+        if (!writeSyncVarint(buffer, task->stamps[r])) {
+            return false;
+        }
+    }
+    Uint8 column = (Uint8)task->column;
+    size_t length = strlen(task->text);
+    Uint8 textLength = (Uint8)length;
+    return writeSyncVarint(buffer, task->orderKey) && appendSyncBytes(buffer, &column, 1) &&
+           writeSyncVarint(buffer, task->createdAt) && writeSyncVarint(buffer, task->doneAt) &&
+           appendSyncBytes(buffer, &textLength, 1) && appendSyncBytes(buffer, task->text, length);
+}
+
+// Fonction pour lire l'entrée qui commence à *offset. Renvoie false si elle est illisible.
+bool readSyncEntry(const Uint8 *data, size_t length, size_t *offset, int *kind, TextLine *task) {
+    memset(task, 0, sizeof(*task));
+    if (*offset >= length) {
+        return false;
+    }
+    *kind = data[(*offset)++];
+    if ((*kind != SYNC_ENTRY_TASK && *kind != SYNC_ENTRY_DELETED) || !readSyncVarint(data, length, offset, &task->id) || task->id == 0) {
+        return false;
+    }
+    if (*kind == SYNC_ENTRY_DELETED) {
+        return true;
+    }
+    Uint64 createdAt, doneAt;
+    for (int r = SYNC_TEXT; r <= SYNC_ORDER; ++r) {
+        if (!readSyncVarint(data, length, offset, &task->stamps[r])) {
+            return false;
+        }
+    }
+    if (!readSyncVarint(data, length, offset, &task->orderKey) || *offset >= length) {
+        return false;
+    }
+    task->column = data[(*offset)++] > DONE_COLUMN ? 0 : data[*offset - 1];
+    if (!readSyncVarint(data, length, offset, &createdAt) || !readSyncVarint(data, length, offset, &doneAt) || *offset >= length) {
+        return false;
+    }
+    size_t textLength = data[(*offset)++];
+    if (length - *offset < textLength) {
+        return false;
+    }
+    memcpy(task->text, data + *offset, textLength);
+    *offset += textLength;
+    task->createdAt = (Uint32)createdAt;
+    task->doneAt = (Uint32)doneAt;
+    task->rect = (SDL_Rect){task->column * WIDTH / 3 + 10, 40, TEXTBOX_WIDTH, MIN_TEXTBOX_HEIGHT};
+    return true;
+}
+
+// Fonction pour répartir les identifiants dans une table
+Uint32 hashSyncId(Uint64 id) {
+    return (Uint32)((id * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+// Fonction pour trouver la case d'un identifiant dans une table, ou la case libre où l'ajouter
+Uint32 findSyncSlot(const SyncTable *table, Uint64 id) {
+    Uint32 mask = table->capacity - 1;
+    Uint32 slot = hashSyncId(id) & mask;
+    while (table->ids[slot] != 0 && table->ids[slot] != id) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+// Fonction pour lire la valeur d'un identifiant. Renvoie false s'il n'est pas dans la table.
+bool lookupSyncTable(const SyncTable *table, Uint64 id, Uint32 *value) {
+    if (table->count == 0) {
+        return false;
+    }
+    Uint32 slot = findSyncSlot(table, id);
+    if (table->ids[slot] == 0) {
+        return false;
+    }
+    *value = table->values[slot];
+    return true;
+}
+
+// Fonction pour ajouter un identifiant à une table ou changer sa valeur. La table double dès
+// qu'elle est à moitié pleine.
+bool putSyncTable(SyncTable *table, Uint64 id, Uint32 value) {
+    if ((table->count + 1) * 2 > table->capacity && (table->count == 0 || table->ids[findSyncSlot(table, id)] == 0)) {
+        SyncTable grown = {0};
+        grown.capacity = table->capacity > 0 ? table->capacity * 2 : 1024;
+        grown.ids = SDL_calloc(grown.capacity, sizeof(Uint64));
+        grown.values = SDL_malloc(grown.capacity * sizeof(Uint32));
+        if (grown.ids == NULL || grown.values == NULL) {
+            SDL_free(grown.ids);
+            SDL_free(grown.values);
+            return false;
+        }
+        for (Uint32 i = 0; i < table->capacity; ++i) {
+            if (table->ids[i] != 0) {
+                Uint32 slot = findSyncSlot(&grown, table->ids[i]);
+                grown.ids[slot] = table->ids[i];
+                grown.values[slot] = table->values[i];
+            }
+        }
+        grown.count = table->count;
+        SDL_free(table->ids);
+        SDL_free(table->values);
+        *table = grown;
+    }
+    Uint32 slot = findSyncSlot(table, id);
+    table->count += table->ids[slot] == 0;
+    table->ids[slot] = id;
+    table->values[slot] = value;
+    return true;
+}
+
+// Fonction pour retirer un identifiant d'une table : les identifiants suivants de la même
+// suite de cases remontent si besoin, pour qu'aucune recherche ne s'arrête sur la case libérée
+void removeSyncTable(SyncTable *table, Uint64 id) {
+    if (table->count == 0) {
+        return;
+    }
+    Uint32 mask = table->capacity - 1;
+    Uint32 hole = findSyncSlot(table, id);
+    if (table->ids[hole] == 0) {
+        return;
+    }
+    table->count--;
+    for (Uint32 next = (hole + 1) & mask; table->ids[next] != 0; next = (next + 1) & mask) {
+        Uint32 home = hashSyncId(table->ids[next]) & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            table->ids[hole] = table->ids[next];
+            table->values[hole] = table->values[next];
+            hole = next;
+        }
+    }
+    table->ids[hole] = 0;
+}
+
+// Fonction pour libérer une table
+void freeSyncTable(SyncTable *table) {
+    SDL_free(table->ids);
+    SDL_free(table->values);
+    memset(table, 0, sizeof(*table));
+}
+
+// Fonction pour dater une modification locale : horloge de Lamport, puis numéro d'instance
+Uint64 tickSyncClock(BoardSync *sync) {
+    sync->clock++;
+    return sync->clock << SYNC_REPLICA_BITS | sync->replica;
+}
+
+// Fonction pour avancer l'horloge au-delà d'une date reçue
+void seeSyncStamp(BoardSync *sync, Uint64 stamp) {
+    if (stamp >> SYNC_REPLICA_BITS > sync->clock) {
+        sync->clock = stamp >> SYNC_REPLICA_BITS;
+    }
+}
+
+// Fonction pour attribuer un identifiant à une tâche créée par cette instance
+Uint64 newSyncId(BoardSync *sync) {
+    return ++sync->counter << SYNC_REPLICA_BITS | sync->replica;
+}
+
+// Fonction pour oublier les tâches suivies, avant de relire le tableau ou de le suivre à nouveau
+void resetSyncTracking(BoardSync *sync) {
+    freeSyncTable(&sync->live);
+    freeSyncTable(&sync->tombstones);
+    sync->delta.length = 0;
+    sync->relay.length = 0;
+    sync->unsequenced.length = 0;
+    sync->tracking = false;
+    sync->batchesSent = 0;
+    sync->batchesAcked = 0;
+    sync->stable = 0;
+    sync->dragId = 0;
+}
+
+// Fonction pour noter la place d'une tâche dans la table des tâches en mémoire
+void placeSyncTask(BoardSync *sync, Uint64 id, int index, int slot) {
+    if (!putSyncTable(&sync->live, id, (Uint32)index * 2 + (Uint32)slot)) {
+        printf("Error allocating memory for shared board changes.\n");
+        sync->failed = true;
+    }
+}
+
+// Fonction pour ajouter une entrée locale au prochain lot envoyé. Les autres instances ne
+// peuvent plus suivre si elle est perdue : le tableau sera relu (client) ou les clients seront
+// déconnectés pour le relire (serveur).
+void recordSyncEntry(BoardSync *sync, const TextLine *task, bool deleted) {
+    if (!writeSyncEntry(&sync->delta, task, deleted)) {
+        printf("Error allocating memory for shared board changes.\n");
+        sync->failed = true;
+    }
+}
+
+// Fonction pour savoir si une tâche arrive de l'autre tableau partagé (voir transferTask)
+bool isSyncTransfer(const BoardSync *sync, const TextLine *line, int slot) {
+    Uint32 where;
+    return line->id != 0 && lookupSyncTable(&sync->live, line->id, &where) && (int)(where & 1) != slot;
+}
+
+// Fonction pour enregistrer une tâche ajoutée à l'emplacement index d'un tableau partagé
+// (avec sa clé d'ordre) : une nouvelle tâche reçoit un identifiant, une tâche qui arrive de
+// l'autre tableau garde le sien
+void shareAppendedTask(Board *board, TextLine *line, int index) {
+    BoardSync *sync = board->sync;
+    if (!sync->tracking) {
+        return;
+    }
+    int slot = board == sync->boards[1];
+    if (!sync->applying) {
+        Uint64 stamp = tickSyncClock(sync);
+        if (!isSyncTransfer(sync, line, slot)) {
+            line->id = newSyncId(sync);
+            line->stamps[SYNC_TEXT] = stamp;
+        }
+        line->stamps[SYNC_PLACE] = stamp;
+        line->stamps[SYNC_ORDER] = stamp;
+    }
+    placeSyncTask(sync, line->id, index, slot);
+    if (!sync->applying) {
+        recordSyncEntry(sync, line, false);
+    }
+}
+
+// Fonction pour enregistrer une tâche qui va être supprimée d'un tableau partagé : elle
+// devient une suppression, sauf si elle est déjà partie dans l'autre tableau
+void shareDeletedTask(Board *board, int index) {
+    BoardSync *sync = board->sync;
+    if (!sync->tracking) {
+        return;
+    }
+    int slot = board == sync->boards[1];
+    Uint64 id = board->lines[index].id;
+    Uint32 where;
+    if (lookupSyncTable(&sync->live, id, &where) && where == (Uint32)index * 2 + (Uint32)slot) {
+        removeSyncTable(&sync->live, id);
+        if (!sync->applying) {
+            // La suppression sera numérotée quand son lot aura une étape (voir sequenceSyncTombstones)
+            Uint8 pending[12];
+            writeLE64(pending, id);
+            writeLE32(pending + 8, sync->batchesSent + 1);
+            TextLine removed = {.id = id};
+            if (!putSyncTable(&sync->tombstones, id, 0) || !appendSyncBytes(&sync->unsequenced, pending, sizeof(pending))) {
+                sync->failed = true;
+            }
+            recordSyncEntry(sync, &removed, true);
+        }
+    }
+}
+
+// Fonction pour enregistrer le texte ou la colonne changés d'une tâche d'un tableau partagé
+void shareChangedTask(Board *board, int index, int reg) {
+    BoardSync *sync = board->sync;
+    if (!sync->tracking || sync->applying) {
+        return;
+    }
+    TextLine *line = &board->lines[index];
+    line->stamps[reg] = tickSyncClock(sync);
+    recordSyncEntry(sync, line, false);
+}
+
+// Fonction pour numéroter les suppressions locales des lots 1 à batch, fusionnés à l'étape seq
+void sequenceSyncTombstones(BoardSync *sync, Uint32 batch, Uint32 seq) {
+    size_t kept = 0;
+    for (size_t offset = 0; offset + 12 <= sync->unsequenced.length; offset += 12) {
+        const Uint8 *pending = sync->unsequenced.data + offset;
+        Uint64 id = readLE64(pending);
+        Uint32 value;
+        if (readLE32(pending + 8) > batch) {
+            memmove(sync->unsequenced.data + kept, pending, 12);
+            kept += 12;
+        } else if (lookupSyncTable(&sync->tombstones, id, &value) && value == 0) {
+            putSyncTable(&sync->tombstones, id, seq);
+        }
+    }
+    sync->unsequenced.length = kept;
+}
+
+// Fonction pour oublier les suppressions numérotées jusqu'à l'étape stable, reçue par toutes
+// les instances : plus aucune entrée ne peut arriver pour ces tâches. Renvoie leur nombre.
+int collectSyncTombstones(BoardSync *sync, Uint32 stable) {
+    SyncTable *table = &sync->tombstones;
+    int collected = 0;
+    for (Uint32 i = 0; i < table->capacity; ++i) {
+        collected += table->ids[i] != 0 && table->values[i] != 0 && table->values[i] <= stable;
+    }
+    if (collected == 0) {
+        return 0;
+    }
+    SyncTable kept = {0};
+    for (Uint32 i = 0; i < table->capacity; ++i) {
+        if (table->ids[i] != 0 && (table->values[i] == 0 || table->values[i] > stable) &&
+            !putSyncTable(&kept, table->ids[i], table->values[i])) {
+            freeSyncTable(&kept);
+            return 0;
+        }
+    }
+    freeSyncTable(table);
+    *table = kept;
+    sync->tombstonesCollected += collected;
+    return collected;
+}
+
+// Fonction pour ajouter une tâche reçue, ou arrivée de l'autre tableau, avec sa clé d'ordre.
+// Les tâches actives sont placées sous leur colonne (bottoms : voir placeAtColumnBottom).
+bool insertSyncTask(BoardSync *sync, const TextLine *task, int bottoms[3]) {
+    Board *board = sync->boards[task->column == DONE_COLUMN];
+    TextLine *line = appendTask(board, task);
+    if (line == NULL) {
+        sync->failed = true;
+        return false;
+    }
+    if (board == sync->boards[0]) {
+        placeAtColumnBottom(board, line, bottoms);
+    }
+    return true;
+}
+
+// Fonction pour fusionner une entrée reçue : chaque registre garde la valeur la plus récente,
+// une tâche supprimée ne revient jamais (sa suppression prend le numéro d'étape seq).
+// Renvoie true si le tableau a changé.
+bool mergeSyncEntry(BoardSync *sync, int kind, const TextLine *entry, Uint32 seq, int bottoms[3]) {
+    Uint32 where;
+    bool live = lookupSyncTable(&sync->live, entry->id, &where);
+    Uint32 value;
+    if (lookupSyncTable(&sync->tombstones, entry->id, &value)) {
+        return false;
+    }
+    if (kind == SYNC_ENTRY_DELETED) {
+        if (!putSyncTable(&sync->tombstones, entry->id, seq)) {
+            sync->failed = true;
+        }
+        if (live) {
+            deleteTask(sync->boards[where & 1], (int)(where >> 1));
+        }
+        return live;
+    }
+    if (!live) {
+        return insertSyncTask(sync, entry, bottoms);
+    }
+
+    Board *board = sync->boards[where & 1];
+    int index = (int)(where >> 1);
+    TextLine *line = &board->lines[index];
+    bool changed = false;
+    if (entry->stamps[SYNC_TEXT] > line->stamps[SYNC_TEXT]) {
+        if (strcmp(line->text, entry->text) != 0) {
+            setTaskText(board, index, entry->text);
+        }
+        line->stamps[SYNC_TEXT] = entry->stamps[SYNC_TEXT];
+        changed = true;
+    }
+    bool place = entry->stamps[SYNC_PLACE] > line->stamps[SYNC_PLACE];
+    bool order = entry->stamps[SYNC_ORDER] > line->stamps[SYNC_ORDER];
+    if (place && (entry->column == DONE_COLUMN) != (int)(where & 1)) {
+        // La tâche change de tableau
+        TextLine task = *line;
+        task.column = entry->column;
+        task.doneAt = entry->doneAt;
+        task.stamps[SYNC_PLACE] = entry->stamps[SYNC_PLACE];
+        if (order) {
+            task.orderKey = entry->orderKey;
+            task.stamps[SYNC_ORDER] = entry->stamps[SYNC_ORDER];
+        }
+        task.isEditing = false;
+        task.isDragging = false;
+        // Ajoutée d'abord à l'autre tableau : la suppression ne la compte pas comme supprimée
+        if (!insertSyncTask(sync, &task, bottoms)) {
+            return false;
+        }
+        deleteTask(board, index);
+        return true;
+    }
+    if (place) {
+        if (line->column != entry->column) {
+            setTaskColumn(board, index, entry->column);
+            if (board == sync->boards[0] && !line->isDragging) {
+                placeAtColumnBottom(board, line, bottoms);
+            }
+        }
+        line->doneAt = entry->doneAt;
+        line->stamps[SYNC_PLACE] = entry->stamps[SYNC_PLACE];
+        markTaskDirty(&board->store, index);
+        changed = true;
+    }
+    if (order) {
+        line->orderKey = entry->orderKey;
+        line->stamps[SYNC_ORDER] = entry->stamps[SYNC_ORDER];
+        board->lastOrderKey = line->orderKey > board->lastOrderKey ? line->orderKey : board->lastOrderKey;
+        board->ordered = false;
+        markTaskDirty(&board->store, index);
+        changed = true;
+    }
+    return changed;
+}
+
+// Fonction pour fusionner les entrées reçues d'une autre instance, sans les enregistrer. Le
+// serveur garde dans relay l'état fusionné des tâches qui ont changé, pour les autres
+// instances. Renvoie false si le message est illisible.
+bool mergeSyncEntries(BoardSync *sync, const Uint8 *data, size_t length, Uint32 seq, SyncBuffer *relay, int bottoms[3]) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    TextLine entry;
+    int kind;
+    bool ok = true;
+    sync->applying = true;
+    beginIndexBatch(sync->boards[0]->search);
+    beginIndexBatch(sync->boards[1]->search);
+    for (size_t offset = 0; ok && offset < length;) {
+        ok = readSyncEntry(data, length, &offset, &kind, &entry);
+        if (!ok) {
+            break;
+        }
+        for (int r = SYNC_TEXT; r <= SYNC_ORDER; ++r) {
+            seeSyncStamp(sync, entry.stamps[r]);
+        }
+        Uint32 where;
+        if (mergeSyncEntry(sync, kind, &entry, seq, bottoms) && relay != NULL) {
+            bool deleted = kind == SYNC_ENTRY_DELETED || !lookupSyncTable(&sync->live, entry.id, &where);
+            const TextLine *line = deleted ? &entry : &sync->boards[where & 1]->lines[where >> 1];
+            sync->failed = !writeSyncEntry(relay, line, deleted) || sync->failed;
+        }
+        sync->entriesMerged++;
+    }
+    endIndexBatch(sync->boards[0]->search);
+    endIndexBatch(sync->boards[1]->search);
+    sync->applying = false;
+    sync->mergeTime += SDL_GetPerformanceCounter() - start;
+    return ok;
+}
+
+// Fonction pour signaler la position d'une tâche déplacée à la souris : seule la dernière
+// position de chaque image est envoyée
+void moveSyncDrag(BoardSync *sync, const TextLine *line, SDL_Point position) {
+    if (sync->tracking && line->id != 0) {
+        sync->dragId = line->id;
+        sync->dragPosition = position;
+    }
+}
+
+// Fonction pour afficher une tâche déplacée à la souris dans une autre instance
+void applySyncDrag(BoardSync *sync, const Uint8 *data, size_t length) {
+    Uint32 where;
+    if (length < 12 || !lookupSyncTable(&sync->live, readLE64(data), &where)) {
+        return;
+    }
+    TextLine *line = &sync->boards[where & 1]->lines[where >> 1];
+    if (!line->isDragging) {
+        line->rect.x = (Sint16)(data[8] | data[9] << 8);
+        line->rect.y = (Sint16)(data[10] | data[11] << 8);
+    }
+}
+
+// Fonction pour ajouter à une connexion un message à envoyer
+bool queueSyncMessage(SyncPeer *peer, int type, Uint32 value, const void *data, size_t length) {
+    Uint8 header[SYNC_HEADER_SIZE];
+    writeLE32(header, (Uint32)(length + 5));
+    header[4] = (Uint8)type;
+    writeLE32(header + 5, value);
+    return appendSyncBytes(&peer->output, header, sizeof(header)) && appendSyncBytes(&peer->output, data, length);
+}
+
+// Fonction pour lire le prochain message reçu d'une connexion. Renvoie false s'il n'est pas
+// encore arrivé en entier.
+bool nextSyncMessage(SyncPeer *peer, int *type, Uint32 *value, const Uint8 **data, size_t *length) {
+    size_t available = peer->input.length - peer->consumed;
+    if (available < SYNC_HEADER_SIZE) {
+        return false;
+    }
+    const Uint8 *message = peer->input.data + peer->consumed;
+    size_t size = readLE32(message);
+    if (size < 5 || size > SYNC_MAX_MESSAGE) {
+        peer->broken = true;
+        return false;
+    }
+    if (available < 4 + size) {
+        return false;
+    }
+    *type = message[4];
+    *value = readLE32(message + 5);
+    *data = message + SYNC_HEADER_SIZE;
+    *length = size - 5;
+    peer->consumed += 4 + size;
+    return true;
+}
+
+#ifdef __linux__
+// Fonction pour recevoir ce qui est arrivé sur une connexion, sans attendre. Renvoie false si
+// la connexion est fermée.
+bool receiveSyncPeer(SyncPeer *peer) {
+    memmove(peer->input.data, peer->input.data + peer->consumed, peer->input.length - peer->consumed);
+    peer->input.length -= peer->consumed;
+    peer->consumed = 0;
+    for (;;) {
+        if (!reserveSyncBuffer(&peer->input, peer->input.length + 65536)) {
+            return false;
+        }
+        ssize_t received = recv(peer->fd, peer->input.data + peer->input.length, peer->input.capacity - peer->input.length, MSG_DONTWAIT);
+        if (received > 0) {
+            peer->input.length += (size_t)received;
+        } else if (received < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && !peer->broken;
+        }
+    }
+}
+
+// Fonction pour envoyer ce qui peut l'être sans attendre. Renvoie false si la connexion est
+// fermée ou si l'autre instance ne lit plus (plus de SYNC_MAX_OUTPUT octets en attente).
+bool sendSyncPeer(SyncPeer *peer, Uint64 *bytesSent) {
+    size_t sent = 0;
+    while (sent < peer->output.length) {
+        ssize_t written = send(peer->fd, peer->output.data + sent, peer->output.length - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (written > 0) {
+            sent += (size_t)written;
+        } else if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    memmove(peer->output.data, peer->output.data + sent, peer->output.length - sent);
+    peer->output.length -= sent;
+    *bytesSent += sent;
+    return peer->output.length <= SYNC_MAX_OUTPUT;
+}
+#endif
+
+// Fonction pour fermer une connexion
+void closeSyncPeer(SyncPeer *peer) {
+#ifdef __linux__
+    close(peer->fd);
+#endif
+    SDL_free(peer->input.data);
+    SDL_free(peer->output.data);
+    memset(peer, 0, sizeof(*peer));
+    peer->fd = -1;
+}
+
+// Fonction pour ajouter à une connexion la position de la tâche déplacée à la souris
+bool queueSyncDrag(SyncPeer *peer, const BoardSync *sync) {
+    Uint8 drag[12];
+    writeLE64(drag, sync->dragId);
+    drag[8] = (Uint8)sync->dragPosition.x;
+    drag[9] = (Uint8)(sync->dragPosition.x >> 8);
+    drag[10] = (Uint8)sync->dragPosition.y;
+    drag[11] = (Uint8)(sync->dragPosition.y >> 8);
+    return queueSyncMessage(peer, SYNC_DRAG, 0, drag, sizeof(drag));
+}
+
+// Fonction pour attendre, après un HELLO, que le serveur ait enregistré le tableau (client).
+// Les messages qui précèdent WELCOME sont déjà pris en compte dans les fichiers enregistrés ;
+// WELCOME donne l'horloge du serveur et le numéro de cette instance.
+bool welcomeSyncClient(BoardSync *sync) {
+#ifdef __linux__
+    SyncPeer *server = &sync->peers[0];
+    if (!queueSyncMessage(server, SYNC_HELLO, 0, NULL, 0)) {
+        return false;
+    }
+    Uint32 start = SDL_GetTicks();
+    while (SDL_GetTicks() - start < SYNC_WAIT_MS) {
+        if (!sendSyncPeer(server, &sync->bytesSent) || !receiveSyncPeer(server)) {
+            return false;
+        }
+        int type;
+        Uint32 value;
+        const Uint8 *data;
+        size_t length;
+        while (nextSyncMessage(server, &type, &value, &data, &length)) {
+            if (type == SYNC_WELCOME && length >= 12) {
+                resetSyncTracking(sync);
+                sync->seq = value;
+                sync->reportedSeq = value;
+                sync->clock = readLE64(data);
+                sync->replica = readLE32(data + 8);
+                sync->counter = 0;
+                sync->failed = false;
+                return true;
+            }
+        }
+        struct pollfd wait = {server->fd, POLLIN | (server->output.length > 0 ? POLLOUT : 0), 0};
+        poll(&wait, 1, 50);
+    }
+#endif
+    (void)sync;
+    return false;
+}
+
+// Fonction pour recevoir les identifiants et les clés des tâches du tableau lu (client) : ils
+// suivent WELCOME, dans l'ordre des fichiers. Les registres partent de la date 0, le serveur
+// ne relayant que des valeurs qui l'emportent sur celles enregistrées.
+bool receiveSyncIds(BoardSync *sync) {
+#ifdef __linux__
+    SyncPeer *server = &sync->peers[0];
+    int received[2] = {0, 0};
+    bool complete[2] = {false, false};
+    Uint32 start = SDL_GetTicks();
+    while (!(complete[0] && complete[1]) && SDL_GetTicks() - start < SYNC_WAIT_MS) {
+        int type;
+        Uint32 value;
+        const Uint8 *data;
+        size_t length;
+        while (!(complete[0] && complete[1]) && nextSyncMessage(server, &type, &value, &data, &length)) {
+            if (type != SYNC_IDS || value > 1 || length < 8) {
+                return false;
+            }
+            Board *board = sync->boards[value];
+            int first = (int)readLE32(data);
+            int total = (int)readLE32(data + 4);
+            int count = (int)((length - 8) / 16);
+            if (total != board->numLines || board->baseIndex != 0 || first != received[value] || count > total - first) {
+                return false;
+            }
+            for (int i = 0; i < count; ++i) {
+                // Un emplacement libre n'a pas d'identifiant
+                TextLine *line = &board->lines[first + i];
+                Uint64 id = readLE64(data + 8 + (size_t)i * 16);
+                if (line->isFree != (id == 0)) {
+                    return false;
+                }
+                if (line->isFree) {
+                    continue;
+                }
+                line->id = id;
+                line->orderKey = readLE64(data + 16 + (size_t)i * 16);
+                memset(line->stamps, 0, sizeof(line->stamps));
+                placeSyncTask(sync, line->id, first + i, (int)value);
+            }
+            board->ordered = false;
+            received[value] += count;
+            complete[value] = received[value] == total;
+        }
+        if (complete[0] && complete[1]) {
+            break;
+        }
+        if (!sendSyncPeer(server, &sync->bytesSent) || !receiveSyncPeer(server)) {
+            return false;
+        }
+        struct pollfd wait = {server->fd, POLLIN, 0};
+        poll(&wait, 1, 50);
+    }
+    sync->tracking = complete[0] && complete[1] && !sync->failed;
+    return sync->tracking;
+#else
+    (void)sync;
+    return false;
+#endif
+}
+
+// Fonction pour rejoindre les autres instances qui ont ouvert le même tableau : la première
+// prend le verrou et attend les connexions, les suivantes se connectent à elle et attendent
+// qu'elle ait enregistré le tableau avant de le lire. Sans réponse, le tableau n'est pas partagé.
+void startBoardSync(BoardSync *sync, const BoardFiles *files) {
+    sync->role = SYNC_ALONE;
+    sync->lockFd = -1;
+    sync->listenFd = -1;
+#ifdef __linux__
+    sync->lockFd = open(files->lock, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (sync->lockFd < 0) {
+        printf("Error opening %s: board %s is not shared.\n", files->lock, files->name);
+        return;
+    }
+    struct sockaddr_un address = {0};
+    address.sun_family = AF_UNIX;
+    SDL_strlcpy(address.sun_path, files->socket, sizeof(address.sun_path));
+    Uint32 start = SDL_GetTicks();
+    do {
+        if (flock(sync->lockFd, LOCK_EX | LOCK_NB) == 0) {
+            // Premier arrivé : le socket d'un serveur arrêté sans le retirer est remplacé
+            unlink(files->socket);
+            sync->listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (sync->listenFd >= 0 && bind(sync->listenFd, (struct sockaddr *)&address, sizeof(address)) == 0 &&
+                listen(sync->listenFd, SYNC_MAX_PEERS) == 0) {
+                sync->role = SYNC_SERVER;
+                return;
+            }
+            printf("Error creating %s: board %s is not shared.\n", files->socket, files->name);
+            if (sync->listenFd >= 0) {
+                close(sync->listenFd);
+                sync->listenFd = -1;
+            }
+            flock(sync->lockFd, LOCK_UN);
+            return;
+        }
+        SyncPeer *server = &sync->peers[0];
+        server->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (server->fd >= 0 && connect(server->fd, (struct sockaddr *)&address, sizeof(address)) == 0) {
+            fcntl(server->fd, F_SETFL, fcntl(server->fd, F_GETFL) | O_NONBLOCK);
+            sync->numPeers = 1;
+            sync->role = SYNC_CLIENT;
+            if (welcomeSyncClient(sync)) {
+                return;
+            }
+            sync->role = SYNC_ALONE;
+            sync->numPeers = 0;
+        }
+        closeSyncPeer(server);
+        SDL_Delay(10);
+    } while (SDL_GetTicks() - start < SYNC_WAIT_MS);
+    printf("Board %s is open in another instance that does not answer: changes will not be shared.\n", files->name);
+#else
+    (void)files;
+#endif
+}
+
+// Fonction pour quitter les autres instances : le serveur ferme les connexions puis libère le
+// verrou, les clients élisent alors un nouveau serveur
+void stopBoardSync(BoardSync *sync, const BoardFiles *files) {
+#ifdef __linux__
+    for (int i = 0; i < sync->numPeers; ++i) {
+        sendSyncPeer(&sync->peers[i], &sync->bytesSent);
+        closeSyncPeer(&sync->peers[i]);
+    }
+    if (sync->listenFd >= 0) {
+        close(sync->listenFd);
+        unlink(files->socket);
+    }
+    if (sync->lockFd >= 0) {
+        close(sync->lockFd);
+    }
+#else
+    (void)files;
+#endif
+    resetSyncTracking(sync);
+    SDL_free(sync->delta.data);
+    SDL_free(sync->relay.data);
+    SDL_free(sync->unsequenced.data);
+    memset(sync, 0, sizeof(*sync));
+}
+
+// Fonction pour enregistrer les tableaux modifiés d'un tableau ouvert (enregistrement
+// périodique, qui ajoute aussi une version à sa chronologie). Dans un tableau partagé, seul
+// le serveur enregistre, et jamais pendant qu'un client lit les fichiers.
+void saveOpenBoard(OpenBoard *open) {
+    if (open->sync.role == SYNC_CLIENT) {
+        return;
+    }
+    for (int i = 0; i < open->sync.numPeers; ++i) {
+        if (open->sync.peers[i].state == SYNC_PEER_LOADING) {
+            return;
+        }
+    }
+    Uint64 zone = beginTraceZone();
+    // L'archive d'abord : une tâche archivée n'est retirée de la colonne "Done" sur disque
+    // qu'une fois enregistrée dans l'archive
+    Board *boards[3] = {&open->archive, &open->tasks, &open->done};
+    for (int b = 0; b < 3; ++b) {
+        const PageStore *store = &boards[b]->store;
+        if (store->rewriteAll || store->changes != store->savedChanges || boards[b]->numLines != store->savedNumLines) {
+            saveDirtyPages(boards[b]);
+        }
+    }
+    endTraceZone(zone, "save");
+}
+
+// Fonction pour lire un tableau ouvert depuis ses fichiers : tâches actives, dernières pages
+// de la colonne "Done" (toute la colonne chez un client, qui suit chacune de ses tâches),
+// chronologie (sauf chez un client, qui n'enregistre rien) et surveillance de sa boîte de
+// réception
+void loadOpenBoard(OpenBoard *open, Uint32 archiveCutoff) {
+    Uint64 zone = beginTraceZone();
+    RecoveryStats stats;
+    open->tasks.store.quiet = open->done.store.quiet = open->archive.store.quiet = open->quiet;
+    open->tasks.path = open->files.tasks;
+    if (!loadTasksFromDb(&open->tasks, &stats, -1)) {
+        loadTasksFromFile(&open->tasks, open->files.inbox, &stats);
+    }
+    // Dans un tableau partagé, seul le serveur archive (l'archive n'est pas partagée)
+    loadDoneBoards(&open->files, &open->tasks, &open->done, &open->archive, open->sync.role == SYNC_CLIENT ? 0 : archiveCutoff);
+    if (open->sync.role == SYNC_CLIENT) {
+        loadEarlierPages(&open->done, open->done.baseIndex / RECORDS_PER_PAGE);
+    } else {
+        openTimeline(open);
+    }
+    layoutTasks(&open->tasks);
+    buildSearchIndex(&open->tasks, &open->taskIndex);
+    buildSearchIndex(&open->done, &open->doneIndex);
+    if (open->sync.role != SYNC_ALONE) {
+        open->sync.boards[0] = &open->tasks;
+        open->sync.boards[1] = &open->done;
+        open->tasks.sync = &open->sync;
+        open->done.sync = &open->sync;
+    }
+    if (open->sync.role == SYNC_CLIENT) {
+        if (!receiveSyncIds(&open->sync)) {
+            // Le tableau lu ne correspond pas à celui du serveur : il sera relu
+            open->sync.failed = true;
+        }
+        queueSyncMessage(&open->sync.peers[0], SYNC_LOADED, 0, NULL, 0);
+    }
+    scrollDoneColumn(&open->done, &open->doneScroll);
+    startInboxWatcher(&open->inbox, open->files.inbox);
+    endTraceZone(zone, "load board");
+}
+
+// Fonction pour relire un tableau ouvert (serveur remplacé, ou tâches qui ne correspondent
+// plus à celles du serveur) en gardant sa vue filtrée. L'historique est vidé.
+void reloadOpenBoard(OpenBoard *open, Uint32 archiveCutoff) {
+    Query view = open->taskIndex.view;
+    stopInboxWatcher(&open->inbox);
+    freeTrigramIndex(&open->taskIndex);
+    freeTrigramIndex(&open->doneIndex);
+    clearUndoLog(&open->history);
+    freeTimelineWriter(&open->timeline[0]);
+    freeTimelineWriter(&open->timeline[1]);
+    freeBoard(&open->tasks);
+    freeBoard(&open->done);
+    freeBoard(&open->archive);
+    loadOpenBoard(open, archiveCutoff);
+    applyQuery(&open->taskIndex, &view);
+    applyQuery(&open->doneIndex, &view);
+    stackShownTasks(&open->tasks);
+}
+
+// Fonction pour commencer à suivre les tâches d'un tableau (serveur, à l'arrivée du premier
+// client) : la colonne "Done" est chargée en entier, puis chaque tâche reçoit un identifiant
+// (les emplacements libres n'en ont pas) et garde sa clé enregistrée
+bool trackBoardSync(BoardSync *sync) {
+    Board *done = sync->boards[1];
+    if (done->baseIndex > 0 && (!loadEarlierPages(done, done->baseIndex / RECORDS_PER_PAGE) || done->baseIndex > 0)) {
+        return false;
+    }
+    for (int slot = 0; slot < 2; ++slot) {
+        Board *board = sync->boards[slot];
+        for (int i = 0; i < board->numLines; ++i) {
+            TextLine *line = &board->lines[i];
+            if (line->isFree) {
+                continue;
+            }
+            line->id = newSyncId(sync);
+            memset(line->stamps, 0, sizeof(line->stamps));
+            placeSyncTask(sync, line->id, i, slot);
+        }
+    }
+    sync->tracking = !sync->failed;
+    return sync->tracking;
+}
+
+// Fonction pour envoyer à un client les identifiants et les clés des tâches enregistrées
+// (identifiant 0 pour un emplacement libre), en messages de SYNC_MAX_MESSAGE octets au plus (au moins un par tableau)
+bool queueSyncIds(const BoardSync *sync, SyncPeer *peer) {
+    int perMessage = (SYNC_MAX_MESSAGE - 64) / 16;
+    Uint8 *chunk = SDL_malloc(8 + (size_t)perMessage * 16);
+    bool ok = chunk != NULL;
+    for (int slot = 0; ok && slot < 2; ++slot) {
+        const Board *board = sync->boards[slot];
+        int first = 0;
+        do {
+            int count = SDL_min(perMessage, board->numLines - first);
+            writeLE32(chunk, (Uint32)first);
+            writeLE32(chunk + 4, (Uint32)board->numLines);
+            for (int i = 0; i < count; ++i) {
+                writeLE64(chunk + 8 + (size_t)i * 16, board->lines[first + i].id);
+                writeLE64(chunk + 16 + (size_t)i * 16, board->lines[first + i].orderKey);
+            }
+            ok = queueSyncMessage(peer, SYNC_IDS, (Uint32)slot, chunk, 8 + (size_t)count * 16);
+            first += count;
+        } while (ok && first < board->numLines);
+    }
+    SDL_free(chunk);
+    return ok;
+}
+
+// Fonction pour accueillir les clients qui arrivent (serveur) : le tableau est enregistré pour
+// qu'ils le lisent, puis chacun reçoit un numéro d'instance et les identifiants des tâches
+void welcomeSyncClients(OpenBoard *open) {
+    BoardSync *sync = &open->sync;
+    if (!sync->tracking && !trackBoardSync(sync)) {
+        printf("Error loading board %s for the instances that share it.\n", open->files.name);
+        resetSyncTracking(sync);
+    }
+    saveOpenBoard(open);
+    for (int i = 0; i < sync->numPeers; ++i) {
+        SyncPeer *peer = &sync->peers[i];
+        if (peer->state != SYNC_PEER_JOINING) {
+            continue;
+        }
+        Uint8 welcome[12];
+        writeLE64(welcome, sync->clock);
+        writeLE32(welcome + 8, ++sync->nextReplica);
+        peer->broken = !sync->tracking || !queueSyncMessage(peer, SYNC_WELCOME, sync->seq, welcome, sizeof(welcome)) ||
+                       !queueSyncIds(sync, peer);
+        peer->state = SYNC_PEER_LOADING;
+        peer->since = SDL_GetTicks();
+        peer->applied = sync->seq;
+    }
+}
+
+// Fonction pour envoyer une étape à toutes les connexions sauf except (-1 : aucune)
+void publishSyncEntries(BoardSync *sync, int except, const Uint8 *data, size_t length) {
+    sync->seq++;
+    for (int i = 0; i < sync->numPeers; ++i) {
+        if (i != except && !queueSyncMessage(&sync->peers[i], SYNC_DELTA, sync->seq, data, length)) {
+            sync->peers[i].broken = true;
+        }
+    }
+}
+
+// Fonction pour oublier les suppressions reçues par toutes les instances (serveur) : la
+// dernière étape reçue par chaque client est annoncée aux autres, au plus une fois par
+// SYNC_COLLECT_MS, pour qu'ils oublient aussi les leurs
+void collectBoardSync(BoardSync *sync) {
+    Uint32 stable = sync->seq;
+    for (int i = 0; i < sync->numPeers; ++i) {
+        if (sync->peers[i].state != SYNC_PEER_JOINING && sync->peers[i].applied < stable) {
+            stable = sync->peers[i].applied;
+        }
+    }
+    if (stable == sync->stable || SDL_GetTicks() - sync->collectedAt < SYNC_COLLECT_MS) {
+        return;
+    }
+    sync->stable = stable;
+    sync->collectedAt = SDL_GetTicks();
+    for (int i = 0; i < sync->numPeers; ++i) {
+        if (sync->peers[i].state == SYNC_PEER_READY) {
+            queueSyncMessage(&sync->peers[i], SYNC_STABLE, stable, NULL, 0);
+        }
+    }
+    collectSyncTombstones(sync, stable);
+}
+
+// Fonction pour servir les autres instances (serveur) : les entrées locales partent comme
+// une nouvelle étape, puis les lots des clients sont fusionnés ; ce qui a changé le tableau
+// part comme une étape vers les autres clients, et le client reçoit son numéro. Les clients
+// qui arrivent sont accueillis quand aucun autre ne lit les fichiers. Renvoie true si des
+// tâches ont été modifiées par un client.
+bool serveBoardSync(OpenBoard *open) {
+    bool changed = false;
+#ifdef __linux__
+    BoardSync *sync = &open->sync;
+    int bottoms[3] = {-1, -1, -1};
+    if (sync->failed) {
+        // Une entrée n'a pas pu être enregistrée ou fusionnée : les clients relisent le tableau
+        for (int i = 0; i < sync->numPeers; ++i) {
+            closeSyncPeer(&sync->peers[i]);
+        }
+        sync->numPeers = 0;
+        resetSyncTracking(sync);
+        sync->failed = false;
+    }
+    if (sync->delta.length > 0) {
+        publishSyncEntries(sync, -1, sync->delta.data, sync->delta.length);
+        sequenceSyncTombstones(sync, ++sync->batchesSent, sync->seq);
+        sync->entryBytes += sync->delta.length;
+        sync->delta.length = 0;
+    }
+    if (sync->dragId != 0) {
+        for (int i = 0; i < sync->numPeers; ++i) {
+            queueSyncDrag(&sync->peers[i], sync);
+        }
+        sync->dragId = 0;
+    }
+
+    int fd;
+    while ((fd = accept4(sync->listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        if (sync->numPeers == SYNC_MAX_PEERS) {
+            close(fd);
+            continue;
+        }
+        SyncPeer *peer = &sync->peers[sync->numPeers++];
+        memset(peer, 0, sizeof(*peer));
+        peer->fd = fd;
+        peer->applied = sync->seq;
+    }
+
+    bool joining = false;
+    bool loading = false;
+    for (int i = 0; i < sync->numPeers; ++i) {
+        SyncPeer *peer = &sync->peers[i];
+        if (!receiveSyncPeer(peer)) {
+            peer->broken = true;
+            continue;
+        }
+        int type;
+        Uint32 value;
+        const Uint8 *data;
+        size_t length;
+        while (!peer->broken && nextSyncMessage(peer, &type, &value, &data, &length)) {
+            if (type == SYNC_HELLO) {
+                peer->state = SYNC_PEER_JOINING;
+            } else if (type == SYNC_LOADED && peer->state == SYNC_PEER_LOADING) {
+                peer->state = SYNC_PEER_READY;
+            } else if (type == SYNC_DELTA && peer->state == SYNC_PEER_READY && value <= sync->seq) {
+                peer->applied = value;
+                if (length == 0) {
+                    continue;
+                }
+                sync->relay.length = 0;
+                peer->broken = !mergeSyncEntries(sync, data, length, sync->seq + 1, &sync->relay, bottoms);
+                if (sync->relay.length > 0) {
+                    publishSyncEntries(sync, i, sync->relay.data, sync->relay.length);
+                    changed = true;
+                }
+                queueSyncMessage(peer, SYNC_ACK, sync->seq, NULL, 0);
+            } else if (type == SYNC_DRAG) {
+                applySyncDrag(sync, data, length);
+                for (int j = 0; j < sync->numPeers; ++j) {
+                    if (j != i) {
+                        queueSyncMessage(&sync->peers[j], SYNC_DRAG, value, data, length);
+                    }
+                }
+            } else if (type == SYNC_DELTA) {
+                peer->broken = true;
+            }
+        }
+        if (peer->state == SYNC_PEER_LOADING && SDL_GetTicks() - peer->since > SYNC_LOAD_MS) {
+            peer->broken = true;
+        }
+        joining = joining || peer->state == SYNC_PEER_JOINING;
+        loading = loading || (peer->state == SYNC_PEER_LOADING && !peer->broken);
+    }
+    if (joining && !loading) {
+        welcomeSyncClients(open);
+    }
+
+    for (int i = 0; i < sync->numPeers;) {
+        if (sync->peers[i].broken || !sendSyncPeer(&sync->peers[i], &sync->bytesSent)) {
+            closeSyncPeer(&sync->peers[i]);
+            sync->peers[i] = sync->peers[--sync->numPeers];
+        } else {
+            ++i;
+        }
+    }
+    if (sync->tracking) {
+        collectBoardSync(sync);
+    }
+#else
+    (void)open;
+#endif
+    return changed;
+}
+
+// Fonction pour relire le tableau d'un client qui ne peut plus suivre le serveur (message
+// illisible, entrée perdue) : le serveur l'enregistre, puis le client le relit
+void resyncBoard(OpenBoard *open, Uint32 archiveCutoff) {
+    printf("Board %s is out of step with the other instances: reloading it.\n", open->files.name);
+    open->sync.resyncs++;
+    if (!welcomeSyncClient(&open->sync)) {
+        open->sync.lost = true;
+        return;
+    }
+    reloadOpenBoard(open, archiveCutoff);
+}
+
+// Fonction pour noter le temps de réponse du serveur au lot le plus ancien qu'il n'avait pas
+// encore fusionné
+void noteSyncRoundTrip(BoardSync *sync) {
+    Uint64 sentAt = sync->sentAt[sync->batchesAcked % SDL_arraysize(sync->sentAt)];
+    double milliseconds = (double)(SDL_GetPerformanceCounter() - sentAt) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+    sync->roundTripTotal += milliseconds;
+    sync->roundTripMax = milliseconds > sync->roundTripMax ? milliseconds : sync->roundTripMax;
+    sync->roundTrips++;
+    sync->batchesAcked++;
+}
+
+// Fonction pour suivre le serveur (client) : les entrées locales de l'image précédente partent
+// en un lot, sans attendre la réponse aux lots précédents, puis les étapes reçues sont
+// fusionnées. La dernière étape reçue est signalée au serveur avec chaque lot, ou seule au plus
+// une fois par SYNC_REPORT_MS. Renvoie true si des tâches ont été modifiées par une autre
+// instance.
+bool followBoardSync(OpenBoard *open, Uint32 archiveCutoff) {
+    BoardSync *sync = &open->sync;
+    SyncPeer *server = &sync->peers[0];
+    bool changed = false;
+    int bottoms[3] = {-1, -1, -1};
+    if (sync->failed) {
+        resyncBoard(open, archiveCutoff);
+        changed = true;
+    }
+    if (sync->delta.length > 0 || (sync->seq != sync->reportedSeq && SDL_GetTicks() - sync->reportedAt >= SYNC_REPORT_MS)) {
+        queueSyncMessage(server, SYNC_DELTA, sync->seq, sync->delta.data, sync->delta.length);
+        if (sync->delta.length > 0) {
+            sync->sentAt[sync->batchesSent % SDL_arraysize(sync->sentAt)] = SDL_GetPerformanceCounter();
+            sync->batchesSent++;
+            sync->entryBytes += sync->delta.length;
+            sync->delta.length = 0;
+        }
+        sync->reportedSeq = sync->seq;
+        sync->reportedAt = SDL_GetTicks();
+    }
+    if (sync->dragId != 0) {
+        queueSyncDrag(server, sync);
+        sync->dragId = 0;
+    }
+
+#ifdef __linux__
+    if (sync->lost || !sendSyncPeer(server, &sync->bytesSent) || !receiveSyncPeer(server)) {
+        sync->lost = true;
+        return changed;
+    }
+#endif
+    int type;
+    Uint32 value;
+    const Uint8 *data;
+    size_t length;
+    while (!sync->lost && nextSyncMessage(server, &type, &value, &data, &length)) {
+        if (type == SYNC_DELTA && value == sync->seq + 1 && mergeSyncEntries(sync, data, length, value, NULL, bottoms)) {
+            sync->seq = value;
+            changed = true;
+        } else if (type == SYNC_ACK && sync->batchesAcked != sync->batchesSent && (value == sync->seq || value == sync->seq + 1)) {
+            sync->seq = value;
+            noteSyncRoundTrip(sync);
+            sequenceSyncTombstones(sync, sync->batchesAcked, value);
+        } else if (type == SYNC_STABLE && value <= sync->seq) {
+            collectSyncTombstones(sync, value);
+        } else if (type == SYNC_DRAG) {
+            applySyncDrag(sync, data, length);
+        } else {
+            resyncBoard(open, archiveCutoff);
+            changed = true;
+        }
+    }
+    sync->lost = sync->lost || server->broken;
+    return changed;
+}
+
+// Fonction pour retrouver les autres instances quand le serveur a disparu : une nouvelle
+// élection a lieu (ce client peut devenir le serveur), puis le tableau est relu depuis les
+// fichiers enregistrés par l'ancien serveur. Les modifications locales qu'il n'avait pas
+// encore reçues sont perdues.
+void rejoinBoardSync(OpenBoard *open, Uint32 archiveCutoff) {
+    stopBoardSync(&open->sync, &open->files);
+    startBoardSync(&open->sync, &open->files);
+    reloadOpenBoard(open, archiveCutoff);
+    if (open->sync.role == SYNC_SERVER) {
+        printf("Board %s: the instance that shared it was closed, this one shares it now.\n", open->files.name);
+    } else if (open->sync.role == SYNC_CLIENT) {
+        printf("Board %s: the instance that shared it was closed, reconnected to the new one.\n", open->files.name);
+    }
+}
+
+// Fonction pour échanger les messages d'un tableau partagé, une fois par image : les
+// modifications de l'image précédente partent en un seul lot, et les positions de
+// glisser-déposer en un seul message. Renvoie true si des tâches ont été modifiées par une
+// autre instance ou si le tableau a été relu.
+bool pollBoardSync(OpenBoard *open, Uint32 archiveCutoff) {
+    if (open->sync.role == SYNC_SERVER) {
+        return serveBoardSync(open);
+    }
+    if (open->sync.role != SYNC_CLIENT) {
+        return false;
+    }
+    bool changed = followBoardSync(open, archiveCutoff);
+    if (open->sync.lost) {
+        rejoinBoardSync(open, archiveCutoff);
+        changed = true;
+    }
+    return changed;
+}
+
+// Fonction pour attendre que le serveur ait fusionné les derniers lots d'un client qui ferme
+// le tableau
+void finishBoardSync(OpenBoard *open) {
+    Uint32 start = SDL_GetTicks();
+    while (open->sync.role == SYNC_CLIENT && !open->sync.lost &&
+           (open->sync.batchesAcked != open->sync.batchesSent || open->sync.delta.length > 0) && SDL_GetTicks() - start < SYNC_WAIT_MS) {
+        followBoardSync(open, 0);
+        SDL_Delay(1);
+    }
+}
+
+// Fonction pour ouvrir un tableau : tâches actives, dernières pages de la colonne "Done"
+// et surveillance de sa boîte de réception. Le tableau est partagé avec les autres instances
+// qui l'ont ouvert. Avec quiet, le chargement et les enregistrements n'affichent rien.
+OpenBoard *openBoard(const char *name, Uint32 archiveCutoff, bool quiet) {
+    OpenBoard *open = SDL_calloc(1, sizeof(OpenBoard));
+    if (open == NULL) {
+        printf("Error allocating memory for board %s.\n", name);
+        return NULL;
+    }
+    if (!setBoardFiles(&open->files, name)) {
+        SDL_free(open);
+        return NULL;
+    }
+    open->quiet = quiet;
+    startBoardSync(&open->sync, &open->files);
+    loadOpenBoard(open, archiveCutoff);
+    return open;
+}
+
+// Fonction pour fermer un tableau sans enregistrer ses modifications (un client n'envoie
+// pas celles qui attendent encore d'être envoyées)
+void discardBoard(OpenBoard *open) {
+    open->sync.delta.length = 0;
+    stopBoardSync(&open->sync, &open->files);
+    stopInboxWatcher(&open->inbox);
+    freeTextCache(&open->textCache);
+    freeTrigramIndex(&open->taskIndex);
+    freeTrigramIndex(&open->doneIndex);
+    freeUndoLog(&open->history);
+    freeTimelineWriter(&open->timeline[0]);
+    freeTimelineWriter(&open->timeline[1]);
+    freeBoard(&open->tasks);
+    freeBoard(&open->done);
+    freeBoard(&open->archive);
+    SDL_free(open);
+}
+
+// Fonction pour enregistrer et fermer un tableau (un client n'enregistre rien : il attend que
+// le serveur ait accepté ses dernières modifications)
+void closeBoard(OpenBoard *open) {
+    finishBoardSync(open);
+    if (open->sync.role != SYNC_CLIENT) {
+        Uint64 zone = beginTraceZone();
+        saveDirtyPages(&open->archive);
+        saveDirtyPages(&open->tasks);
+        saveDirtyPages(&open->done);
+        endTraceZone(zone, "save");
+    }
+    discardBoard(open);
+}
+
+// Fonction pour estimer la mémoire occupée par un tableau ouvert (tâches, suivi des pages,
+// boîte de réception, textures, historique, chronologie et partage)
+size_t boardMemory(const OpenBoard *open) {
+    const Board *boards[3] = {&open->tasks, &open->done, &open->archive};
+    size_t bytes = sizeof(OpenBoard);
+    for (int b = 0; b < 3; ++b) {
+        bytes += (size_t)boards[b]->capacity * sizeof(TextLine) + (size_t)boards[b]->store.pageCapacity * (1 + sizeof(Uint32));
+    }
+    bytes += (size_t)open->inbox.capacity * sizeof(InboxLine);
+    const TrigramIndex *indexes[2] = {&open->taskIndex, &open->doneIndex};
+    for (int i = 0; i < 2; ++i) {
+        bytes += (size_t)indexes[i]->capacity * sizeof(Posting) + indexes[i]->idBytes + (size_t)indexes[i]->matchCapacity * sizeof(Uint32) +
+                 (size_t)indexes[i]->titleCapacity * (PALETTE_TITLE_WIDTH + sizeof(TaskFields));
+        bytes += (size_t)indexes[i]->tagCapacity * sizeof(Tag) + (size_t)indexes[i]->tagSlotCapacity * sizeof(int) +
+                 tagBitmapBytes(&indexes[i]->indexed) + tagBitmapBytes(&indexes[i]->filtered);
+        for (int t = 0; t < indexes[i]->numTags; ++t) {
+            bytes += tagBitmapBytes(&indexes[i]->tags[t].tasks);
+        }
+    }
+    bytes += (size_t)open->textCache.capacity * sizeof(TextCacheEntry) + open->textCache.bytes;
+    bytes += (size_t)open->history.capacity * sizeof(UndoRecord) + open->history.textCapacity;
+    for (int b = 0; b < 2; ++b) {
+        bytes += (size_t)open->timeline[b].capacity * sizeof(TimelinePage) + (size_t)open->timeline[b].changedCapacity * sizeof(Uint32);
+    }
+    bytes += open->sync.delta.capacity + open->sync.relay.capacity + open->sync.unsequenced.capacity;
+    bytes += (size_t)(open->sync.live.capacity + open->sync.tombstones.capacity) * (sizeof(Uint64) + sizeof(Uint32));
+    for (int i = 0; i < open->sync.numPeers; ++i) {
+        bytes += open->sync.peers[i].input.capacity + open->sync.peers[i].output.capacity;
+    }
+    return bytes;
+}
+
+// Fonction pour afficher un tableau : il est repris du cache s'il y est encore, sinon chargé
+OpenBoard *switchBoard(BoardCache *cache, const char *name, Uint32 archiveCutoff) {
+    OpenBoard *open = NULL;
+    for (int i = 0; i < cache->count && open == NULL; ++i) {
+        if (strcmp(cache->boards[i]->files.name, name) == 0) {
+            open = cache->boards[i];
+        }
+    }
+    if (open == NULL) {
+        if (cache->count == MAX_OPEN_BOARDS) {
+            // Libérer une place : le tableau utilisé le moins récemment est fermé
+            int oldest = 0;
+            for (int i = 1; i < cache->count; ++i) {
+                if (cache->boards[i]->lastUsed < cache->boards[oldest]->lastUsed) {
+                    oldest = i;
+                }
+            }
+            closeBoard(cache->boards[oldest]);
+            cache->boards[oldest] = cache->boards[--cache->count];
+        }
+        open = openBoard(name, archiveCutoff, false);
+        if (open == NULL) {
+            return NULL;
+        }
+        cache->boards[cache->count++] = open;
+    }
+    open->lastUsed = ++cache->clock;
+    return open;
+}
+
+// Fonction pour respecter le budget mémoire du cache : les tableaux utilisés le moins
+// récemment sont fermés, puis les textures inutilisées du tableau affiché sont libérées
+void trimBoardCache(BoardCache *cache, OpenBoard *current) {
+    size_t total = 0;
+    for (int i = 0; i < cache->count; ++i) {
+        total += boardMemory(cache->boards[i]);
+    }
+    while (total > cache->budget && cache->count > 1) {
+        int oldest = -1;
+        for (int i = 0; i < cache->count; ++i) {
+            if (cache->boards[i] != current && (oldest < 0 || cache->boards[i]->lastUsed < cache->boards[oldest]->lastUsed)) {
+                oldest = i;
+            }
+        }
+        total -= boardMemory(cache->boards[oldest]);
+        closeBoard(cache->boards[oldest]);
+        cache->boards[oldest] = cache->boards[--cache->count];
+    }
+    if (total > cache->budget) {
+        trimTextCache(&current->textCache);
+    }
+}
+
+// Fonction pour fermer tous les tableaux du cache
+void freeBoardCache(BoardCache *cache) {
+    for (int i = 0; i < cache->count; ++i) {
+        closeBoard(cache->boards[i]);
+    }
+    cache->count = 0;
+}
+
+// Fonction pour afficher un texte avec fond coloré (avec le cache de textures du tableau s'il est fourni)
+void renderText(SDL_Renderer *rend, TTF_Font *font, TextCache *cache, const char *text, SDL_Rect rect, SDL_Color textColor, SDL_Color backgroundColor, bool isEditing, bool isDragging) {
+    // Dessiner le rectangle de fond
+    SDL_SetRenderDrawColor(rend, backgroundColor.r, backgroundColor.g, backgroundColor.b, backgroundColor.a);
+    SDL_RenderFillRect(rend, &rect);
+
+    SDL_SetRenderDrawColor(rend, textColor.r, textColor.g, textColor.b, textColor.a);
+    SDL_RenderDrawRect(rend, &rect);
+    renderCounters.drawCalls += 2;
+
+    // Copier la chaîne de texte dans la mémoire de travail de l'image, car strtok la modifie
+    ArenaMark mark = arenaMark(&frameArena);
+    char *textBuffer = arenaAlloc(&frameArena, MAX_TEXT_LENGTH);
+    if (textBuffer == NULL) {
+        return;
+    }
+    SDL_strlcpy(textBuffer, text, MAX_TEXT_LENGTH);
+
+    char *token = strtok(textBuffer, "\n");
+    int totalHeight = 0;
+
+    while (token != NULL) {
+        int text_width = 0, text_height = 0;
+        SDL_Texture *textTexture;
+        if (cache != NULL) {
+            // Le texte en cours de modification est rendu sans attendre les fils de rendu
+            textTexture = getTextTexture(cache, rend, font, token, textColor, rect.w - 20, isEditing, &text_width, &text_height);
+        } else {
+            SDL_Surface *textSurface = TTF_RenderText_Blended_Wrapped(font, token, textColor, rect.w - 20);
+            textTexture = SDL_CreateTextureFromSurface(rend, textSurface);
+            SDL_FreeSurface(textSurface);
+            SDL_QueryTexture(textTexture, NULL, NULL, &text_width, &text_height);
+            renderCounters.rasterized++;
+        }
+
+        SDL_Rect renderQuad = {rect.x + 10, rect.y + 5 + totalHeight, text_width, text_height};
+        if (textTexture != NULL) {
+            SDL_RenderCopy(rend, textTexture, NULL, &renderQuad);
+            renderCounters.drawCalls++;
+        } else if (cache != NULL && cache->raster != NULL) {
+            // Texte en cours de rendu : une barre de la taille approximative d'une ligne de texte
+            text_height = TTF_FontHeight(font);
+            text_width = SDL_min((int)strlen(token) * text_height / 2, rect.w - 20);
+            SDL_Rect placeholder = {renderQuad.x, renderQuad.y + text_height / 4, text_width, text_height / 2};
+            SDL_SetRenderDrawColor(rend, (Uint8)((textColor.r + 3 * backgroundColor.r) / 4), (Uint8)((textColor.g + 3 * backgroundColor.g) / 4),
+                                   (Uint8)((textColor.b + 3 * backgroundColor.b) / 4), backgroundColor.a);
+            SDL_RenderFillRect(rend, &placeholder);
+            renderCounters.drawCalls++;
+        }
+
+        if (cache == NULL) {
+            SDL_DestroyTexture(textTexture);
+        }
+
+        // Passer au jeton suivant
+        token = strtok(NULL, "\n");
+        if (token != NULL) {
+            // Ajouter la hauteur de la ligne à la hauteur totale
+            totalHeight += text_height;
+        }
+    }
+    arenaRelease(&frameArena, mark);
+}
+
+
+
+
+// Fonction pour obtenir la hauteur d'une ligne de texte
+int getTextLineHeight(TTF_Font *font) {
+    // Utiliser la police pour obtenir la hauteur de ligne
+    return TTF_FontHeight(font);
+}
+
+
+
+// Fonction pour trouver la zone de texte sous un point dans les tableaux affichés
+bool findTaskAt(Board **boards, int numBoards, SDL_Point point, int *boardIndex, int *lineIndex) {
+    for (int b = 0; b < numBoards; ++b) {
+        for (int i = 0; i < loadedTasks(boards[b]); ++i) {
+            if (isPointInRect(&point, &boards[b]->lines[i].rect) && isTaskShown(boards[b], i)) {
+                *boardIndex = b;
+                *lineIndex = i;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Fonction pour trouver la zone de texte en cours d'édition
+TextLine *findEditingTask(Board **boards, int numBoards, int *boardIndex, int *lineIndex) {
+    for (int b = 0; b < numBoards; ++b) {
+        for (int i = 0; i < loadedTasks(boards[b]); ++i) {
+            if (boards[b]->lines[i].isEditing) {
+                if (boardIndex != NULL) {
+                    *boardIndex = b;
+                }
+                if (lineIndex != NULL) {
+                    *lineIndex = i;
+                }
+                return &boards[b]->lines[i];
+            }
+        }
+    }
+    return NULL;
+}
+
+// Fonction pour ajouter une modification à l'étape en cours avec length octets de textes.
+// Les modifications annulées qui restaient à refaire sont oubliées. Renvoie NULL faute de
+// mémoire : l'historique est alors vidé, la modification ne pouvant plus être annulée.
+UndoRecord *addUndoRecord(UndoLog *log, int type, int board, int index, const char *text, int length) {
+    if (log->cursor < log->numRecords) {
+        log->textLength = log->records[log->cursor].text;
+        log->numRecords = log->cursor;
+    }
+    if (log->numRecords == log->capacity) {
+        int newCapacity = log->capacity > 0 ? log->capacity * 2 : 256;
+        UndoRecord *records = SDL_realloc(log->records, (size_t)newCapacity * sizeof(UndoRecord));
+        if (records == NULL) {
+            clearUndoLog(log);
+            return NULL;
+        }
+        log->records = records;
+        log->capacity = newCapacity;
+    }
+    if (log->textLength + (Uint32)length > log->textCapacity) {
+        Uint32 newCapacity = log->textCapacity > 0 ? log->textCapacity : 4096;
+        while (newCapacity < log->textLength + (Uint32)length) {
+            newCapacity *= 2;
+        }
+        char *texts = SDL_realloc(log->texts, newCapacity);
+        if (texts == NULL) {
+            clearUndoLog(log);
+            return NULL;
+        }
+        log->texts = texts;
+        log->textCapacity = newCapacity;
+    }
+    UndoRecord *record = &log->records[log->numRecords++];
+    memset(record, 0, sizeof(*record));
+    record->type = (Uint8)type;
+    record->flags = log->stepPending ? UNDO_STEP_START : 0;
+    record->board = (Uint8)board;
+    record->index = index;
+    record->text = log->textLength;
+    if (length > 0) {
+        memcpy(log->texts + log->textLength, text, (size_t)length);
+        log->textLength += (Uint32)length;
+    }
+    log->stepPending = false;
+    log->cursor = log->numRecords;
+    return record;
+}
+
+// Fonction pour enregistrer l'ajout (UNDO_INSERT) ou la suppression (UNDO_DELETE) d'une tâche
+void recordTask(UndoLog *log, int type, int board, int index, const TextLine *task) {
+    UndoRecord *record = addUndoRecord(log, type, board, index, task->text, (int)strlen(task->text) + 1);
+    if (record != NULL) {
+        record->column = (Uint8)task->column;
+        record->createdAt = task->createdAt;
+        record->doneAt = task->doneAt;
+        record->orderKey = task->orderKey;
+        record->x = (Sint16)task->rect.x;
+        record->y = (Sint16)task->rect.y;
+        record->h = (Sint16)task->rect.h;
+    }
+}
+
+// Fonction pour enregistrer le remplacement du texte d'une tâche : seul le passage qui
+// diffère entre les deux textes est gardé
+void recordEdit(UndoLog *log, int board, int index, const TextLine *line, const char *newText) {
+    const char *oldText = line->text;
+    int oldLength = (int)strlen(oldText);
+    int newLength = (int)strlen(newText);
+    int prefix = 0;
+    while (prefix < oldLength && prefix < newLength && oldText[prefix] == newText[prefix]) {
+        ++prefix;
+    }
+    int suffix = 0;
+    while (suffix < oldLength - prefix && suffix < newLength - prefix && oldText[oldLength - 1 - suffix] == newText[newLength - 1 - suffix]) {
+        ++suffix;
+    }
+    int removed = oldLength - prefix - suffix;
+    int inserted = newLength - prefix - suffix;
+    char diff[2 * MAX_TEXT_LENGTH];
+    memcpy(diff, oldText + prefix, (size_t)removed);
+    memcpy(diff + removed, newText + prefix, (size_t)inserted);
+
+    // Premier texte d'une tâche qui vient d'être ajoutée : annulé en même temps que l'ajout
+    const UndoRecord *last = log->numRecords > 0 && log->cursor == log->numRecords ? &log->records[log->numRecords - 1] : NULL;
+    if (log->stepPending && last != NULL && last->type == UNDO_INSERT && (last->flags & UNDO_STEP_START) && last->board == board && last->index == index) {
+        log->stepPending = false;
+    }
+    UndoRecord *record = addUndoRecord(log, UNDO_EDIT, board, index, diff, removed + inserted);
+    if (record != NULL) {
+        record->prefix = (Uint8)prefix;
+        record->oldLength = (Uint8)removed;
+        record->newLength = (Uint8)inserted;
+        record->x = (Sint16)line->rect.x;
+        record->y = (Sint16)line->rect.y;
+        record->h = (Sint16)line->rect.h;
+    }
+}
+
+// Fonction pour commencer une étape de l'historique (une action de l'utilisateur, même si
+// elle porte sur beaucoup de tâches). Si les tableaux ont été modifiés hors de l'historique
+// (boîte de réception, archivage), les numéros enregistrés ne sont plus valables et
+// l'historique est vidé.
+void beginUndoStep(OpenBoard *open) {
+    UndoLog *log = &open->history;
+    if (log->changes[0] != open->tasks.store.changes || log->changes[1] != open->done.store.changes) {
+        clearUndoLog(log);
+    }
+    log->stepPending = true;
+}
+
+// Fonction pour terminer une étape : les étapes les plus anciennes sont oubliées au-delà de
+// UNDO_MAX_MB, et une étape qui dépasse à elle seule ce budget ne peut pas être annulée
+void endUndoStep(OpenBoard *open) {
+    UndoLog *log = &open->history;
+    size_t limit = (size_t)UNDO_MAX_MB << 20;
+    if ((size_t)log->numRecords * sizeof(UndoRecord) + log->textLength > limit) {
+        int lastStep = log->numRecords - 1;
+        while (lastStep > 0 && !(log->records[lastStep].flags & UNDO_STEP_START)) {
+            --lastStep;
+        }
+        // Descendre à la moitié du budget pour ne pas recommencer à chaque étape
+        int first = 0;
+        while (first < lastStep && first < log->cursor &&
+               (size_t)(log->numRecords - first) * sizeof(UndoRecord) + log->textLength - log->records[first].text > limit / 2) {
+            do {
+                ++first;
+            } while (first < lastStep && !(log->records[first].flags & UNDO_STEP_START));
+        }
+        Uint32 dropped = log->records[first].text;
+        memmove(log->texts, log->texts + dropped, log->textLength - dropped);
+        log->textLength -= dropped;
+        memmove(log->records, log->records + first, (size_t)(log->numRecords - first) * sizeof(UndoRecord));
+        log->numRecords -= first;
+        log->cursor -= first;
+        for (int i = 0; i < log->numRecords; ++i) {
+            log->records[i].text -= dropped;
+        }
+        if ((size_t)log->numRecords * sizeof(UndoRecord) + log->textLength > limit) {
+            printf("Undo history cleared: the last change needs more than %d MB.\n", UNDO_MAX_MB);
+            clearUndoLog(log);
+        }
+    }
+    log->changes[0] = open->tasks.store.changes;
+    log->changes[1] = open->done.store.changes;
+}
+
+// Fonction pour annuler une modification de l'historique, ou la refaire (redo). Une tâche
+// remise dans son emplacement retrouve sa clé, donc sa place ; refaire un ajout ou un
+// déplacement la range après les autres, et sous sa colonne pour les tâches actives
+// (bottoms : voir placeAtColumnBottom).
+void applyUndoRecord(OpenBoard *open, const UndoRecord *record, bool redo, int bottoms[3]) {
+    Board *boards[2] = {&open->tasks, &open->done};
+    Board *board = boards[record->board];
+    const char *text = open->history.texts + record->text;
+    SDL_Rect rect = {record->x, record->y, TEXTBOX_WIDTH, record->h};
+    if (record->type == UNDO_INSERT || record->type == UNDO_DELETE) {
+        if ((record->type == UNDO_INSERT) == redo) {
+            TextLine task = {0};
+            SDL_strlcpy(task.text, text, MAX_TEXT_LENGTH);
+            task.rect = rect;
+            task.column = record->column;
+            task.createdAt = record->createdAt;
+            task.doneAt = record->doneAt;
+            task.orderKey = redo ? 0 : record->orderKey;
+            insertTask(board, record->index, &task);
+        } else {
+            deleteTask(board, record->index);
+        }
+    } else if (record->type == UNDO_MOVE && record->board == record->toBoard) {
+        setTaskColumn(board, record->index, redo ? record->newColumn : record->column);
+        TextLine *line = &board->lines[record->index - board->baseIndex];
+        if (redo) {
+            placeAtColumnBottom(board, line, bottoms);
+        } else {
+            line->rect = rect;
+        }
+    } else if (record->type == UNDO_MOVE) {
+        // Même chemin que transferTask : ajout dans le tableau d'arrivée, puis suppression
+        Board *from = redo ? board : boards[record->toBoard];
+        Board *to = redo ? boards[record->toBoard] : board;
+        int fromIndex = redo ? record->index : record->toIndex;
+        int toIndex = redo ? record->toIndex : record->index;
+        TextLine task = from->lines[fromIndex - from->baseIndex];
+        task.column = redo ? record->newColumn : record->column;
+        task.doneAt = redo ? record->newDoneAt : record->doneAt;
+        task.orderKey = redo ? 0 : record->orderKey;
+        task.rect = rect;
+        task.isEditing = false;
+        task.isDragging = false;
+        if (!insertTask(to, toIndex, &task)) {
+            return;
+        }
+        if (redo && to == &open->tasks) {
+            placeAtColumnBottom(to, &to->lines[toIndex - to->baseIndex], bottoms);
+        }
+        deleteTask(from, fromIndex);
+    } else {
+        // Le texte actuel contient le passage inséré (ou remplacé, pour refaire)
+        TextLine *line = &board->lines[record->index - board->baseIndex];
+        const char *inserted = redo ? text + record->oldLength : text;
+        int insertedLength = redo ? record->newLength : record->oldLength;
+        int removedLength = redo ? record->oldLength : record->newLength;
+        char buffer[MAX_TEXT_LENGTH];
+        SDL_snprintf(buffer, sizeof(buffer), "%.*s%.*s%s", (int)record->prefix, line->text, insertedLength, inserted,
+                     line->text + record->prefix + removedLength);
+        setTaskText(board, record->index, buffer);
+        if (!redo) {
+            line->rect = rect;
+        }
+    }
+}
+
+// Fonction pour annuler la dernière étape de l'historique, ou refaire la dernière étape
+// annulée (redo). Renvoie false s'il n'y a rien à annuler ou à refaire.
+bool undoStep(OpenBoard *open, bool redo) {
+    UndoLog *log = &open->history;
+    if (log->changes[0] != open->tasks.store.changes || log->changes[1] != open->done.store.changes) {
+        clearUndoLog(log);
+    }
+    if (redo ? log->cursor == log->numRecords : log->cursor == 0) {
+        return false;
+    }
+    int bottoms[3] = {-1, -1, -1};
+    beginIndexBatch(&open->taskIndex);
+    beginIndexBatch(&open->doneIndex);
+    if (redo) {
+        do {
+            applyUndoRecord(open, &log->records[log->cursor++], true, bottoms);
+        } while (log->cursor < log->numRecords && !(log->records[log->cursor].flags & UNDO_STEP_START));
+    } else {
+        do {
+            applyUndoRecord(open, &log->records[--log->cursor], false, bottoms);
+        } while (log->cursor > 0 && !(log->records[log->cursor].flags & UNDO_STEP_START));
+    }
+    endIndexBatch(&open->taskIndex);
+    endIndexBatch(&open->doneIndex);
+    log->changes[0] = open->tasks.store.changes;
+    log->changes[1] = open->done.store.changes;
+    return true;
+}
+
+// Fonction pour ajouter une tâche vide, en cours d'édition, dans la colonne "To Do"
+TextLine *addNewTask(OpenBoard *open) {
+    TextLine newLine = {0};
+    // Utilisez une valeur plus grande pour la hauteur initiale (par exemple, 40)
+    newLine.rect = (SDL_Rect){10, 40 + open->tasks.numLines * (40 + 5), TEXTBOX_WIDTH, 40};
+    newLine.isEditing = true;
+    newLine.column = 0; // La nouvelle tâche appartient à la colonne "To Do"
+    newLine.createdAt = (Uint32)time(NULL);
+    TextLine *line = appendTask(&open->tasks, &newLine);
+    if (line != NULL) {
+        recordTask(&open->history, UNDO_INSERT, 0, taskSlot(&open->tasks, line), line);
+    }
+    return line;
+}
+
+// Fonction pour supprimer une tâche du tableau affiché
+void removeTask(OpenBoard *open, Board *board, int index) {
+    recordTask(&open->history, UNDO_DELETE, board == &open->done, index, &board->lines[index - board->baseIndex]);
+    deleteTask(board, index);
+}
+
+// Fonction pour remplacer le texte d'une tâche du tableau affiché
+void editTask(OpenBoard *open, Board *board, int index, const char *text) {
+    const TextLine *line = &board->lines[index - board->baseIndex];
+    if (strcmp(line->text, text) != 0) {
+        recordEdit(&open->history, board == &open->done, index, line, text);
+    }
+    setTaskText(board, index, text);
+}
+
+// Fonction pour déplacer une tâche du tableau affiché dans une colonne, en la faisant passer
+// entre les tâches actives et la colonne "Done" si besoin. Renvoie la tâche à sa nouvelle place.
+TextLine *moveTask(OpenBoard *open, Board *from, int index, int column) {
+    TextLine *line = &from->lines[index - from->baseIndex];
+    if (column == line->column && (from == &open->done) == (column == DONE_COLUMN)) {
+        return line;
+    }
+    UndoRecord *record = addUndoRecord(&open->history, UNDO_MOVE, from == &open->done, index, NULL, 0);
+    if (record != NULL) {
+        record->column = (Uint8)line->column;
+        record->newColumn = (Uint8)column;
+        record->doneAt = line->doneAt;
+        record->orderKey = line->orderKey;
+        record->x = (Sint16)line->rect.x;
+        record->y = (Sint16)line->rect.y;
+        record->h = (Sint16)line->rect.h;
+    }
+    Board *to = from;
+    if (from == &open->tasks && column == DONE_COLUMN) {
+        to = &open->done;
+    } else if (from == &open->done && column != DONE_COLUMN) {
+        to = &open->tasks;
+    }
+    if (to != from) {
+        line = copyTask(from, index, to, column);
+        if (line == NULL) {
+            return NULL;
+        }
+        deleteTask(from, index);
+    } else {
+        setTaskColumn(from, index, column);
+    }
+    if (record != NULL) {
+        record->toBoard = to == &open->done;
+        record->toIndex = taskSlot(to, line);
+        record->newDoneAt = line->doneAt;
+    }
+    return line;
+}
+
+// Fonction pour passer dans la colonne "Done" (ou supprimer) toutes les tâches de la vue
+// filtrée, de la dernière à la première. Chaque tâche ne touche que sa page et ses
+// trigrammes. Renvoie le nombre de tâches traitées.
+int changeFilteredTasks(OpenBoard *open, bool remove) {
+    Board *boards[2] = {&open->tasks, &open->done};
+    int changed = 0;
+    beginIndexBatch(&open->taskIndex);
+    beginIndexBatch(&open->doneIndex);
+    for (int b = 0; b < (remove ? 2 : 1); ++b) {
+        TrigramIndex *index = boards[b]->search;
+        if (index == NULL || index->view.codeLength == 0) {
+            continue;
+        }
+        // La vue change à chaque tâche traitée : parcourir une copie
+        ArenaMark mark = arenaMark(&frameArena);
+        Uint32 *ids = arenaAlloc(&frameArena, ((size_t)tagBitmapCount(&index->filtered) + 1) * sizeof(Uint32));
+        if (ids == NULL) {
+            continue;
+        }
+        int count = tagBitmapIds(&index->filtered, ids);
+        for (int k = count - 1; k >= 0; --k) {
+            int id = (int)ids[k];
+            if (id < boards[b]->baseIndex || id >= boards[b]->numLines || boards[b]->lines[id - boards[b]->baseIndex].isFree) {
+                continue;
+            }
+            if (remove) {
+                removeTask(open, boards[b], id);
+            } else {
+                moveTask(open, boards[b], id, DONE_COLUMN);
+            }
+            changed++;
+        }
+        arenaRelease(&frameArena, mark);
+    }
+    endIndexBatch(&open->taskIndex);
+    endIndexBatch(&open->doneIndex);
+    return changed;
+}
+
+// Fonction pour résumer le contenu d'un tableau (textes, colonnes et dates, dans l'ordre
+// d'affichage : deux instances partagées ne rangent pas les tâches aux mêmes emplacements)
+Uint32 boardChecksum(Board *board) {
+    ArenaMark mark = arenaMark(&frameArena);
+    TextLine **sorted = arenaAlloc(&frameArena, ((size_t)loadedTasks(board) + 1) * sizeof(TextLine *));
+    int count = sorted != NULL ? sortTasksByOrder(board, sorted) : 0;
+    Uint32 sum = (Uint32)countTasks(board);
+    for (int k = 0; k < count; ++k) {
+        const TextLine *line = sorted[k];
+        sum = sum * 1000003u + crc32(line->text, strlen(line->text)) + (Uint32)line->column * 7u + line->doneAt * 13u + line->createdAt;
+    }
+    arenaRelease(&frameArena, mark);
+    return sum;
+}
+
+// Fonction pour mesurer l'historique sur numTasks tâches : une vue filtrée de 1 % des tâches
+// passée dans la colonne "Done", puis supprimée, chaque étape étant annulée et refaite en moins
+// de UNDO_BUDGET_MS pour 10 000 tâches (sinon le programme se termine en erreur). Refaire
+// une étape rejoue ses modifications : le même budget vaut donc pour l'étape elle-même.
+int runUndoBenchmark(int numTasks) {
+    static const char *words[] = {"fix", "write", "review", "deploy", "call", "email", "update", "design"};
+    OpenBoard *open = SDL_calloc(1, sizeof(OpenBoard));
+    if (open == NULL || !reserveTasks(&open->tasks, numTasks) || !reserveTasks(&open->done, numTasks / 4)) {
+        return 1;
+    }
+    open->done.appendOnly = true;
+    Uint32 now = (Uint32)time(NULL);
+    Uint32 seed = 12345;
+    for (int i = 0; i < numTasks; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        Board *board = i % 5 == 4 ? &open->done : &open->tasks;
+        TextLine *line = &board->lines[board->numLines++];
+        board->lastOrderKey = line->orderKey = board->lastOrderKey + ORDER_KEY_GAP;
+        line->column = board == &open->done ? DONE_COLUMN : (int)(seed >> 16) % 2;
+        line->createdAt = now - (seed >> 8) % (60 * 86400);
+        line->doneAt = board == &open->done ? line->createdAt : 0;
+        line->rect = (SDL_Rect){line->column * WIDTH / 3 + 10, 40, TEXTBOX_WIDTH, MIN_TEXTBOX_HEIGHT};
+        snprintf(line->text, MAX_TEXT_LENGTH, "%s %s %d%s", words[(seed >> 20) % 8], words[(seed >> 24) % 8], i, i % 100 == 0 ? " #bulk" : "");
+    }
+    buildSearchIndex(&open->tasks, &open->taskIndex);
+    buildSearchIndex(&open->done, &open->doneIndex);
+    Query query;
+    compileQuery("#bulk", &query);
+    applyQuery(&open->taskIndex, &query);
+    applyQuery(&open->doneIndex, &query);
+
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    bool ok = true;
+    for (int step = 0; step < 2; ++step) {
+        bool remove = step == 1;
+        Uint32 before[2] = {boardChecksum(&open->tasks), boardChecksum(&open->done)};
+        Uint64 start = SDL_GetPerformanceCounter();
+        beginUndoStep(open);
+        int changed = changeFilteredTasks(open, remove);
+        endUndoStep(open);
+        double doMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+        Uint32 after[2] = {boardChecksum(&open->tasks), boardChecksum(&open->done)};
+        size_t historyBytes = (size_t)open->history.numRecords * sizeof(UndoRecord) + open->history.textLength;
+
+        // Annuler et refaire plusieurs fois : le plus rapide des essais est comparé au budget
+        double undoMs = 0;
+        double redoMs = 0;
+        double indexMs = 0;
+        bool undone = true;
+        bool redone = true;
+        for (int run = 0; run < 3; ++run) {
+            start = SDL_GetPerformanceCounter();
+            undoStep(open, false);
+            double ms = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+            undoMs = run == 0 || ms < undoMs ? ms : undoMs;
+            undone = undone && boardChecksum(&open->tasks) == before[0] && boardChecksum(&open->done) == before[1];
+            start = SDL_GetPerformanceCounter();
+            undoStep(open, true);
+            ms = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+            redoMs = run == 0 || ms < redoMs ? ms : redoMs;
+            redone = redone && boardChecksum(&open->tasks) == after[0] && boardChecksum(&open->done) == after[1];
+            // Index rattrapé à chaque essai (mesuré pour le dernier : une annulation et un rétablissement)
+            start = SDL_GetPerformanceCounter();
+            flushPendingPostings(&open->taskIndex);
+            flushPendingPostings(&open->doneIndex);
+            indexMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+        }
+        double budgetMs = UNDO_BUDGET_MS * (changed / 10000.0 > 1.0 ? changed / 10000.0 : 1.0);
+        bool fast = undoMs <= budgetMs && redoMs <= budgetMs;
+        ok = ok && undone && redone && fast;
+        printf("%s %d filtered tasks in %.2f ms (%.1f KB of history): undo %.2f ms, redo %.2f ms, search index caught up in %.2f ms, %s, %s\n",
+               remove ? "Deleted" : "Moved to Done", changed, doMs, historyBytes / 1024.0, undoMs, redoMs, indexMs,
+               undone && redone ? "boards restored" : "BOARDS DIFFER", fast ? "within budget" : "OVER BUDGET");
+    }
+
+    // Étapes de saisie : chaque étape ne garde que le passage modifié
+    int edits = 10000;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int k = 0; k < edits; ++k) {
+        char text[MAX_TEXT_LENGTH];
+        int index = nextLiveTask(&open->tasks, (int)((Uint32)k * 2654435761u % (Uint32)open->tasks.numLines));
+        SDL_snprintf(text, sizeof(text), "%s!", open->tasks.lines[index].text);
+        beginUndoStep(open);
+        editTask(open, &open->tasks, index, text);
+        endUndoStep(open);
+    }
+    for (int k = 0; k < edits; ++k) {
+        undoStep(open, false);
+    }
+    double editMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+    printf("%d edits recorded and undone: %.2f us per edit, %d bytes of history per edit\n", edits, editMs * 1000.0 / edits,
+           (int)((open->history.numRecords * sizeof(UndoRecord) + open->history.textLength) / (size_t)edits));
+
+    freeUndoLog(&open->history);
+    freeTrigramIndex(&open->taskIndex);
+    freeTrigramIndex(&open->doneIndex);
+    freeBoard(&open->tasks);
+    freeBoard(&open->done);
+    SDL_free(open);
+    return ok ? 0 : 1;
+}
+
+// Fonction pour mesurer la chronologie d'un tableau de numTasks tâches enregistré tous les
+// quarts d'heure pendant un an, avec quelques modifications entre deux enregistrements :
+// taille du journal et des pages, puis temps pour afficher une version prise au hasard
+int runTimelineBenchmark(int numTasks) {
+    OpenBoard *open = SDL_calloc(1, sizeof(OpenBoard));
+    if (open == NULL || !setBoardFiles(&open->files, "bench_timeline") || !reserveTasks(&open->tasks, numTasks)) {
+        SDL_free(open);
+        return 1;
+    }
+    const char *paths[4] = {open->files.tasks, open->files.done, open->files.timelineLog, open->files.timelinePages};
+    for (int i = 0; i < 4; ++i) {
+        remove(paths[i]);
+    }
+    Board *tasks = &open->tasks;
+    Board *done = &open->done;
+    tasks->path = open->files.tasks;
+    done->path = open->files.done;
+    tasks->store.rewriteAll = done->store.rewriteAll = true;
+    tasks->store.quiet = done->store.quiet = true;
+    done->appendOnly = true;
+    Uint32 start = (Uint32)time(NULL) - 365 * 86400;
+    for (int i = 0; i < numTasks; ++i) {
+        TextLine line = {0};
+        line.column = i % 2;
+        line.createdAt = start;
+        SDL_snprintf(line.text, sizeof(line.text), "Task %d", i);
+        appendTask(tasks, &line);
+    }
+    openTimeline(open);
+
+    // Un an d'enregistrements : textes modifiés, tâches changées de colonne, terminées ou ajoutées
+    int numSaves = 365 * 96;
+    Uint32 checkTimes[32];
+    Uint32 checksums[32];
+    int numChecks = 0;
+    Uint32 seed = 2463534242u;
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 begin = SDL_GetPerformanceCounter();
+    bool ok = true;
+    for (int k = 0; k < numSaves && ok; ++k) {
+        Uint32 now = start + (Uint32)k * 900;
+        for (int m = 0; m < 3; ++m) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            int i = tasks->numLines > 0 ? nextLiveTask(tasks, (int)(seed % (Uint32)tasks->numLines)) : -1;
+            int action = i >= 0 ? (int)(seed >> 24) % 6 : 5;
+            if (action < 3) {
+                char text[MAX_TEXT_LENGTH];
+                SDL_snprintf(text, sizeof(text), "Task %d edited %d", i, k);
+                setTaskText(tasks, i, text);
+            } else if (action == 3) {
+                setTaskColumn(tasks, i, 1 - tasks->lines[i].column);
+            } else if (action == 4) {
+                ok = transferTask(tasks, i, done, DONE_COLUMN);
+            } else {
+                TextLine line = {0};
+                line.createdAt = now;
+                SDL_snprintf(line.text, sizeof(line.text), "New task %d", k);
+                ok = appendTask(tasks, &line) != NULL;
+            }
+        }
+        open->timeline[0].now = open->timeline[1].now = now;
+        ok = ok && saveDirtyPages(tasks) && saveDirtyPages(done);
+        if (k % (numSaves / 32) == 0 && numChecks < 32) {
+            checkTimes[numChecks] = now;
+            checksums[numChecks++] = boardChecksum(tasks);
+        }
+    }
+    double recordMs = (double)(SDL_GetPerformanceCounter() - begin) * 1000.0 / frequency;
+    Uint32 finalChecksum = boardChecksum(tasks);
+
+    TimelineView view;
+    begin = SDL_GetPerformanceCounter();
+    ok = ok && openTimelineView(&view, &open->files);
+    double openMs = (double)(SDL_GetPerformanceCounter() - begin) * 1000.0 / frequency;
+    if (ok) {
+        // Versions relevées pendant l'enregistrement, puis la dernière
+        int identical = boardChecksum(&view.boards[0]) == finalChecksum;
+        for (int c = 0; c < numChecks; ++c) {
+            seekTimeline(&view, findTimelineEntry(&view, checkTimes[c]));
+            identical += boardChecksum(&view.boards[0]) == checksums[c];
+        }
+
+        // Versions prises au hasard, puis versions précédentes une à une
+        int seeks = 1000;
+        double totalMs = 0;
+        double worstMs = 0;
+        for (int k = 0; k < seeks; ++k) {
+            int position = (int)((Uint32)k * 2654435761u % (Uint32)view.numEntries);
+            begin = SDL_GetPerformanceCounter();
+            seekTimeline(&view, position);
+            double ms = (double)(SDL_GetPerformanceCounter() - begin) * 1000.0 / frequency;
+            totalMs += ms;
+            worstMs = ms > worstMs ? ms : worstMs;
+        }
+        seekTimeline(&view, view.numEntries - 1);
+        begin = SDL_GetPerformanceCounter();
+        for (int k = 0; k < seeks; ++k) {
+            seekTimeline(&view, view.position - 1);
+        }
+        double stepMs = (double)(SDL_GetPerformanceCounter() - begin) * 1000.0 / frequency;
+
+        SDL_RWops *rw = SDL_RWFromFile(open->files.timelinePages, "rb");
+        Sint64 pagesBytes = rw != NULL ? SDL_RWsize(rw) : 0;
+        if (rw != NULL) {
+            SDL_RWclose(rw);
+        }
+        printf("%d saves over a year of a %d-task board recorded in %.0f ms: %d versions, log %.1f MB, pages %.1f MB\n", numSaves,
+               numTasks, recordMs, view.numEntries, view.logSize / 1048576.0, pagesBytes / 1048576.0);
+        printf("Timeline opened in %.2f ms, %d/%d checked versions identical to the board at that time\n", openMs, identical, numChecks + 1);
+        printf("Seeking to a random version: %.2f ms on average, %.2f ms at worst; previous version: %.3f ms\n", totalMs / seeks,
+               worstMs, stepMs / seeks);
+        closeTimelineView(&view);
+    }
+
+    freeTimelineWriter(&open->timeline[0]);
+    freeTimelineWriter(&open->timeline[1]);
+    freeBoard(tasks);
+    freeBoard(done);
+    SDL_free(open);
+    for (int i = 0; i < 4; ++i) {
+        remove(paths[i]);
+    }
+    return ok ? 0 : 1;
+}
+
+// Structure pour le résultat d'une instance du benchmark de partage, envoyé par un tube
+typedef struct {
+    int phase;             // 1 : modifications terminées, 2 : dernière étape reçue
+    Uint32 seq;
+    Uint32 checksums[2];
+    Uint32 batchesSent;
+    int resyncs;
+    int roundTrips;
+    double roundTripTotal;
+    double roundTripMax;
+    Uint64 entryBytes;
+    Uint64 entriesMerged;
+    Uint64 mergeTime;
+    int tombstonesCollected;
+    Uint64 bytesSent;
+} SyncBenchResult;
+
+// Fonction pour modifier au hasard un tableau partagé (benchmarks) : textes, colonnes, ajouts
+// à la fin ou au milieu, tâches terminées ou reprises, suppressions
+void randomBoardEdit(Board *tasks, Board *done, Uint32 *seed, int step) {
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+    int i = tasks->numLines > 0 ? nextLiveTask(tasks, (int)(*seed % (Uint32)tasks->numLines)) : -1;
+    int d = nextLiveTask(done, done->baseIndex + (int)(*seed % (Uint32)SDL_max(loadedTasks(done), 1)));
+    int action = i >= 0 ? (int)(*seed >> 24) % 10 : 4;
+    if (action < 3) {
+        char text[MAX_TEXT_LENGTH];
+        SDL_snprintf(text, sizeof(text), "Task %d edited %u", i, *seed % 1000u);
+        setTaskText(tasks, i, text);
+    } else if (action == 3) {
+        setTaskColumn(tasks, i, 1 - tasks->lines[i].column);
+    } else if (action == 4) {
+        TextLine line = {0};
+        line.createdAt = (Uint32)time(NULL);
+        line.rect = (SDL_Rect){10, 40, TEXTBOX_WIDTH, MIN_TEXTBOX_HEIGHT};
+        SDL_snprintf(line.text, sizeof(line.text), "New task %d", step);
+        appendTask(tasks, &line);
+    } else if (action == 5) {
+        transferTask(tasks, i, done, DONE_COLUMN);
+    } else if (action == 6 && d >= 0) {
+        transferTask(done, d, tasks, 0);
+    } else if (action == 7) {
+        deleteTask(tasks, i);
+    } else if (action == 8) {
+        // Tâche remise dans un emplacement libre, comme en annulant une suppression
+        TextLine line = {0};
+        line.createdAt = (Uint32)time(NULL);
+        line.rect = (SDL_Rect){10, 40, TEXTBOX_WIDTH, MIN_TEXTBOX_HEIGHT};
+        SDL_snprintf(line.text, sizeof(line.text), "Inserted task %d", step);
+        int slot = takeFreeSlot(tasks);
+        if (slot < 0 || !insertTask(tasks, slot, &line)) {
+            appendTask(tasks, &line);
+        }
+    } else if (action == 9 && d >= 0) {
+        deleteTask(done, d);
+    }
+}
+
+// Fonction pour simuler une image d'un utilisateur d'un tableau partagé (benchmark) : une
+// tâche est déplacée à la souris et, si change est vrai, le tableau est modifié au hasard
+void randomSyncEdit(OpenBoard *open, Uint32 *seed, int step, bool change) {
+    if (change) {
+        randomBoardEdit(&open->tasks, &open->done, seed, step);
+    }
+    int i = open->tasks.numLines > 0 ? nextLiveTask(&open->tasks, (int)((*seed >> 8) % (Uint32)open->tasks.numLines)) : -1;
+    if (i >= 0) {
+        const TextLine *line = &open->tasks.lines[i];
+        moveSyncDrag(&open->sync, line, (SDL_Point){(int)(*seed % WIDTH), (int)(*seed % HEIGHT)});
+    }
+}
+
+// Fonction pour relever les tâches et les statistiques d'une instance du benchmark de partage
+SyncBenchResult syncBenchResult(OpenBoard *open, int phase) {
+    const BoardSync *sync = &open->sync;
+    SyncBenchResult result = {phase, sync->seq, {boardChecksum(&open->tasks), boardChecksum(&open->done)}, sync->batchesSent,
+                              sync->resyncs, sync->roundTrips, sync->roundTripTotal, sync->roundTripMax, sync->entryBytes,
+                              sync->entriesMerged, sync->mergeTime, sync->tombstonesCollected, sync->bytesSent};
+    return result;
+}
+
+// Fonction pour mesurer le partage d'un tableau : numClients processus modifient chacun
+// numSteps fois le tableau bench_sync pendant que cette instance le sert et le modifie aussi.
+// Les images durent environ une milliseconde, avec une tâche déplacée à chaque image et une
+// modification toutes les framesPerChange images. Toutes les instances doivent finir avec les
+// mêmes tâches, qui doivent aussi être celles enregistrées.
+int runSyncBenchmark(int numClients, int numSteps) {
+#ifdef __linux__
+    numClients = SDL_clamp(numClients, 1, SYNC_MAX_PEERS);
+    int framesPerChange = 10;
+    BoardFiles files;
+    if (!setBoardFiles(&files, "bench_sync")) {
+        return 1;
+    }
+    const char *paths[8] = {files.tasks, files.done, files.archive, files.inbox, files.timelineLog, files.timelinePages, files.lock, files.socket};
+    for (int i = 0; i < 8; ++i) {
+        remove(paths[i]);
+    }
+    // Les clients sont lancés avant l'ouverture du tableau, pour ne pas hériter du verrou
+    int go[2];
+    int results[2];
+    if (pipe(go) != 0 || pipe(results) != 0) {
+        printf("Error creating pipes for the sync benchmark.\n");
+        return 1;
+    }
+    fflush(stdout);
+    pid_t children[SYNC_MAX_PEERS];
+    for (int c = 0; c < numClients; ++c) {
+        children[c] = fork();
+        if (children[c] == 0) {
+            // Les messages des instances sont comptés, pas affichés
+            close(go[1]);
+            close(results[0]);
+            freopen("/dev/null", "w", stdout);
+            Uint32 finalSeq;
+            if (read(go[0], &finalSeq, sizeof(finalSeq)) != sizeof(finalSeq)) {
+                _exit(1);
+            }
+            OpenBoard *open = openBoard(files.name, 0, true);
+            if (open == NULL || open->sync.role != SYNC_CLIENT) {
+                _exit(1);
+            }
+            Uint32 seed = 2463534242u + (Uint32)c * 7919u;
+            for (int k = 0; k < numSteps * framesPerChange; ++k) {
+                randomSyncEdit(open, &seed, k, k % framesPerChange == 0);
+                pollBoardSync(open, 0);
+                SDL_Delay(1);
+            }
+            Uint32 start = SDL_GetTicks();
+            while ((open->sync.batchesAcked != open->sync.batchesSent || open->sync.delta.length > 0) && SDL_GetTicks() - start < SYNC_LOAD_MS) {
+                pollBoardSync(open, 0);
+                SDL_Delay(1);
+            }
+            SyncBenchResult result = syncBenchResult(open, 1);
+            write(results[1], &result, sizeof(result));
+            // Attendre la dernière étape du serveur
+            if (read(go[0], &finalSeq, sizeof(finalSeq)) != sizeof(finalSeq)) {
+                _exit(1);
+            }
+            start = SDL_GetTicks();
+            while (open->sync.seq != finalSeq && open->sync.role == SYNC_CLIENT && SDL_GetTicks() - start < SYNC_LOAD_MS) {
+                pollBoardSync(open, 0);
+                SDL_Delay(1);
+            }
+            result = syncBenchResult(open, 2);
+            write(results[1], &result, sizeof(result));
+            closeBoard(open);
+            _exit(0);
+        }
+    }
+    close(go[0]);
+    close(results[1]);
+
+    OpenBoard *open = openBoard(files.name, 0, true);
+    bool ok = open != NULL && open->sync.role == SYNC_SERVER;
+    if (ok) {
+        for (int i = 0; i < 200; ++i) {
+            TextLine line = {0};
+            line.column = i % 2;
+            line.createdAt = (Uint32)time(NULL);
+            SDL_snprintf(line.text, sizeof(line.text), "Task %d", i);
+            appendTask(&open->tasks, &line);
+        }
+    }
+    Uint32 zero = 0;
+    for (int c = 0; c < numClients; ++c) {
+        write(go[1], &zero, sizeof(zero));
+    }
+
+    // Servir les clients en modifiant aussi le tableau, jusqu'à ce qu'ils aient tous fini
+    SyncBenchResult reports[SYNC_MAX_PEERS];
+    int finished = 0;
+    int converged = 0;
+    Uint32 seed = 88675123u;
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 begin = SDL_GetPerformanceCounter();
+    Uint64 lastChange = 0;
+    Uint32 start = SDL_GetTicks();
+    for (int k = 0; ok && converged < numClients; ++k) {
+        if (k < numSteps * framesPerChange) {
+            randomSyncEdit(open, &seed, k, k % framesPerChange == 0);
+        }
+        pollBoardSync(open, 0);
+        struct pollfd wait = {results[0], POLLIN, 0};
+        while (converged < numClients && poll(&wait, 1, 0) > 0) {
+            SyncBenchResult result;
+            if (read(results[0], &result, sizeof(result)) != sizeof(result)) {
+                ok = false;
+                break;
+            }
+            if (result.phase == 1 && ++finished == numClients) {
+                lastChange = SDL_GetPerformanceCounter();
+            } else if (result.phase == 2) {
+                reports[converged++] = result;
+            }
+        }
+        if (finished == numClients && k >= numSteps * framesPerChange && lastChange != 0) {
+            // Plus aucune modification : la dernière étape est celle que tous doivent recevoir
+            pollBoardSync(open, 0);
+            for (int c = 0; c < numClients; ++c) {
+                write(go[1], &open->sync.seq, sizeof(open->sync.seq));
+            }
+            finished = -1;
+        }
+        ok = ok && SDL_GetTicks() - start < 120000;
+        SDL_Delay(1);
+    }
+    double totalMs = (double)(SDL_GetPerformanceCounter() - begin) * 1000.0 / frequency;
+    double convergeMs = (double)(SDL_GetPerformanceCounter() - lastChange) * 1000.0 / frequency;
+    for (int c = 0; c < numClients; ++c) {
+        int status;
+        waitpid(children[c], &status, 0);
+        ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    close(go[1]);
+    close(results[0]);
+    if (open == NULL) {
+        return 1;
+    }
+
+    if (ok) {
+        SyncBenchResult server = syncBenchResult(open, 2);
+        int identical = 0;
+        Uint32 batchesSent = 0;
+        int resyncs = 0;
+        int roundTrips = 0;
+        double roundTripTotal = 0;
+        double roundTripMax = 0;
+        Uint64 entryBytes = server.entryBytes;
+        Uint64 entriesMerged = server.entriesMerged;
+        Uint64 mergeTime = server.mergeTime;
+        int tombstonesCollected = server.tombstonesCollected;
+        Uint64 bytesSent = server.bytesSent;
+        for (int c = 0; c < converged; ++c) {
+            identical += reports[c].seq == server.seq && reports[c].checksums[0] == server.checksums[0] &&
+                         reports[c].checksums[1] == server.checksums[1];
+            batchesSent += reports[c].batchesSent;
+            resyncs += reports[c].resyncs;
+            roundTrips += reports[c].roundTrips;
+            roundTripTotal += reports[c].roundTripTotal;
+            roundTripMax = reports[c].roundTripMax > roundTripMax ? reports[c].roundTripMax : roundTripMax;
+            entryBytes += reports[c].entryBytes;
+            entriesMerged += reports[c].entriesMerged;
+            mergeTime += reports[c].mergeTime;
+            tombstonesCollected += reports[c].tombstonesCollected;
+            bytesSent += reports[c].bytesSent;
+        }
+
+        // Le tableau enregistré à la fermeture doit être celui que les instances ont en mémoire
+        closeBoard(open);
+        open = openBoard(files.name, 0, true);
+        bool saved = open != NULL && (open->done.baseIndex == 0 ||
+                                      loadEarlierPages(&open->done, open->done.baseIndex / RECORDS_PER_PAGE));
+        saved = saved && boardChecksum(&open->tasks) == server.checksums[0] && boardChecksum(&open->done) == server.checksums[1];
+
+        printf("%d instances made %d changes each to a shared board in %.0f ms: %u steps, %u batches sent by clients, %d reloads\n",
+               numClients + 1, numSteps, totalMs, server.seq, batchesSent, resyncs);
+        printf("Client batch merged by the server in %.3f ms on average, %.3f ms at worst; %.1f bytes of entries per batch, %.0f bytes sent per step\n",
+               roundTrips > 0 ? roundTripTotal / roundTrips : 0.0, roundTripMax, batchesSent + server.batchesSent > 0 ? (double)entryBytes / (batchesSent + server.batchesSent) : 0.0,
+               server.seq > 0 ? (double)bytesSent / server.seq : 0.0);
+        printf("%llu entries merged at %.0f entries/s, %d deletions forgotten once every instance had them\n", (unsigned long long)entriesMerged,
+               mergeTime > 0 ? entriesMerged * (double)frequency / mergeTime : 0.0, tombstonesCollected);
+        printf("Converged %.1f ms after the last change: %d/%d clients identical to the server, saved board %s\n", convergeMs,
+               identical, numClients, saved ? "identical" : "DIFFERENT");
+        ok = identical == numClients && saved;
+    } else {
+        printf("Sync benchmark failed: a client did not finish.\n");
+    }
+    if (open != NULL) {
+        closeBoard(open);
+    }
+    for (int i = 0; i < 8; ++i) {
+        remove(paths[i]);
+    }
+    return ok ? 0 : 1;
+#else
+    (void)numClients;
+    (void)numSteps;
+    printf("Sharing boards between instances is only supported on Linux.\n");
+    return 1;
+#endif
+}
+
+// Structure pour une instance simulée du test de fusion : ses deux tableaux et leur partage
+typedef struct {
+    Board tasks;
+    Board done;
+    BoardSync sync;
+    Uint32 seed;
+} CrdtReplica;
+
+// Structure pour un lot d'entrées du test de fusion, dans le tampon des lots de la ronde
+typedef struct {
+    int origin;
+    size_t offset;
+    size_t length;
+} CrdtBatch;
+
+// Fonction pour résumer les tâches d'une instance du test de fusion dans l'ordre de leurs
+// clés (chaque instance a ses propres emplacements), identifiants et clés compris
+Uint32 crdtChecksum(CrdtReplica *replica) {
+    Board *boards[2] = {&replica->tasks, &replica->done};
+    Uint32 sum = 0;
+    for (int b = 0; b < 2; ++b) {
+        TextLine **sorted = SDL_malloc(((size_t)loadedTasks(boards[b]) + 1) * sizeof(TextLine *));
+        if (sorted == NULL) {
+            return 0;
+        }
+        int count = sortTasksByOrder(boards[b], sorted);
+        sum = sum * 31u + (Uint32)count;
+        for (int k = 0; k < count; ++k) {
+            const TextLine *line = sorted[k];
+            sum = sum * 1000003u + crc32(line->text, strlen(line->text)) + (Uint32)line->column * 7u + line->doneAt * 13u + line->createdAt;
+            sum = sum * 1000003u + (Uint32)line->id + (Uint32)(line->id >> 32) * 7u + (Uint32)line->orderKey;
+        }
+        SDL_free(sorted);
+    }
+    return sum;
+}
+
+// Fonction pour tester la fusion des modifications concurrentes : numReplicas instances en
+// mémoire, sans serveur, modifient chacune le tableau numOps fois par rondes de
+// CRDT_OPS_PER_ROUND modifications. Chaque modification part en un lot, et chaque instance
+// reçoit les lots des autres dans un ordre tiré au hasard. À la fin de chaque ronde, toutes
+// les instances doivent avoir les mêmes tâches dans le même ordre, et les suppressions que
+// toutes ont reçues sont oubliées.
+#define CRDT_OPS_PER_ROUND 16
+int runCrdtBenchmark(int numReplicas, int numOps) {
+    numReplicas = SDL_clamp(numReplicas, 2, 64);
+    numOps = SDL_max(numOps, CRDT_OPS_PER_ROUND);
+    int numRounds = numOps / CRDT_OPS_PER_ROUND;
+    CrdtReplica *replicas = SDL_calloc((size_t)numReplicas, sizeof(CrdtReplica));
+    CrdtBatch *batches = SDL_malloc((size_t)numReplicas * (CRDT_OPS_PER_ROUND + 1) * sizeof(CrdtBatch));
+    int *order = SDL_malloc((size_t)numReplicas * (CRDT_OPS_PER_ROUND + 1) * sizeof(int));
+    SyncBuffer round = {0};
+    if (replicas == NULL || batches == NULL || order == NULL) {
+        printf("Error allocating memory for the merge benchmark.\n");
+        SDL_free(replicas);
+        SDL_free(batches);
+        SDL_free(order);
+        return 1;
+    }
+    for (int r = 0; r < numReplicas; ++r) {
+        CrdtReplica *replica = &replicas[r];
+        replica->sync.boards[0] = &replica->tasks;
+        replica->sync.boards[1] = &replica->done;
+        replica->sync.replica = (Uint32)r;
+        replica->sync.tracking = true;
+        replica->tasks.sync = &replica->sync;
+        replica->done.sync = &replica->sync;
+        replica->tasks.store.quiet = replica->done.store.quiet = true;
+        replica->done.appendOnly = true;
+        replica->seed = 2463534242u + (Uint32)r * 7919u;
+    }
+
+    // Tâches de départ créées par la première instance, reçues par les autres
+    int bottoms[3] = {-1, -1, -1};
+    for (int i = 0; i < 200; ++i) {
+        TextLine line = {0};
+        line.column = i % 2;
+        line.createdAt = (Uint32)time(NULL);
+        SDL_snprintf(line.text, sizeof(line.text), "Task %d", i);
+        appendTask(&replicas[0].tasks, &line);
+    }
+    for (int r = 1; r < numReplicas; ++r) {
+        mergeSyncEntries(&replicas[r].sync, replicas[0].sync.delta.data, replicas[0].sync.delta.length, 1, NULL, bottoms);
+    }
+    replicas[0].sync.delta.length = 0;
+
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 entries = 0;
+    Uint64 bytes = 0;
+    Uint64 mergeTime = 0;
+    int identicalRounds = 0;
+    int collected = 0;
+    bool ok = true;
+    Uint32 shuffle = 88675123u;
+    for (int k = 0; ok && k < numRounds; ++k) {
+        Uint32 seq = (Uint32)k + 2;
+        int numBatches = 0;
+        round.length = 0;
+        for (int r = 0; r < numReplicas; ++r) {
+            CrdtReplica *replica = &replicas[r];
+            for (int op = 0; op < CRDT_OPS_PER_ROUND; ++op) {
+                randomBoardEdit(&replica->tasks, &replica->done, &replica->seed, k * CRDT_OPS_PER_ROUND + op);
+                if (replica->sync.delta.length == 0) {
+                    continue;
+                }
+                batches[numBatches++] = (CrdtBatch){r, round.length, replica->sync.delta.length};
+                ok = ok && appendSyncBytes(&round, replica->sync.delta.data, replica->sync.delta.length);
+                replica->sync.delta.length = 0;
+                replica->sync.batchesSent++;
+            }
+            sequenceSyncTombstones(&replica->sync, replica->sync.batchesSent, seq);
+        }
+        bytes += round.length;
+
+        // Chaque instance reçoit les lots des autres dans son propre ordre
+        for (int r = 0; ok && r < numReplicas; ++r) {
+            CrdtReplica *replica = &replicas[r];
+            for (int b = 0; b < numBatches; ++b) {
+                int other = (int)((shuffle = shuffle * 1664525u + 1013904223u) >> 8) % (b + 1);
+                order[b] = order[other];
+                order[other] = b;
+            }
+            Uint64 before = replica->sync.entriesMerged;
+            Uint64 start = SDL_GetPerformanceCounter();
+            for (int b = 0; ok && b < numBatches; ++b) {
+                const CrdtBatch *batch = &batches[order[b]];
+                if (batch->origin != r) {
+                    int batchBottoms[3] = {-1, -1, -1};
+                    ok = mergeSyncEntries(&replica->sync, round.data + batch->offset, batch->length, seq, NULL, batchBottoms) &&
+                         !replica->sync.failed;
+                }
+            }
+            mergeTime += SDL_GetPerformanceCounter() - start;
+            entries += replica->sync.entriesMerged - before;
+        }
+
+        // Toutes les instances ont reçu la ronde : mêmes tâches, et suppressions oubliées
+        Uint32 expected = crdtChecksum(&replicas[0]);
+        bool identical = true;
+        for (int r = 1; r < numReplicas; ++r) {
+            identical = identical && crdtChecksum(&replicas[r]) == expected;
+        }
+        identicalRounds += identical;
+        for (int r = 0; r < numReplicas; ++r) {
+            collected += collectSyncTombstones(&replicas[r].sync, seq);
+        }
+        if (!identical) {
+            printf("Round %d: the replicas diverged.\n", k + 1);
+            ok = false;
+        }
+    }
+
+    int left = 0;
+    for (int r = 0; r < numReplicas; ++r) {
+        left += (int)replicas[r].sync.tombstones.count;
+    }
+    double mergeMs = (double)mergeTime * 1000.0 / frequency;
+    printf("%d replicas made %d changes each in %d rounds: %d tasks active, %d done at the end\n", numReplicas,
+           numRounds * CRDT_OPS_PER_ROUND, numRounds, replicas[0].tasks.numLines, replicas[0].done.numLines);
+    printf("%llu entries merged in %.1f ms (%.0f entries/s), %.1f bytes per entry\n", (unsigned long long)entries, mergeMs,
+           mergeMs > 0 ? entries * 1000.0 / mergeMs : 0.0, entries > 0 ? (double)bytes * (numReplicas - 1) / entries : 0.0);
+    printf("Converged after %d/%d rounds in any delivery order; %d deletions forgotten, %d left\n", identicalRounds, numRounds,
+           collected, left);
+
+    for (int r = 0; r < numReplicas; ++r) {
+        resetSyncTracking(&replicas[r].sync);
+        SDL_free(replicas[r].sync.delta.data);
+        SDL_free(replicas[r].sync.unsequenced.data);
+        freeBoard(&replicas[r].tasks);
+        freeBoard(&replicas[r].done);
+    }
+    SDL_free(round.data);
+    SDL_free(replicas);
+    SDL_free(batches);
+    SDL_free(order);
+    return ok && identicalRounds == numRounds ? 0 : 1;
+}
+
+// Fonction pour exécuter une action de la palette sur le tableau affiché (sauf le changement
+// de tableau, fait par l'appelant). Déplacer et supprimer agissent sur la tâche sélectionnée,
+// ou sur toute la vue filtrée en une seule étape de l'historique.
+void runPaletteAction(const PaletteResult *result, OpenBoard *open) {
+    Board *boards[2] = {&open->tasks, &open->done};
+    int b, i;
+    TextLine *selected = findEditingTask(boards, 2, &b, &i);
+    beginUndoStep(open);
+    if (result->action == PALETTE_ADD) {
+        addNewTask(open);
+    } else if (result->action == PALETTE_UNDO || result->action == PALETTE_REDO) {
+        undoStep(open, result->action == PALETTE_REDO);
+    } else if (result->action == PALETTE_DONE_VIEW || result->action == PALETTE_DELETE_VIEW) {
+        changeFilteredTasks(open, result->action == PALETTE_DELETE_VIEW);
+    } else if (result->action >= PALETTE_MOVE_TODO && result->action <= PALETTE_MOVE_DONE && selected != NULL) {
+        TextLine *line = moveTask(open, boards[b], boards[b]->baseIndex + i, result->action - PALETTE_MOVE_TODO);
+        if (line != NULL && line->column != DONE_COLUMN) {
+            int bottoms[3] = {-1, -1, -1};
+            placeAtColumnBottom(&open->tasks, line, bottoms);
+        }
+    } else if (result->action == PALETTE_DELETE && selected != NULL) {
+        removeTask(open, boards[b], boards[b]->baseIndex + i);
+    } else if (result->action == PALETTE_TASK) {
+        // Sélectionner la tâche, en faisant défiler la colonne "Done" jusqu'à elle
+        for (int k = 0; k < 2; ++k) {
+            for (int j = 0; j < loadedTasks(boards[k]); ++j) {
+                boards[k]->lines[j].isEditing = false;
+                boards[k]->lines[j].isDragging = false;
+            }
+        }
+        Board *board = boards[result->board];
+        board->lines[result->id - board->baseIndex].isEditing = true;
+        if (board == &open->done) {
+            int above = 0;
+            for (int j = result->id - board->baseIndex + 1; j < loadedTasks(board); ++j) {
+                above += !board->lines[j].isFree;
+            }
+            open->doneScroll = above * (MIN_TEXTBOX_HEIGHT + 5) - HEIGHT / 2;
+        }
+    }
+    endUndoStep(open);
+    scrollDoneColumn(&open->done, &open->doneScroll);
+}
+
+// Fonction pour déplacer la sélection de la palette en gardant la ligne choisie visible
+void movePaletteSelection(Palette *palette, int delta) {
+    palette->selected += delta;
+    palette->selected = palette->selected >= palette->numResults ? palette->numResults - 1 : palette->selected;
+    palette->selected = palette->selected < 0 ? 0 : palette->selected;
+    if (palette->selected < palette->scroll) {
+        palette->scroll = palette->selected;
+    } else if (palette->selected >= palette->scroll + PALETTE_VISIBLE_ROWS) {
+        palette->scroll = palette->selected - PALETTE_VISIBLE_ROWS + 1;
+    }
+}
+
+// Fonction pour initialiser les trois colonnes affichées
+void initColumns(Column columns[3]) {
+    // Définir les couleurs pour chaque colonne
+    SDL_Color colorToDo = {221, 221, 221, 255}; // Rouge
+    SDL_Color colorInProgress = {128, 234, 250, 255}; // Vert
+    SDL_Color colorDone = {175, 239, 196, 255}; // Bleu
+
+    // Initialiser les colonnes avec leurs couleurs
+    columns[0].rect = (SDL_Rect){0, 0, WIDTH / 3, HEIGHT};
+    columns[0].numLines = 0;
+    strcpy(columns[0].title, "To Do");
+    columns[0].color = colorToDo;
+
+    columns[1].rect = (SDL_Rect){WIDTH / 3, 0, WIDTH / 3, HEIGHT};
+    columns[1].numLines = 0;
+    strcpy(columns[1].title, "In Progress");
+    columns[1].color = colorInProgress;
+
+    columns[2].rect = (SDL_Rect){2 * WIDTH / 3, 0, WIDTH / 3, HEIGHT};
+    columns[2].numLines = 0;
+    strcpy(columns[2].title, "Done");
+    columns[2].color = colorDone;
+}
+
+// Fonction pour effacer l'écran et dessiner un tableau : colonnes, bouton "Add" et tâches
+void renderBoard(SDL_Renderer *rend, TTF_Font *font, const Column columns[3], Board *const boards[2], TextCache *cache) {
+    Uint64 zone = beginTraceZone();
+    // Effacer l'écran
+    SDL_SetRenderDrawColor(rend, 255, 255, 255, 255);
+    SDL_RenderClear(rend);
+
+    // Dessiner les colonnes
+    for (int i = 0; i < 3; ++i) {
+        SDL_SetRenderDrawColor(rend, columns[i].color.r, columns[i].color.g, columns[i].color.b, columns[i].color.a);
+        SDL_RenderFillRect(rend, &(columns[i].rect));
+
+        // Libellés gardés dans le cache : une image sans changement ne rend aucun texte
+        SDL_Color textColor = {255, 255, 255, 255};
+        int titleWidth, titleHeight;
+        SDL_Texture *textTexture = getLabelTexture(cache, rend, font, columns[i].title, textColor, &titleWidth, &titleHeight);
+
+        SDL_Rect renderQuad = {columns[i].rect.x + WIDTH / 6 - titleWidth / 2, 0, titleWidth, titleHeight};
+        SDL_RenderCopy(rend, textTexture, NULL, &renderQuad);
+        renderCounters.drawCalls += 2;
+        if (cache == NULL) {
+            SDL_DestroyTexture(textTexture);
+        }
+    }
+
+    // Dessiner le bouton "Add"
+    // Dimensions du bouton "Add"
+    int buttonWidth = BUTTON_WIDTH;
+    int buttonHeight = BUTTON_HEIGHT;
+
+    // Position du bouton en bas à droite
+    int buttonX = WIDTH - buttonWidth;
+    int buttonY = HEIGHT - buttonHeight;
+
+    // Dessine le bouton "Add"
+    SDL_SetRenderDrawColor(rend, 0, 0, 0, 255);
+    SDL_Rect rect = {buttonX, buttonY, buttonWidth, buttonHeight};
+    SDL_RenderFillRect(rend, &rect);
+
+    // Dessine le texte au centre du bouton "Add"
+    SDL_Color textColor = {255, 255, 255, 255}; // Couleur du texte (blanc)
+    int textWidth, textHeight;
+    SDL_Texture *textButton = getLabelTexture(cache, rend, font, "Add", textColor, &textWidth, &textHeight);
+
+    SDL_Rect textRect = {buttonX + (buttonWidth - textWidth) / 2, buttonY + (buttonHeight - textHeight) / 2, textWidth, textHeight};
+    SDL_RenderCopy(rend, textButton, NULL, &textRect);
+
+    // Libère la texture du texte si elle n'est pas gardée en cache
+    if (cache == NULL) {
+        SDL_DestroyTexture(textButton);
+    }
+
+    // Dessiner le texte "Right-click to delete" à côté du bouton "Add"
+    SDL_Color deleteTextColor = {255, 255, 255, 255};
+    int deleteWidth, deleteHeight;
+    SDL_Texture *textDelete = getLabelTexture(cache, rend, font, "Right click to delete - Enter to save the task", deleteTextColor, &deleteWidth, &deleteHeight);
+
+    SDL_Rect renderQuadDelete = {WIDTH - BUTTON_WIDTH - deleteWidth - 10, HEIGHT - BUTTON_HEIGHT, deleteWidth, deleteHeight};
+    SDL_RenderCopy(rend, textDelete, NULL, &renderQuadDelete);
+    // Effacement, bouton, son texte et l'aide
+    renderCounters.drawCalls += 4;
+    if (cache == NULL) {
+        SDL_DestroyTexture(textDelete);
+    }
+
+    // Dessiner les zones de texte (celles hors de l'écran ou hors de la vue filtrée sont ignorées)
+    for (int b = 0; b < 2; ++b) {
+        for (int i = 0; i < loadedTasks(boards[b]); ++i) {
+            TextLine *line = &boards[b]->lines[i];
+            if (line->rect.y + line->rect.h < 0 || line->rect.y > HEIGHT || !isTaskShown(boards[b], i)) {
+                continue;
+            }
+            SDL_Color color = {0, 0, 0, 255}; // Couleur du texte (noir)
+            SDL_Color backgroundColor = {255, 255, 255, 255};
+            if (isSearchMatch(boards[b]->search, boards[b], boards[b]->baseIndex + i)) {
+                backgroundColor = (SDL_Color){255, 236, 128, 255}; // Tâche trouvée par la recherche
+            }
+            renderText(rend, font, cache, line->text, line->rect, color, backgroundColor, line->isEditing, line->isDragging);
+
+            if (line->isEditing) {
+                SDL_Rect inputRect = {line->rect.x, line->rect.y, line->rect.w, line->rect.h};
+                renderText(rend, font, cache, line->inputText, inputRect, color, backgroundColor, line->isEditing, line->isDragging);
+            }
+        }
+    }
+    endTraceZone(zone, "render board");
+}
+
+// Structure pour la latence des saisies : délai entre l'horodatage SDL d'un événement et le
+// retour de SDL_RenderPresent pour la première image qui en tient compte (attente de la fin de
+// l'image en cours et de la pause de la boucle comprises, ainsi que l'attente de la
+// synchronisation verticale)
+typedef struct {
+    Uint32 samples[LATENCY_TYPES][LATENCY_SAMPLES];  // En millisecondes, les plus anciennes écrasées
+    int numSamples[LATENCY_TYPES];
+    Uint32 pending[LATENCY_TYPES][LATENCY_PENDING];  // Horodatages des saisies pas encore affichées
+    int numPending[LATENCY_TYPES];
+} InputLatency;
+
+// Fonction pour noter une saisie traitée pendant l'image en cours (les autres événements sont
+// ignorés). Au-delà de LATENCY_PENDING saisies d'un type dans une image, seules les plus
+// anciennes, qui ont attendu le plus longtemps, sont gardées.
+void noteInputLatency(InputLatency *latency, const SDL_Event *event) {
+    int type = event->type == SDL_TEXTINPUT ? LATENCY_TEXT : event->type == SDL_MOUSEMOTION ? LATENCY_MOTION : -1;
+    if (type >= 0 && latency->numPending[type] < LATENCY_PENDING) {
+        latency->pending[type][latency->numPending[type]++] = event->common.timestamp;
+    }
+}
+
+// Fonction pour mesurer la latence des saisies notées, juste après l'affichage de l'image
+void recordPresentedInput(InputLatency *latency) {
+    Uint32 now = SDL_GetTicks();
+    for (int t = 0; t < LATENCY_TYPES; ++t) {
+        for (int i = 0; i < latency->numPending[t]; ++i) {
+            latency->samples[t][latency->numSamples[t]++ % LATENCY_SAMPLES] = now - latency->pending[t][i];
+        }
+        latency->numPending[t] = 0;
+    }
+}
+
+// Fonction pour comparer deux latences (tri des mesures)
+int compareLatencies(const void *a, const void *b) {
+    Uint32 x = *(const Uint32 *)a;
+    Uint32 y = *(const Uint32 *)b;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+// Fonction pour calculer les 50e, 95e et 99e centiles des dernières latences d'un type de
+// saisie. Renvoie le nombre de mesures utilisées (0 : aucune saisie de ce type).
+int getInputLatency(const InputLatency *latency, int type, Uint32 percentiles[3]) {
+    Uint32 sorted[LATENCY_SAMPLES];
+    int count = SDL_min(latency->numSamples[type], LATENCY_SAMPLES);
+    memcpy(sorted, latency->samples[type], sizeof(Uint32) * (size_t)count);
+    SDL_qsort(sorted, (size_t)count, sizeof(Uint32), compareLatencies);
+    percentiles[0] = count > 0 ? sorted[count / 2] : 0;
+    percentiles[1] = count > 0 ? sorted[(count * 95) / 100] : 0;
+    percentiles[2] = count > 0 ? sorted[(count * 99) / 100] : 0;
+    return count;
+}
+
+// Fonction pour afficher les latences des saisies (à la sortie, --latency-stats)
+void printInputLatency(const InputLatency *latency, bool lowLatency) {
+    static const char *types[LATENCY_TYPES] = {"text input", "mouse motion"};
+    printf("Input latency%s:\n", lowLatency ? " (low latency mode)" : "");
+    for (int t = 0; t < LATENCY_TYPES; ++t) {
+        Uint32 p[3];
+        int count = getInputLatency(latency, t, p);
+        printf("  %-12s p50 %u ms, p95 %u ms, p99 %u ms (last %d of %d events)\n", types[t], (unsigned)p[0], (unsigned)p[1],
+               (unsigned)p[2], count, latency->numSamples[t]);
+    }
+}
+
+// Fonction pour comparer deux durées (tri des temps d'image)
+int compareFrameTimes(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+// Fonction pour créer le tableau de numTasks tâches de la mesure du rendu : quatre tâches sur
+// cinq actives, la cinquième dans la colonne "Done". Renvoie NULL si la mémoire manque.
+OpenBoard *buildRenderBenchBoard(int numTasks) {
+    static const char *words[] = {"fix", "write", "review", "deploy", "call", "email", "update", "design"};
+    OpenBoard *open = SDL_calloc(1, sizeof(OpenBoard));
+    if (open == NULL) {
+        return NULL;
+    }
+    if (!reserveTasks(&open->tasks, numTasks) || !reserveTasks(&open->done, numTasks / 5 + 1)) {
+        freeBoard(&open->tasks);
+        freeBoard(&open->done);
+        SDL_free(open);
+        return NULL;
+    }
+    Uint32 seed = 12345;
+    for (int i = 0; i < numTasks; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        Board *board = i % 5 == 4 ? &open->done : &open->tasks;
+        TextLine *line = &board->lines[board->numLines++];
+        board->lastOrderKey = line->orderKey = board->lastOrderKey + ORDER_KEY_GAP;
+        line->column = board == &open->done ? DONE_COLUMN : (int)(seed >> 16) % 2;
+        line->doneAt = board == &open->done ? 1 : 0;
+        snprintf(line->text, MAX_TEXT_LENGTH, "%s %s %d", words[(seed >> 20) % 8], words[(seed >> 24) % 8], i);
+    }
+    layoutTasks(&open->tasks);
+    scrollDoneColumn(&open->done, &open->doneScroll);
+    return open;
+}
+
+// Fonction pour obtenir le nombre de tâches du tableau suivant de la mesure du rendu : 10 fois
+// plus, limité à maxTasks (sans dépasser la capacité d'un int), puis 0 une fois maxTasks mesuré
+int nextRenderBenchSize(int numTasks, int maxTasks) {
+    if (numTasks >= maxTasks) {
+        return 0;
+    }
+    return numTasks > maxTasks / 10 ? maxTasks : numTasks * 10;
+}
+
+// Fonction pour mesurer le temps de rendu d'une image sans écran (pilote vidéo "dummy" et
+// rendu logiciel dans une surface), sur des tableaux de 100 à maxTasks tâches et quatre
+// scénarios : tableau immobile, défilement de la colonne "Done", tâche déplacée à la souris
+// et saisie dans une tâche. Les résultats sont écrits en JSON sur la sortie standard.
+int runRenderBenchmark(int maxTasks, int numFrames, const char *fontPath) {
+    static const char *scenarios[RENDER_BENCH_SCENARIOS] = {"idle", "scrolling", "dragging", "typing"};
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    if (SDL_Init(SDL_INIT_VIDEO) != 0 || TTF_Init() != 0) {
+        printf("Error initializing SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    TTF_Font *font = TTF_OpenFont(fontPath, FONT_SIZE);
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, WIDTH, HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *rend = target != NULL ? SDL_CreateSoftwareRenderer(target) : NULL;
+    double *times = SDL_malloc((size_t)(numFrames > 0 ? numFrames : 1) * sizeof(double));
+    // En cas d'erreur, rien n'est mesuré mais tout passe par la même libération à la fin
+    bool ok = font != NULL && rend != NULL && times != NULL && numFrames > 0;
+    if (!ok) {
+        printf("Error preparing the render benchmark: %s\n", font == NULL ? TTF_GetError() : SDL_GetError());
+    }
+    TextRaster *raster = ok ? createTextRaster(fontPath, FONT_SIZE) : NULL;
+    Column columns[3];
+    initColumns(columns);
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    int rowHeight = MIN_TEXTBOX_HEIGHT + 5;
+    InputLatency latency;
+
+    if (ok) {
+        printf("{\"benchmark\": \"render\", \"renderer\": \"software\", \"width\": %d, \"height\": %d, \"frames\": %d, \"raster_threads\": %d, \"results\": [",
+               WIDTH, HEIGHT, numFrames, raster != NULL ? raster->numWorkers : 0);
+    }
+    bool first = true;
+    for (int numTasks = SDL_min(100, maxTasks); numTasks > 0 && ok; numTasks = nextRenderBenchSize(numTasks, maxTasks)) {
+        OpenBoard *open = buildRenderBenchBoard(numTasks);
+        if (open == NULL) {
+            printf("\n], \"error\": \"out of memory for %d tasks\"}\n", numTasks);
+            ok = false;
+            break;
+        }
+        open->textCache.raster = raster;
+        Board *boards[2] = {&open->tasks, &open->done};
+
+        for (int s = 0; s < RENDER_BENCH_SCENARIOS; ++s) {
+            TextLine *task = &open->tasks.lines[0];
+            SDL_Rect home = task->rect;
+            int direction = 1;
+            memset(&latency, 0, sizeof(latency));
+            for (int f = 0; f < numFrames; ++f) {
+                Uint64 start = SDL_GetPerformanceCounter();
+                open->textCache.frame++;
+                // Déplacement et saisie passent par la file d'événements de SDL, comme dans
+                // l'interface, pour mesurer leur latence
+                SDL_Event input = {0};
+                if (s == 2) {
+                    input.type = SDL_MOUSEMOTION;
+                    input.motion.x = home.x + (f * 7) % (WIDTH - TEXTBOX_WIDTH);
+                    input.motion.y = home.y + (f * 5) % (HEIGHT - 2 * MIN_TEXTBOX_HEIGHT);
+                    SDL_PushEvent(&input);
+                } else if (s == 3) {
+                    input.type = SDL_TEXTINPUT;
+                    input.text.text[0] = (char)('a' + f % 26);
+                    SDL_PushEvent(&input);
+                }
+                while (SDL_PollEvent(&input)) {
+                    noteInputLatency(&latency, &input);
+                    if (input.type == SDL_MOUSEMOTION) {
+                        task->isDragging = true;
+                        task->rect.x = input.motion.x;
+                        task->rect.y = input.motion.y;
+                    } else if (input.type == SDL_TEXTINPUT) {
+                        // Une lettre de plus par image (le texte saisi est rendu à chaque fois)
+                        task->isEditing = true;
+                        size_t length = strlen(task->inputText);
+                        if (length >= 40) {
+                            length = 0;
+                        }
+                        task->inputText[length] = input.text.text[0];
+                        task->inputText[length + 1] = '\0';
+                    }
+                }
+                if (s == 1) {
+                    // Défiler d'une demi-ligne par image, dans un sens puis dans l'autre
+                    int before = open->doneScroll;
+                    open->doneScroll += direction * rowHeight / 2;
+                    scrollDoneColumn(&open->done, &open->doneScroll);
+                    direction = open->doneScroll == before ? -direction : direction;
+                }
+                if (raster != NULL) {
+                    uploadTextRaster(raster, rend, &open->textCache, RASTER_UPLOAD_BUDGET_US);
+                }
+                renderBoard(rend, font, columns, boards, &open->textCache);
+                SDL_RenderPresent(rend);
+                recordPresentedInput(&latency);
+                resetFrameArena(&frameArena);
+                times[f] = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+            }
+            task->isDragging = false;
+            task->isEditing = false;
+            task->inputText[0] = '\0';
+            task->rect = home;
+
+            double firstFrame = times[0];
+            double total = 0;
+            for (int f = 0; f < numFrames; ++f) {
+                total += times[f];
+            }
+            SDL_qsort(times, (size_t)numFrames, sizeof(double), compareFrameTimes);
+            // Latence des saisies (horodatages SDL à la milliseconde), pour les scénarios qui en reçoivent
+            char inputLatency[128] = "";
+            if (s >= 2) {
+                Uint32 p[3];
+                getInputLatency(&latency, s == 2 ? LATENCY_MOTION : LATENCY_TEXT, p);
+                SDL_snprintf(inputLatency, sizeof(inputLatency), ", \"input_p50_ms\": %u, \"input_p95_ms\": %u, \"input_p99_ms\": %u",
+                             (unsigned)p[0], (unsigned)p[1], (unsigned)p[2]);
+            }
+            printf("%s\n  {\"tasks\": %d, \"scenario\": \"%s\", \"first_ms\": %.3f, \"mean_ms\": %.3f, \"p50_ms\": %.3f, "
+                   "\"p95_ms\": %.3f, \"p99_ms\": %.3f, \"max_ms\": %.3f%s}",
+                   first ? "" : ",", numTasks, scenarios[s], firstFrame, total / numFrames, times[numFrames / 2],
+                   times[(numFrames * 95) / 100], times[(numFrames * 99) / 100], times[numFrames - 1], inputLatency);
+            first = false;
+        }
+        freeTextCache(&open->textCache);
+        freeBoard(&open->tasks);
+        freeBoard(&open->done);
+        freeBoard(&open->archive);
+        SDL_free(open);
+    }
+    if (ok) {
+        printf("\n]}\n");
+    }
+
+    destroyTextRaster(raster);
+    SDL_free(times);
+    if (rend != NULL) {
+        SDL_DestroyRenderer(rend);
+    }
+    SDL_FreeSurface(target);
+    if (font != NULL) {
+        TTF_CloseFont(font);
+    }
+    TTF_Quit();
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
+
+// Fonction pour préparer un tableau fixe de la vérification du rendu : tâches sur une ou
+// plusieurs lignes, texte long replié, tâche en cours de modification ou déplacée, colonne
+// "Done" défilée
+void buildRenderScene(OpenBoard *open, int scene) {
+    static const char *const texts[] = {"Buy milk", "Write the quarterly report\nwith charts",
+                                        "Call the bank about the mortgage renewal before Friday and ask for the new rates",
+                                        "Fix login bug #urgent", "Review pull request 42"};
+    static const int columns[] = {0, 0, 0, 1, 1};
+    if (scene == 0) {
+        return;
+    }
+    for (int i = 0; i < 5; ++i) {
+        TextLine line = {0};
+        line.column = columns[i];
+        SDL_strlcpy(line.text, texts[i], MAX_TEXT_LENGTH);
+        appendTask(&open->tasks, &line);
+    }
+    int numDone = scene == 4 ? 30 : 2;
+    for (int i = 0; i < numDone; ++i) {
+        TextLine line = {0};
+        line.column = DONE_COLUMN;
+        line.doneAt = 1;
+        SDL_snprintf(line.text, MAX_TEXT_LENGTH, "Done task %d", i);
+        appendTask(&open->done, &line);
+    }
+    layoutTasks(&open->tasks);
+    open->doneScroll = scene == 4 ? 3 * (MIN_TEXTBOX_HEIGHT + 5) + 7 : 0;
+    scrollDoneColumn(&open->done, &open->doneScroll);
+    if (scene == 2) {
+        open->tasks.lines[0].isEditing = true;
+        SDL_strlcpy(open->tasks.lines[0].inputText, "Buy oat milk", MAX_TEXT_LENGTH);
+    } else if (scene == 3) {
+        open->tasks.lines[1].isDragging = true;
+        open->tasks.lines[1].rect.x += 40;
+        open->tasks.lines[1].rect.y += 120;
+    }
+}
+
+// Fonction pour rendre une image de la vérification et lire ses pixels : sans cache, avec le
+// cache de textures (deuxième image, textes déjà en cache) ou avec les fils de rendu (une fois
+// tous les textes reçus). Renvoie false si l'image n'a pas pu être rendue.
+bool renderCheckFrame(SDL_Renderer *rend, TTF_Font *font, const Column columns[3], OpenBoard *open, int mode, TextRaster *raster, Uint32 *pixels) {
+    Board *boards[2] = {&open->tasks, &open->done};
+    freeTextCache(&open->textCache);
+    if (mode == 0) {
+        renderBoard(rend, font, columns, boards, NULL);
+    } else if (mode == 1) {
+        for (int f = 0; f < 2; ++f) {
+            open->textCache.frame++;
+            renderBoard(rend, font, columns, boards, &open->textCache);
+        }
+    } else {
+        // Une image qui n'a demandé aucun texte aux fils les avait tous en cache
+        open->textCache.raster = raster;
+        bool complete = false;
+        for (int f = 0; f < 5000 && !complete; ++f) {
+            open->textCache.frame++;
+            uploadTextRaster(raster, rend, &open->textCache, RASTER_UPLOAD_BUDGET_US);
+            renderBoard(rend, font, columns, boards, &open->textCache);
+            complete = raster->numFree == RASTER_QUEUE_SIZE;
+            if (!complete) {
+                SDL_Delay(1);
+            }
+        }
+        open->textCache.raster = NULL;
+        if (!complete) {
+            printf("Text rendering threads did not finish.\n");
+            return false;
+        }
+    }
+    bool ok = SDL_RenderReadPixels(rend, NULL, SDL_PIXELFORMAT_ARGB8888, pixels, WIDTH * 4) == 0;
+    SDL_RenderPresent(rend);
+    return ok;
+}
+
+// Fonction pour enregistrer une image (BMP) et, si l'image de référence est lisible, une image
+// des différences : pixels identiques pâlis, pixels différents en rouge. Renvoie le nombre de
+// pixels différents (-1 sans image de référence).
+int dumpRenderDifference(const Uint32 *pixels, const char *goldenImage, const char *scene, const char *mode) {
+    char path[256];
+    SDL_Surface *actual = SDL_CreateRGBSurfaceWithFormatFrom((void *)pixels, WIDTH, HEIGHT, 32, WIDTH * 4, SDL_PIXELFORMAT_ARGB8888);
+    SDL_snprintf(path, sizeof(path), "render_failed_%s_%s.bmp", scene, mode);
+    if (actual == NULL || SDL_SaveBMP(actual, path) != 0) {
+        printf("Error writing %s: %s\n", path, SDL_GetError());
+    }
+    SDL_FreeSurface(actual);
+
+    SDL_Surface *loaded = SDL_LoadBMP(goldenImage);
+    SDL_Surface *golden = loaded != NULL ? SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0) : NULL;
+    SDL_FreeSurface(loaded);
+    if (golden == NULL || golden->w != WIDTH || golden->h != HEIGHT) {
+        SDL_FreeSurface(golden);
+        return -1;
+    }
+    SDL_Surface *diff = SDL_CreateRGBSurfaceWithFormat(0, WIDTH, HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    int different = 0;
+    for (int y = 0; y < HEIGHT && diff != NULL; ++y) {
+        const Uint32 *expected = (const Uint32 *)((const Uint8 *)golden->pixels + y * golden->pitch);
+        Uint32 *out = (Uint32 *)((Uint8 *)diff->pixels + y * diff->pitch);
+        for (int x = 0; x < WIDTH; ++x) {
+            Uint32 a = pixels[y * WIDTH + x];
+            if (a != expected[x]) {
+                out[x] = 0xFFFF0000;
+                different++;
+            } else {
+                // Moyenne avec du blanc, canal par canal
+                out[x] = 0xFF000000 | (((a & 0xFEFEFE) >> 1) + 0x7F7F7F);
+            }
+        }
+    }
+    SDL_snprintf(path, sizeof(path), "render_diff_%s_%s.bmp", scene, mode);
+    if (diff == NULL || SDL_SaveBMP(diff, path) != 0) {
+        printf("Error writing %s: %s\n", path, SDL_GetError());
+    }
+    SDL_FreeSurface(diff);
+    SDL_FreeSurface(golden);
+    return different;
+}
+
+// Fonction pour vérifier que le rendu n'a pas changé : chaque tableau fixe est rendu sans écran
+// (rendu logiciel) sans cache, avec le cache et avec les fils de rendu, et le CRC32 de ses pixels
+// est comparé à sa valeur de référence, lue dans goldenPath (une ligne "scène crc" par tableau).
+// En cas d'écart, l'image obtenue et une image des différences sont écrites. Avec update, les
+// valeurs et les images de référence (goldenPath sans extension, suivi de _scène.bmp) sont
+// réécrites à partir du rendu sans cache.
+int runRenderCheck(const char *goldenPath, bool update, const char *fontPath) {
+    static const char *scenes[RENDER_CHECK_SCENES] = {"empty", "board", "editing", "dragging", "scrolled"};
+    static const char *modes[3] = {"direct", "cached", "threaded"};
+    Uint32 golden[RENDER_CHECK_SCENES] = {0};
+    bool known[RENDER_CHECK_SCENES] = {false};
+    FILE *file = fopen(goldenPath, "r");
+    if (file != NULL) {
+        char name[64];
+        unsigned value;
+        while (fscanf(file, "%63s %x", name, &value) == 2) {
+            for (int s = 0; s < RENDER_CHECK_SCENES; ++s) {
+                if (strcmp(name, scenes[s]) == 0) {
+                    golden[s] = value;
+                    known[s] = true;
+                }
+            }
+        }
+        fclose(file);
+    } else if (!update) {
+        printf("Error opening %s for reading (run with --update-golden to record the reference images).\n", goldenPath);
+        return 1;
+    }
+    char prefix[256];
+    SDL_strlcpy(prefix, goldenPath, sizeof(prefix));
+    char *extension = strrchr(prefix, '.');
+    if (extension != NULL && strpbrk(extension, "/\\") == NULL) {
+        *extension = '\0';
+    }
+
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    if (SDL_Init(SDL_INIT_VIDEO) != 0 || TTF_Init() != 0) {
+        printf("Error initializing SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    TTF_Font *font = TTF_OpenFont(fontPath, FONT_SIZE);
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, WIDTH, HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *rend = target != NULL ? SDL_CreateSoftwareRenderer(target) : NULL;
+    Uint32 *pixels = SDL_malloc((size_t)WIDTH * HEIGHT * 4);
+    if (font == NULL || rend == NULL || pixels == NULL) {
+        printf("Error preparing the render check: %s\n", font == NULL ? TTF_GetError() : SDL_GetError());
+        return 1;
+    }
+    TextRaster *raster = createTextRaster(fontPath, FONT_SIZE);
+    Column columns[3];
+    initColumns(columns);
+
+    int failures = 0;
+    for (int s = 0; s < RENDER_CHECK_SCENES; ++s) {
+        OpenBoard *open = SDL_calloc(1, sizeof(OpenBoard));
+        if (open == NULL) {
+            failures++;
+            break;
+        }
+        buildRenderScene(open, s);
+        char goldenImage[300];
+        SDL_snprintf(goldenImage, sizeof(goldenImage), "%s_%s.bmp", prefix, scenes[s]);
+        for (int m = 0; m < 3; ++m) {
+            if (m == 2 && raster == NULL) {
+                printf("%-9s %-8s skipped (no text rendering threads)\n", scenes[s], modes[m]);
+                continue;
+            }
+            if (!renderCheckFrame(rend, font, columns, open, m, raster, pixels)) {
+                printf("%-9s %-8s error: %s\n", scenes[s], modes[m], SDL_GetError());
+                failures++;
+                continue;
+            }
+            Uint32 crc = crc32(pixels, (size_t)WIDTH * HEIGHT * 4);
+            if (update && m == 0) {
+                SDL_Surface *image = SDL_CreateRGBSurfaceWithFormatFrom(pixels, WIDTH, HEIGHT, 32, WIDTH * 4, SDL_PIXELFORMAT_ARGB8888);
+                if (image == NULL || SDL_SaveBMP(image, goldenImage) != 0) {
+                    printf("Error writing %s: %s\n", goldenImage, SDL_GetError());
+                    failures++;
+                }
+                SDL_FreeSurface(image);
+                golden[s] = crc;
+                known[s] = true;
+            }
+            if (!known[s]) {
+                printf("%-9s %-8s %08x: no reference value\n", scenes[s], modes[m], (unsigned)crc);
+                failures++;
+            } else if (crc != golden[s]) {
+                int different = dumpRenderDifference(pixels, goldenImage, scenes[s], modes[m]);
+                printf("%-9s %-8s %08x: expected %08x", scenes[s], modes[m], (unsigned)crc, (unsigned)golden[s]);
+                if (different >= 0) {
+                    printf(", %d pixels differ (see render_diff_%s_%s.bmp)\n", different, scenes[s], modes[m]);
+                } else {
+                    printf(" (see render_failed_%s_%s.bmp)\n", scenes[s], modes[m]);
+                }
+                failures++;
+            } else {
+                printf("%-9s %-8s %08x: ok\n", scenes[s], modes[m], (unsigned)crc);
+            }
+        }
+        freeTextCache(&open->textCache);
+        freeBoard(&open->tasks);
+        freeBoard(&open->done);
+        freeBoard(&open->archive);
+        SDL_free(open);
+    }
+
+    if (update && failures == 0) {
+        file = fopen(goldenPath, "w");
+        for (int s = 0; s < RENDER_CHECK_SCENES && file != NULL; ++s) {
+            fprintf(file, "%s %08x\n", scenes[s], (unsigned)golden[s]);
+        }
+        if (file == NULL || fclose(file) != 0) {
+            printf("Error writing %s.\n", goldenPath);
+            failures++;
+        } else {
+            printf("Reference values written to %s.\n", goldenPath);
+        }
+    }
+
+    destroyTextRaster(raster);
+    SDL_free(pixels);
+    SDL_DestroyRenderer(rend);
+    SDL_FreeSurface(target);
+    TTF_CloseFont(font);
+    TTF_Quit();
+    SDL_Quit();
+    if (failures > 0) {
+        printf("%d render checks failed.\n", failures);
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+// Structure pour l'affichage des allocations pendant l'exécution (--alloc-stats)
+typedef struct {
+    SDL_Texture *texture;
+    int width;
+    int height;
+    Uint32 lastUpdate;
+} AllocOverlay;
+
+// Fonction pour dessiner les allocations de la dernière image en bas à gauche. Le texte n'est
+// rendu qu'au plus toutes les ALLOC_OVERLAY_MS millisecondes, et ses allocations sont comptées à
+// part pour ne pas fausser celles du tableau.
+void renderAllocOverlay(SDL_Renderer *rend, TTF_Font *font, AllocOverlay *overlay) {
+    int previous = setAllocZone(ALLOC_OVERLAY);
+    Uint32 now = SDL_GetTicks();
+    if (overlay->texture == NULL || now - overlay->lastUpdate >= ALLOC_OVERLAY_MS) {
+        const AllocCounter *last = allocStats.lastFrame;
+        Uint64 bytes = 0;
+        for (int z = 0; z < ALLOC_ZONES; ++z) {
+            bytes += last[z].bytes;
+        }
+        char label[128];
+        SDL_snprintf(label, sizeof(label), "Allocs %llu (%.1f KB): ev %llu up %llu st %llu rd %llu rt %llu, peak %.1f MB",
+                     (unsigned long long)lastFrameAllocs(), bytes / 1024.0, (unsigned long long)last[ALLOC_EVENTS].count,
+                     (unsigned long long)last[ALLOC_UPDATE].count, (unsigned long long)last[ALLOC_STORAGE].count,
+                     (unsigned long long)last[ALLOC_RENDER].count, (unsigned long long)last[ALLOC_RASTER].count, allocStats.peak / 1e6);
+        if (overlay->texture != NULL) {
+            SDL_DestroyTexture(overlay->texture);
+        }
+        SDL_Surface *surface = TTF_RenderText_Blended(font, label, (SDL_Color){0, 0, 0, 255});
+        overlay->texture = surface != NULL ? SDL_CreateTextureFromSurface(rend, surface) : NULL;
+        SDL_FreeSurface(surface);
+        overlay->width = overlay->height = 0;
+        if (overlay->texture != NULL) {
+            SDL_QueryTexture(overlay->texture, NULL, NULL, &overlay->width, &overlay->height);
+        }
+        overlay->lastUpdate = now;
+    }
+    if (overlay->texture != NULL) {
+        SDL_Rect rect = {0, HEIGHT - BUTTON_HEIGHT - overlay->height - 4, overlay->width + 8, overlay->height + 4};
+        SDL_SetRenderDrawColor(rend, 255, 255, 255, 255);
+        SDL_RenderFillRect(rend, &rect);
+        SDL_Rect quad = {4, rect.y + 2, overlay->width, overlay->height};
+        SDL_RenderCopy(rend, overlay->texture, NULL, &quad);
+        renderCounters.drawCalls += 2;
+    }
+    setAllocZone(previous);
+}
+
+// Structure pour l'affichage des performances (F3). Le texte est écrit avec des textures de
+// caractères rendues une seule fois, et n'est recalculé qu'au plus toutes les HUD_UPDATE_MS
+// millisecondes : l'affichage ne rend aucun texte et n'alloue rien d'une image à l'autre.
+typedef struct {
+    bool visible;
+    TTF_Font *font;                   // Ouverte au premier affichage
+    SDL_Texture *glyphs[HUD_GLYPHS];
+    int glyphWidths[HUD_GLYPHS];
+    int glyphAdvances[HUD_GLYPHS];
+    int lineHeight;
+    float frameMs[HUD_HISTORY];       // Durée des dernières images, pour l'histogramme
+    int numFrames;
+    // Cumuls depuis la dernière mise à jour du texte
+    Uint64 phaseTicks[HUD_PHASES];
+    Uint64 frameTicks;
+    Uint64 maxFrameTicks;
+    int frames;
+    int events;
+    RenderCounters counters;          // Compteurs du rendu à la dernière mise à jour
+    Uint32 lastUpdate;
+    char lines[HUD_LINES][96];
+} PerfHud;
+
+// Fonction pour ajouter les mesures d'une image (durée de chaque phase et de l'image entière, en
+// unités de SDL_GetPerformanceCounter) et recalculer le texte s'il est temps, avec la latence
+// des dernières saisies
+void recordHudFrame(PerfHud *hud, const Uint64 phaseTicks[HUD_PHASES], Uint64 frameTicks, int events, const InputLatency *latency, bool lowLatency) {
+    double tickMs = 1000.0 / (double)SDL_GetPerformanceFrequency();
+    hud->frameMs[hud->numFrames++ % HUD_HISTORY] = (float)(frameTicks * tickMs);
+    for (int p = 0; p < HUD_PHASES; ++p) {
+        hud->phaseTicks[p] += phaseTicks[p];
+    }
+    hud->frameTicks += frameTicks;
+    hud->maxFrameTicks = SDL_max(hud->maxFrameTicks, frameTicks);
+    hud->frames++;
+    hud->events += events;
+
+    Uint32 now = SDL_GetTicks();
+    if (now - hud->lastUpdate < HUD_UPDATE_MS) {
+        return;
+    }
+    // Moyennes par image depuis la dernière mise à jour
+    double perFrame = tickMs / hud->frames;
+    const Uint64 *phase = hud->phaseTicks;
+    double frameMs = hud->frameTicks * perFrame;
+    RenderCounters delta = {
+        renderCounters.drawCalls - hud->counters.drawCalls,
+        renderCounters.rasterized - hud->counters.rasterized,
+        renderCounters.cacheHits - hud->counters.cacheHits,
+        renderCounters.cacheMisses - hud->counters.cacheMisses,
+    };
+    Uint64 lookups = delta.cacheHits + delta.cacheMisses;
+    SDL_snprintf(hud->lines[0], sizeof(hud->lines[0]), "Frame %.2f ms, max %.2f ms (%.0f fps)", frameMs,
+                 hud->maxFrameTicks * tickMs, frameMs > 0 ? 1000.0 / frameMs : 0.0);
+    SDL_snprintf(hud->lines[1], sizeof(hud->lines[1]), "CPU %.2f ms: events %.2f update %.2f draw %.2f",
+                 (phase[HUD_EVENTS] + phase[HUD_UPDATE] + phase[HUD_DRAW]) * perFrame, phase[HUD_EVENTS] * perFrame,
+                 phase[HUD_UPDATE] * perFrame, phase[HUD_DRAW] * perFrame);
+    SDL_snprintf(hud->lines[2], sizeof(hud->lines[2]), "GPU present %.2f ms, %.1f events/frame", phase[HUD_PRESENT] * perFrame,
+                 (double)hud->events / hud->frames);
+    SDL_snprintf(hud->lines[3], sizeof(hud->lines[3]), "%.0f draw calls, %.1f rasterized per frame",
+                 (double)delta.drawCalls / hud->frames, (double)delta.rasterized / hud->frames);
+    SDL_snprintf(hud->lines[4], sizeof(hud->lines[4]), "Text cache %.1f%% hits (%.0f lookups/frame)",
+                 lookups > 0 ? 100.0 * delta.cacheHits / lookups : 100.0, (double)lookups / hud->frames);
+    static const char *types[LATENCY_TYPES] = {"Typing", "Mouse"};
+    for (int t = 0; t < LATENCY_TYPES; ++t) {
+        Uint32 p[3];
+        if (getInputLatency(latency, t, p) > 0) {
+            SDL_snprintf(hud->lines[5 + t], sizeof(hud->lines[5 + t]), "%s latency p50 %u p95 %u p99 %u ms%s", types[t], (unsigned)p[0],
+                         (unsigned)p[1], (unsigned)p[2], t == 0 && lowLatency ? " (low)" : "");
+        } else {
+            SDL_snprintf(hud->lines[5 + t], sizeof(hud->lines[5 + t]), "%s latency: no input yet", types[t]);
+        }
+    }
+
+    memset(hud->phaseTicks, 0, sizeof(hud->phaseTicks));
+    hud->frameTicks = 0;
+    hud->maxFrameTicks = 0;
+    hud->frames = 0;
+    hud->events = 0;
+    hud->counters = renderCounters;
+    hud->lastUpdate = now;
+}
+
+// Fonction pour rendre une fois pour toutes les caractères de l'affichage des performances
+bool loadHudGlyphs(PerfHud *hud, SDL_Renderer *rend, const char *fontPath) {
+    hud->font = TTF_OpenFont(fontPath, HUD_FONT_SIZE);
+    if (hud->font == NULL) {
+        printf("Could not open the performance overlay font: %s\n", TTF_GetError());
+        return false;
+    }
+    hud->lineHeight = TTF_FontHeight(hud->font);
+    for (int i = 0; i < HUD_GLYPHS; ++i) {
+        Uint16 glyph = (Uint16)(HUD_FIRST_GLYPH + i);
+        SDL_Surface *surface = TTF_RenderGlyph_Blended(hud->font, glyph, (SDL_Color){255, 255, 255, 255});
+        if (surface == NULL) {
+            continue;
+        }
+        hud->glyphs[i] = SDL_CreateTextureFromSurface(rend, surface);
+        hud->glyphWidths[i] = surface->w;
+        SDL_FreeSurface(surface);
+        if (TTF_GlyphMetrics(hud->font, glyph, NULL, NULL, NULL, NULL, &hud->glyphAdvances[i]) != 0) {
+            hud->glyphAdvances[i] = hud->glyphWidths[i];
+        }
+    }
+    return true;
+}
+
+// Fonction pour écrire une ligne de l'affichage des performances avec les caractères déjà rendus
+void renderHudLine(SDL_Renderer *rend, const PerfHud *hud, const char *text, int x, int y) {
+    for (const char *c = text; *c != '\0'; ++c) {
+        int i = (unsigned char)*c - HUD_FIRST_GLYPH;
+        if (i < 0 || i >= HUD_GLYPHS || hud->glyphs[i] == NULL) {
+            continue;
+        }
+        SDL_Rect quad = {x, y, hud->glyphWidths[i], hud->lineHeight};
+        SDL_RenderCopy(rend, hud->glyphs[i], NULL, &quad);
+        x += hud->glyphAdvances[i];
+    }
+}
+
+// Fonction pour dessiner l'affichage des performances en haut à droite : les mesures, puis
+// l'histogramme des dernières images (rouge au-delà de 16,7 ms, marquées par la ligne jaune)
+void renderHud(SDL_Renderer *rend, const char *fontPath, PerfHud *hud) {
+    if (!hud->visible) {
+        return;
+    }
+    if (hud->font == NULL && !loadHudGlyphs(hud, rend, fontPath)) {
+        hud->visible = false;
+        return;
+    }
+    int previous = setAllocZone(ALLOC_OVERLAY);
+    SDL_Rect panel = {WIDTH - HUD_WIDTH - 10, 40, HUD_WIDTH, HUD_LINES * hud->lineHeight + HUD_GRAPH_HEIGHT + 20};
+    SDL_SetRenderDrawColor(rend, 32, 32, 32, 255);
+    SDL_RenderFillRect(rend, &panel);
+    for (int l = 0; l < HUD_LINES; ++l) {
+        renderHudLine(rend, hud, hud->lines[l], panel.x + 10, panel.y + 5 + l * hud->lineHeight);
+    }
+
+    // Barres de l'histogramme, de la plus ancienne à la plus récente, à 2 pixels par milliseconde
+    SDL_Rect fast[HUD_HISTORY], slow[HUD_HISTORY];
+    int numFast = 0, numSlow = 0;
+    int bottom = panel.y + panel.h - 10;
+    for (int i = 0; i < HUD_HISTORY; ++i) {
+        int frame = hud->numFrames - HUD_HISTORY + i;
+        if (frame < 0) {
+            continue;
+        }
+        float ms = hud->frameMs[frame % HUD_HISTORY];
+        int height = SDL_min((int)(ms * 2) + 1, HUD_GRAPH_HEIGHT);
+        SDL_Rect bar = {panel.x + 10 + i * HUD_BAR_WIDTH, bottom - height, HUD_BAR_WIDTH - 1, height};
+        if (ms > 1000.0f / 60) {
+            slow[numSlow++] = bar;
+        } else {
+            fast[numFast++] = bar;
+        }
+    }
+    SDL_SetRenderDrawColor(rend, 64, 200, 64, 255);
+    SDL_RenderFillRects(rend, fast, numFast);
+    SDL_SetRenderDrawColor(rend, 220, 64, 64, 255);
+    SDL_RenderFillRects(rend, slow, numSlow);
+    SDL_SetRenderDrawColor(rend, 240, 220, 64, 255);
+    int budgetY = bottom - (int)(2 * 1000.0f / 60);
+    SDL_RenderDrawLine(rend, panel.x + 10, budgetY, panel.x + 10 + HUD_HISTORY * HUD_BAR_WIDTH, budgetY);
+    setAllocZone(previous);
+}
+
+// Fonction pour libérer les caractères et la police de l'affichage des performances
+void freeHud(PerfHud *hud) {
+    for (int i = 0; i < HUD_GLYPHS; ++i) {
+        if (hud->glyphs[i] != NULL) {
+            SDL_DestroyTexture(hud->glyphs[i]);
+        }
+    }
+    if (hud->font != NULL) {
+        TTF_CloseFont(hud->font);
+    }
+    memset(hud, 0, sizeof(*hud));
+}
+
+// Fonction pour gérer un clic, un relâchement ou un déplacement de la souris sur les tableaux
+// affichés : ajout, suppression ou déplacement d'une tâche
+void handleMouseEvent(OpenBoard *open, Board **boards, TTF_Font *font, const SDL_Event *event) {
+    if (event->type == SDL_MOUSEBUTTONDOWN) {
+        // Position tirée de l'événement (et non de la souris) pour que la relecture soit fidèle
+        int mouseX = event->button.x, mouseY = event->button.y;
+
+        // Vérifier si le clic est sur le bouton "Add"
+        if (event->button.button == SDL_BUTTON_LEFT && isPointInRect(&(SDL_Point){mouseX, mouseY}, &(SDL_Rect){WIDTH - BUTTON_WIDTH, HEIGHT - BUTTON_HEIGHT, BUTTON_WIDTH, BUTTON_HEIGHT})) {
+            // Ajouter une nouvelle zone de texte dans la colonne "To Do"
+            beginUndoStep(open);
+            addNewTask(open);
+            endUndoStep(open);
+        } else if (event->button.button == SDL_BUTTON_RIGHT) {
+            // Vérifier si le clic est sur une zone de texte existante pour la supprimer
+            int b, i;
+            if (findTaskAt(boards, 2, (SDL_Point){mouseX, mouseY}, &b, &i)) {
+                // Supprimer la ligne
+                beginUndoStep(open);
+                removeTask(open, boards[b], boards[b]->baseIndex + i);
+                endUndoStep(open);
+                scrollDoneColumn(&open->done, &open->doneScroll);
+            }
+        } else {
+            // Vérifier si le clic est sur une zone de texte existante pour la déplacer
+            int b, i;
+            bool found = findTaskAt(boards, 2, (SDL_Point){mouseX, mouseY}, &b, &i);
+            for (int k = 0; k < 2; ++k) {
+                for (int j = 0; j < loadedTasks(boards[k]); ++j) {
+                    boards[k]->lines[j].isEditing = false;
+                    boards[k]->lines[j].isDragging = false;
+                }
+            }
+            if (found) {
+                TextLine *line = &boards[b]->lines[i];
+                line->isEditing = true;
+                line->isDragging = true;
+
+                // Stocker la position y initiale
+                int textWidth, textHeight;
+                TTF_SizeText(font, line->text, &textWidth, &textHeight);
+                line->rect.y = line->rect.y + (line->rect.h - textHeight) / 2;
+            }
+        }
+    } else if (event->type == SDL_MOUSEBUTTONUP) {
+        // Désactiver le déplacement lorsque le bouton de la souris est relâché
+        for (int b = 0; b < 2; ++b) {
+            for (int i = 0; i < loadedTasks(boards[b]); ++i) {
+                TextLine *line = &boards[b]->lines[i];
+                if (!line->isDragging) {
+                    continue;
+                }
+                line->isDragging = false;
+
+                // La tâche appartient à la colonne où elle a été déposée
+                int column = (line->rect.x + line->rect.w / 2) / (WIDTH / 3);
+                column = column < 0 ? 0 : (column > 2 ? 2 : column);
+                beginUndoStep(open);
+                moveTask(open, boards[b], boards[b]->baseIndex + i, column);
+                endUndoStep(open);
+                scrollDoneColumn(&open->done, &open->doneScroll);
+                break;
+            }
+        }
+    } else if (event->type == SDL_MOUSEMOTION) {
+        // Déplacer la zone de texte en cours d'édition si elle est en cours de déplacement
+        for (int b = 0; b < 2; ++b) {
+            for (int i = 0; i < loadedTasks(boards[b]); ++i) {
+                TextLine *line = &boards[b]->lines[i];
+                if (line->isDragging) {
+                    line->rect.x = event->motion.x - line->rect.w / 2;
+                    line->rect.y = event->motion.y - line->rect.h / 2;
+                    moveSyncDrag(&open->sync, line, (SDL_Point){line->rect.x, line->rect.y});
+                }
+            }
+        }
+    }
+}
+
+// Fonction pour jouer une image de la vérification des allocations comme la boucle principale :
+// événements de la souris en file, mise à jour de la recherche et de la colonne "Done", rendu
+// du tableau puis de l'affichage des performances
+void runAllocCheckFrame(OpenBoard *open, Board **boards, SDL_Renderer *rend, TTF_Font *font, const Column columns[3],
+                        const char *fontPath, PerfHud *hud, InputLatency *latency) {
+    Uint64 frameStart = SDL_GetPerformanceCounter();
+    Uint64 phaseTicks[HUD_PHASES] = {0};
+    int numEvents = 0;
+    setAllocZone(ALLOC_UPDATE);
+    open->textCache.frame++;
+    verifySearchMatches(&open->taskIndex, &open->tasks, SEARCH_VERIFY_PER_FRAME);
+    verifySearchMatches(&open->doneIndex, &open->done, SEARCH_VERIFY_PER_FRAME);
+    applyPendingPostings(&open->taskIndex, INDEX_CHANGES_PER_FRAME);
+    applyPendingPostings(&open->doneIndex, INDEX_CHANGES_PER_FRAME);
+    scrollDoneColumn(&open->done, &open->doneScroll);
+
+    setAllocZone(ALLOC_EVENTS);
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        numEvents++;
+        noteInputLatency(latency, &event);
+        handleMouseEvent(open, boards, font, &event);
+    }
+
+    setAllocZone(ALLOC_RENDER);
+    Uint64 drawStart = SDL_GetPerformanceCounter();
+    if (open->textCache.raster != NULL) {
+        uploadTextRaster(open->textCache.raster, rend, &open->textCache, RASTER_UPLOAD_BUDGET_US);
+    }
+    renderBoard(rend, font, columns, boards, &open->textCache);
+    renderHud(rend, fontPath, hud);
+    phaseTicks[HUD_DRAW] = SDL_GetPerformanceCounter() - drawStart;
+    SDL_RenderPresent(rend);
+    recordPresentedInput(latency);
+    resetFrameArena(&frameArena);
+    endAllocFrame();
+    recordHudFrame(hud, phaseTicks, SDL_GetPerformanceCounter() - frameStart, numEvents, latency, false);
+}
+
+// Fonction pour placer dans la file un événement de la souris (bouton gauche) comme en produit
+// SDL : le déplacement d'une tâche passe par le même traitement que dans l'interface
+bool pushMouseEvent(Uint32 type, int x, int y) {
+    SDL_Event event = {0};
+    event.type = type;
+    if (type == SDL_MOUSEMOTION) {
+        event.motion.x = x;
+        event.motion.y = y;
+        event.motion.state = SDL_BUTTON_LMASK;
+    } else {
+        event.button.x = x;
+        event.button.y = y;
+        event.button.button = SDL_BUTTON_LEFT;
+        event.button.state = type == SDL_MOUSEBUTTONDOWN ? SDL_PRESSED : SDL_RELEASED;
+        event.button.clicks = 1;
+    }
+    return SDL_PushEvent(&event) == 1;
+}
+
+// Fonction pour vérifier qu'une image sans changement, puis une image où une tâche est déplacée
+// à la souris, ne fait aucune allocation une fois les textes en cache (rendu logiciel sans écran,
+// avec les fils de rendu et l'affichage des performances comme dans l'interface)
+int runAllocCheck(int numFrames, const char *fontPath) {
+    static const char *scenarios[2] = {"idle", "dragging"};
+    if (!allocStats.enabled) {
+        printf("Allocation counters are not installed.\n");
+        return 1;
+    }
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    if (SDL_Init(SDL_INIT_VIDEO) != 0 || TTF_Init() != 0) {
+        printf("Error initializing SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    TTF_Font *font = TTF_OpenFont(fontPath, FONT_SIZE);
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, WIDTH, HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *rend = target != NULL ? SDL_CreateSoftwareRenderer(target) : NULL;
+    OpenBoard *open = SDL_calloc(1, sizeof(OpenBoard));
+    InputLatency *latency = SDL_calloc(1, sizeof(InputLatency));
+    if (font == NULL || rend == NULL || open == NULL || latency == NULL || numFrames <= 0) {
+        printf("Error preparing the allocation check: %s\n", font == NULL ? TTF_GetError() : SDL_GetError());
+        return 1;
+    }
+    TextRaster *raster = createTextRaster(fontPath, FONT_SIZE);
+    Column columns[3];
+    initColumns(columns);
+    buildRenderScene(open, 1);
+    open->textCache.raster = raster;
+    Board *boards[2] = {&open->tasks, &open->done};
+    PerfHud hud = {0};
+    hud.visible = true;
+    SDL_Rect home = open->tasks.lines[0].rect;
+    SDL_Point grab = {home.x + home.w / 2, home.y + home.h / 2};
+
+    int failures = 0;
+    for (int s = 0; s < 2; ++s) {
+        // Saisie de la tâche : clic au milieu de sa zone de texte
+        if (s == 1 && (!pushMouseEvent(SDL_MOUSEBUTTONDOWN, grab.x, grab.y) || !pushMouseEvent(SDL_MOUSEMOTION, grab.x, grab.y))) {
+            printf("Error queuing mouse events: %s\n", SDL_GetError());
+            failures++;
+            break;
+        }
+        // Premières images : textes rendus et mis en cache, tampons du rendu et file des
+        // événements agrandis
+        for (int f = 0, stable = 0; f < 5000 && stable < 3; ++f) {
+            if (s == 1 && f > 0) {
+                pushMouseEvent(SDL_MOUSEMOTION, grab.x + (f * 7) % (WIDTH - TEXTBOX_WIDTH), grab.y + (f * 5) % (HEIGHT - 2 * MIN_TEXTBOX_HEIGHT));
+            }
+            runAllocCheckFrame(open, boards, rend, font, columns, fontPath, &hud, latency);
+            stable = raster == NULL || raster->numFree == RASTER_QUEUE_SIZE ? stable + 1 : 0;
+            if (stable == 0) {
+                SDL_Delay(1);
+            }
+        }
+        if (s == 1 && findEditingTask(boards, 2, NULL, NULL) != &open->tasks.lines[0]) {
+            printf("dragging: the task was not picked up by the mouse events\n");
+            failures++;
+            break;
+        }
+
+        Uint64 allocations = 0;
+        Uint64 bytes = 0;
+        int framesAllocating = 0;
+        for (int f = 0; f < numFrames; ++f) {
+            if (s == 1) {
+                pushMouseEvent(SDL_MOUSEMOTION, grab.x + (f * 7) % (WIDTH - TEXTBOX_WIDTH), grab.y + (f * 5) % (HEIGHT - 2 * MIN_TEXTBOX_HEIGHT));
+            }
+            runAllocCheckFrame(open, boards, rend, font, columns, fontPath, &hud, latency);
+            Uint64 count = lastFrameAllocs();
+            allocations += count;
+            framesAllocating += count > 0;
+            for (int z = 0; z < ALLOC_ZONES; ++z) {
+                bytes += allocStats.lastFrame[z].bytes;
+            }
+        }
+        printf("%-8s %d frames: %llu allocations (%llu bytes) in %d frames: %s\n", scenarios[s], numFrames,
+               (unsigned long long)allocations, (unsigned long long)bytes, framesAllocating, allocations == 0 ? "ok" : "FAILED");
+        failures += allocations > 0;
+
+        // Dépôt de la tâche à sa place (image non comptée : le déplacement est enregistré)
+        if (s == 1) {
+            pushMouseEvent(SDL_MOUSEMOTION, grab.x, grab.y);
+            pushMouseEvent(SDL_MOUSEBUTTONUP, grab.x, grab.y);
+            runAllocCheckFrame(open, boards, rend, font, columns, fontPath, &hud, latency);
+        }
+    }
+
+    open->textCache.raster = NULL;
+    destroyTextRaster(raster);
+    freeHud(&hud);
+    freeTextCache(&open->textCache);
+    freeBoard(&open->tasks);
+    freeBoard(&open->done);
+    freeBoard(&open->archive);
+    SDL_free(open);
+    SDL_free(latency);
+    SDL_DestroyRenderer(rend);
+    SDL_FreeSurface(target);
+    TTF_CloseFont(font);
+    TTF_Quit();
+    SDL_Quit();
+    return failures == 0 ? 0 : 1;
+}
+
+// Fonction pour calculer l'empreinte d'un tableau comparée à la fin d'une relecture : textes
+// et colonnes, sans les dates, qui changent d'une exécution à l'autre
+Uint32 boardStateChecksum(const Board *board) {
+    Uint32 sum = (Uint32)countTasks(board);
+    for (int i = 0; i < loadedTasks(board); ++i) {
+        const TextLine *line = &board->lines[i];
+        if (line->isFree) {
+            continue;
+        }
+        sum = sum * 1000003u + crc32(line->text, strlen(line->text)) + (Uint32)line->column * 7u + (line->doneAt != 0) * 13u;
+    }
+    return sum;
+}
+
+// Fonction pour connaître le nombre d'octets enregistrés d'un événement : la taille de sa
+// variante, ou 0 pour ceux qui portent des pointeurs (fichiers déposés, événements propres
+// à une application), qui ne sont pas enregistrés
+size_t eventLogSize(const SDL_Event *event) {
+    switch (event->type) {
+    case SDL_QUIT:
+        return sizeof(SDL_QuitEvent);
+    case SDL_WINDOWEVENT:
+        return sizeof(SDL_WindowEvent);
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        return sizeof(SDL_KeyboardEvent);
+    case SDL_TEXTEDITING:
+        return sizeof(SDL_TextEditingEvent);
+    case SDL_TEXTINPUT:
+        return sizeof(SDL_TextInputEvent);
+    case SDL_MOUSEMOTION:
+        return sizeof(SDL_MouseMotionEvent);
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        return sizeof(SDL_MouseButtonEvent);
+    case SDL_MOUSEWHEEL:
+        return sizeof(SDL_MouseWheelEvent);
+    case SDL_SYSWMEVENT:
+    case SDL_TEXTEDITING_EXT:
+    case SDL_DROPFILE:
+    case SDL_DROPTEXT:
+    case SDL_DROPBEGIN:
+    case SDL_DROPCOMPLETE:
+        return 0;
+    default:
+        return event->type >= SDL_USEREVENT ? 0 : sizeof(SDL_Event);
+    }
+}
+
+// Fonction pour commencer à enregistrer les événements dans path, avec les empreintes du
+// tableau affiché au départ
+bool startEventRecording(EventLog *log, const char *path, const OpenBoard *open) {
+    memset(log, 0, sizeof(*log));
+    log->file = SDL_RWFromFile(path, "wb");
+    if (log->file == NULL) {
+        printf("Error opening %s for writing.\n", path);
+        return false;
+    }
+    Uint8 header[16];
+    writeLE32(header, EVENTLOG_MAGIC);
+    writeLE32(header + 4, EVENTLOG_VERSION);
+    writeLE32(header + 8, boardStateChecksum(&open->tasks));
+    writeLE32(header + 12, boardStateChecksum(&open->done));
+    if (SDL_RWwrite(log->file, header, sizeof(header), 1) != 1) {
+        printf("Error writing %s.\n", path);
+        SDL_RWclose(log->file);
+        log->file = NULL;
+        return false;
+    }
+    log->start = SDL_GetTicks();
+    return true;
+}
+
+// Fonction pour ajouter un événement traité à l'enregistrement
+void recordEvent(EventLog *log, const SDL_Event *event) {
+    size_t size = eventLogSize(event);
+    if (log->file == NULL || size == 0) {
+        return;
+    }
+    Uint32 now = SDL_GetTicks() - log->start;
+    Uint8 length = (Uint8)size;
+    writeSyncVarint(&log->pending, log->frame - log->lastFrame);
+    writeSyncVarint(&log->pending, now - log->lastTime);
+    appendSyncBytes(&log->pending, &length, 1);
+    appendSyncBytes(&log->pending, event, size);
+    log->lastFrame = log->frame;
+    log->lastTime = now;
+    log->numEvents++;
+}
+
+// Fonction pour écrire les événements de l'image en cours (un enregistrement interrompu
+// garde toutes les images terminées)
+bool flushEventRecording(EventLog *log) {
+    if (log->file == NULL || log->pending.length == 0) {
+        return true;
+    }
+    bool ok = SDL_RWwrite(log->file, log->pending.data, log->pending.length, 1) == 1;
+    log->pending.length = 0;
+    return ok;
+}
+
+// Fonction pour terminer l'enregistrement avec les empreintes du tableau affiché à la fin
+bool stopEventRecording(EventLog *log, const OpenBoard *open) {
+    if (log->file == NULL) {
+        return true;
+    }
+    Uint8 end = EVENTLOG_END;
+    Uint8 checksums[8];
+    writeLE32(checksums, boardStateChecksum(&open->tasks));
+    writeLE32(checksums + 4, boardStateChecksum(&open->done));
+    writeSyncVarint(&log->pending, log->frame - log->lastFrame);
+    writeSyncVarint(&log->pending, SDL_GetTicks() - log->start - log->lastTime);
+    appendSyncBytes(&log->pending, &end, 1);
+    appendSyncBytes(&log->pending, checksums, sizeof(checksums));
+    bool ok = flushEventRecording(log);
+    if (SDL_RWclose(log->file) != 0) {
+        ok = false;
+    }
+    printf("%d events recorded over %u frames.\n", log->numEvents, (unsigned)log->frame);
+    SDL_free(log->pending.data);
+    memset(log, 0, sizeof(*log));
+    return ok;
+}
+
+// Fonction pour écarter les vraies saisies pendant une relecture (les événements relus sont
+// ajoutés avec SDL_PeepEvents, qui ne passe pas par ce filtre)
+int filterReplayInput(void *userdata, SDL_Event *event) {
+    (void)userdata;
+    return event->type >= SDL_KEYDOWN && event->type < SDL_CLIPBOARDUPDATE ? 0 : 1;
+}
+
+// Fonction pour charger un enregistrement à relire. Les empreintes de départ sont comparées
+// à celles du tableau affiché : un autre état de départ donne un autre état final.
+bool startEventReplay(EventLog *log, const char *path, const OpenBoard *open, bool maxSpeed) {
+    memset(log, 0, sizeof(*log));
+    SDL_RWops *rw = SDL_RWFromFile(path, "rb");
+    Sint64 size = rw != NULL ? SDL_RWsize(rw) : -1;
+    log->data = size >= 16 ? SDL_malloc((size_t)size) : NULL;
+    if (log->data == NULL || SDL_RWread(rw, log->data, (size_t)size, 1) != 1 || readLE32(log->data) != EVENTLOG_MAGIC ||
+        readLE32(log->data + 4) != EVENTLOG_VERSION) {
+        printf("Invalid event recording %s.\n", path);
+        SDL_free(log->data);
+        log->data = NULL;
+        if (rw != NULL) {
+            SDL_RWclose(rw);
+        }
+        return false;
+    }
+    SDL_RWclose(rw);
+    log->size = (size_t)size;
+    log->offset = 16;
+    log->replaying = true;
+    log->maxSpeed = maxSpeed;
+    if (readLE32(log->data + 8) != boardStateChecksum(&open->tasks) || readLE32(log->data + 12) != boardStateChecksum(&open->done)) {
+        printf("Warning: board %s differs from the one the events were recorded on.\n", open->files.name);
+    }
+    SDL_SetEventFilter(filterReplayInput, NULL);
+    log->start = SDL_GetTicks();
+    return true;
+}
+
+// Fonction pour relire les événements de l'image en cours : ils sont ajoutés à la file de
+// SDL, qui les rend à la boucle principale comme de vraies saisies. À vitesse réelle, la
+// relecture attend l'heure de chaque événement.
+void replayEvents(EventLog *log) {
+    while (log->replaying && !log->finished) {
+        size_t offset = log->offset;
+        Uint64 frames, elapsed;
+        if (!readSyncVarint(log->data, log->size, &offset, &frames) || !readSyncVarint(log->data, log->size, &offset, &elapsed) ||
+            offset >= log->size) {
+            // Enregistrement interrompu : pas de fin
+            log->finished = true;
+            break;
+        }
+        if (log->lastFrame + frames > log->frame) {
+            break;
+        }
+        Uint8 length = log->data[offset++];
+        size_t size = length == EVENTLOG_END ? 8 : length;
+        if (size > sizeof(SDL_Event) || size > log->size - offset) {
+            log->finished = true;
+            break;
+        }
+        log->lastFrame += (Uint32)frames;
+        log->lastTime += (Uint32)elapsed;
+        if (length == EVENTLOG_END) {
+            log->checksums[0] = readLE32(log->data + offset);
+            log->checksums[1] = readLE32(log->data + offset + 4);
+            log->ended = true;
+            log->finished = true;
+            break;
+        }
+        if (!log->maxSpeed && SDL_GetTicks() - log->start < log->lastTime) {
+            SDL_Delay(log->lastTime - (SDL_GetTicks() - log->start));
+        }
+        SDL_Event event;
+        memset(&event, 0, sizeof(event));
+        memcpy(&event, log->data + offset, size);
+        SDL_PeepEvents(&event, 1, SDL_ADDEVENT, 0, 0);
+        log->offset = offset + size;
+        log->numEvents++;
+    }
+}
+
+// Fonction pour terminer une relecture et comparer le tableau affiché à celui de la fin de
+// l'enregistrement. Renvoie false s'ils diffèrent.
+bool stopEventReplay(EventLog *log, const OpenBoard *open) {
+    if (!log->replaying) {
+        return true;
+    }
+    SDL_SetEventFilter(NULL, NULL);
+    double seconds = (SDL_GetTicks() - log->start) / 1000.0;
+    printf("%d events replayed over %u frames in %.2f s.\n", log->numEvents, (unsigned)log->frame, seconds);
+    Uint32 tasks = boardStateChecksum(&open->tasks);
+    Uint32 done = boardStateChecksum(&open->done);
+    bool same = log->ended && tasks == log->checksums[0] && done == log->checksums[1];
+    if (!log->ended) {
+        printf("The recording has no end: final state not checked.\n");
+    } else if (same) {
+        printf("Final board state matches the recording.\n");
+    } else {
+        printf("Final board state differs from the recording (%08x %08x, expected %08x %08x).\n",
+               (unsigned)tasks, (unsigned)done, (unsigned)log->checksums[0], (unsigned)log->checksums[1]);
+    }
+    SDL_free(log->data);
+    memset(log, 0, sizeof(*log));
+    return same;
+}
+
+// Fonction pour lire une colonne donnée par son nom ("todo", "doing", "done") ou son numéro
+// (-1 si elle est inconnue)
+int parseColumnName(const char *name) {
+    if (SDL_strcasecmp(name, "todo") == 0 || SDL_strcasecmp(name, "to-do") == 0 || strcmp(name, "0") == 0) {
+        return 0;
+    }
+    if (SDL_strcasecmp(name, "doing") == 0 || SDL_strcasecmp(name, "in-progress") == 0 || strcmp(name, "1") == 0) {
+        return 1;
+    }
+    if (SDL_strcasecmp(name, "done") == 0 || strcmp(name, "2") == 0) {
+        return DONE_COLUMN;
+    }
+    return -1;
+}
+
+// Fonction pour charger toute la colonne "Done" d'un tableau ouvert, dont une commande peut
+// viser n'importe quelle tâche
+bool loadWholeDoneColumn(OpenBoard *open) {
+    Board *done = &open->done;
+    return done->baseIndex == 0 || (loadEarlierPages(done, done->baseIndex / RECORDS_PER_PAGE) && done->baseIndex == 0);
+}
+
+// Fonction pour trouver la tâche désignée par une commande : par son numéro affiché par
+// "list" (tâches actives, puis colonne "Done", dans l'ordre d'affichage), ou sinon par son
+// texte exact
+bool findCliTask(OpenBoard *open, const char *reference, Board **board, int *index) {
+    Board *boards[2] = {&open->tasks, &open->done};
+    int numBoards = loadWholeDoneColumn(open) ? 2 : 1;
+    for (int b = 0; b < numBoards; ++b) {
+        if (!orderBoardTasks(boards[b])) {
+            return false;
+        }
+    }
+    char *end;
+    long number = strtol(reference, &end, 10);
+    if (*reference != '\0' && *end == '\0' && number >= 0) {
+        for (int b = 0; b < numBoards; ++b) {
+            if (number < boards[b]->numOrdered) {
+                *board = boards[b];
+                *index = taskSlot(boards[b], boards[b]->order[number]);
+                return true;
+            }
+            number -= boards[b]->numOrdered;
+        }
+    }
+    for (int b = 0; b < numBoards; ++b) {
+        for (int k = 0; k < boards[b]->numOrdered; ++k) {
+            if (strcmp(boards[b]->order[k]->text, reference) == 0) {
+                *board = boards[b];
+                *index = taskSlot(boards[b], boards[b]->order[k]);
+                return true;
+            }
         }
-        fclose(file);
-        printf("Tasks saved to file.\n");
-    } else {
-        printf("Error opening tasks.txt for writing.\n");
     }
+    printf("No task %s.\n", reference);
+    return false;
 }
 
-
-// Fonction pour charger les données depuis un fichier
-void loadTasksFromFile(TextLine *textLines, int *numLines) {
-    FILE *file = fopen("tasks.txt", "r");
-    if (file != NULL) {
-        *numLines = 0;
-        while (*numLines < 100 && fgets(textLines[*numLines].text, sizeof(textLines[*numLines].text), file) != NULL) {
-            // Supprimer le saut de ligne du texte lu depuis le fichier
-            textLines[*numLines].text[strcspn(textLines[*numLines].text, "\n")] = '\0';
-            ++(*numLines);
+// Fonction pour afficher les tâches d'une colonne (toutes si column vaut -1), une par ligne :
+// numéro, colonne et texte (retours à la ligne écrits \n)
+bool listCliTasks(OpenBoard *open, int column) {
+    static const char *columnNames[3] = {"todo", "doing", "done"};
+    if (!loadWholeDoneColumn(open)) {
+        return false;
+    }
+    Board *boards[2] = {&open->tasks, &open->done};
+    int number = 0;
+    for (int b = 0; b < 2; ++b) {
+        if (!orderBoardTasks(boards[b])) {
+            return false;
         }
-        fclose(file);
-        printf("Tasks loaded from file.\n");
+        for (int k = 0; k < boards[b]->numOrdered; ++k, ++number) {
+            const TextLine *line = boards[b]->order[k];
+            if (column >= 0 && line->column != column) {
+                continue;
+            }
+            printf("%d\t%s\t", number, columnNames[line->column >= 0 && line->column < 3 ? line->column : 0]);
+            for (const char *p = line->text; *p != '\0'; ++p) {
+                if (*p == '\n') {
+                    fputs("\\n", stdout);
+                } else {
+                    putchar(*p);
+                }
+            }
+            putchar('\n');
+        }
+    }
+    return true;
+}
 
-        // Mettre à jour les zones de texte après le chargement des tâches
-        for (int i = 0; i < *numLines; ++i) {
-            textLines[i].rect = (SDL_Rect){10, 40 + i * (MIN_TEXTBOX_HEIGHT + 5), TEXTBOX_WIDTH, MIN_TEXTBOX_HEIGHT};
-            textLines[i].isEditing = false;
-            textLines[i].isDragging = false;
-            textLines[i].inputText[0] = '\0';
+// Fonction pour exporter les tâches d'un tableau ouvert (actives, archivées puis de la colonne
+// "Done", dans l'ordre d'affichage) en CSV ou JSON (selon l'extension), vers la sortie
+// standard si aucun fichier n'est donné
+bool exportCliTasks(OpenBoard *open, const char *path) {
+    ExportWriter writer = {0};
+    const char *extension = path != NULL ? strrchr(path, '.') : NULL;
+    writer.json = extension != NULL && strcmp(extension, ".json") == 0;
+    writer.file = path != NULL ? fopen(path, "wb") : stdout;
+    if (writer.file == NULL) {
+        printf("Error opening %s for writing.\n", path);
+        return false;
+    }
+    Board *archive = &open->archive;
+    bool ok = loadWholeDoneColumn(open) &&
+              (archive->baseIndex == 0 || (loadEarlierPages(archive, archive->baseIndex / RECORDS_PER_PAGE) && archive->baseIndex == 0));
+    fputs(writer.json ? "[" : "column,text,created_at,done_at\n", writer.file);
+    Board *boards[3] = {&open->tasks, archive, &open->done};
+    for (int b = 0; b < 3 && ok; ++b) {
+        ok = orderBoardTasks(boards[b]);
+        for (int k = 0; ok && k < boards[b]->numOrdered; ++k) {
+            ok = writeExportTask(boards[b]->order[k], &writer);
         }
-    } else {
-        printf("Error opening tasks.txt for reading.\n");
     }
+    if (writer.json) {
+        fputs(writer.count > 0 ? "\n]\n" : "]\n", writer.file);
+    }
+    if (path != NULL && fclose(writer.file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        printf("Error writing %s.\n", path != NULL ? path : "tasks");
+    }
+    return ok;
 }
 
-// Fonction pour afficher un texte avec fond coloré
-void renderText(SDL_Renderer *rend, TTF_Font *font, const char *text, SDL_Rect rect, SDL_Color textColor, SDL_Color backgroundColor, bool isEditing, bool isDragging) {
-    // Dessiner le rectangle de fond
-    SDL_SetRenderDrawColor(rend, backgroundColor.r, backgroundColor.g, backgroundColor.b, backgroundColor.a);
-    SDL_RenderFillRect(rend, &rect);
+// Fonction pour exécuter une commande sur un tableau ouvert (args[0] : nom de la commande).
+// Les modifications ne sont enregistrées qu'à la fermeture du tableau.
+bool runCliCommand(OpenBoard *open, int numArgs, const char **args) {
+    const char *command = args[0];
+    Board *board;
+    int index;
+    if (strcmp(command, "add") == 0 && (numArgs == 2 || numArgs == 3)) {
+        int column = numArgs == 3 ? parseColumnName(args[2]) : 0;
+        if (column < 0) {
+            printf("Unknown column %s.\n", args[2]);
+            return false;
+        }
+        TextLine task = {0};
+        SDL_strlcpy(task.text, args[1], MAX_TEXT_LENGTH);
+        task.column = column;
+        task.createdAt = (Uint32)time(NULL);
+        task.doneAt = column == DONE_COLUMN ? task.createdAt : 0;
+        return appendTask(column == DONE_COLUMN ? &open->done : &open->tasks, &task) != NULL;
+    }
+    if (strcmp(command, "list") == 0 && numArgs <= 2) {
+        int column = numArgs == 2 ? parseColumnName(args[1]) : -1;
+        if (numArgs == 2 && column < 0) {
+            printf("Unknown column %s.\n", args[1]);
+            return false;
+        }
+        return listCliTasks(open, column);
+    }
+    if (strcmp(command, "move") == 0 && numArgs == 3) {
+        int column = parseColumnName(args[2]);
+        if (column < 0) {
+            printf("Unknown column %s.\n", args[2]);
+            return false;
+        }
+        return findCliTask(open, args[1], &board, &index) && moveTask(open, board, index, column) != NULL;
+    }
+    if (strcmp(command, "delete") == 0 && numArgs == 2) {
+        if (!findCliTask(open, args[1], &board, &index)) {
+            return false;
+        }
+        removeTask(open, board, index);
+        return true;
+    }
+    if (strcmp(command, "export") == 0 && numArgs <= 2) {
+        return exportCliTasks(open, numArgs == 2 ? args[1] : NULL);
+    }
+    printf("Usage: todo add <text> [todo|doing|done] | list [column] | move <task> <column> | delete <task> | export [file] | batch\n");
+    return false;
+}
 
-    SDL_SetRenderDrawColor(rend, textColor.r, textColor.g, textColor.b, textColor.a);
-    SDL_RenderDrawRect(rend, &rect);
+// Fonction pour découper une ligne de commandes en mots, séparés par des espaces. Un mot
+// entre guillemets peut contenir des espaces ; \" et \\ y désignent un guillemet et une
+// barre oblique inverse. La ligne est modifiée sur place.
+int splitCliLine(char *line, const char **args, int maxArgs) {
+    int numArgs = 0;
+    char *p = line;
+    while (true) {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+            ++p;
+        }
+        if (*p == '\0' || numArgs == maxArgs) {
+            return *p == '\0' ? numArgs : -1;
+        }
+        args[numArgs++] = p;
+        char *out = p;
+        if (*p == '"') {
+            for (++p; *p != '"'; ++p) {
+                if (*p == '\0') {
+                    return -1;
+                }
+                if (*p == '\\' && (p[1] == '"' || p[1] == '\\')) {
+                    ++p;
+                }
+                *out++ = *p;
+            }
+            ++p;
+        } else {
+            while (*p != '\0' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+                *out++ = *p++;
+            }
+        }
+        bool last = *p == '\0';
+        *out = '\0';
+        if (last) {
+            return numArgs;
+        }
+        ++p;
+    }
+}
 
-    // Copier la chaîne de texte dans une nouvelle mémoire tampon pour éviter les problèmes avec strtok
-    char textBuffer[MAX_TEXT_LENGTH];
-    strncpy(textBuffer, text, MAX_TEXT_LENGTH);
-    textBuffer[MAX_TEXT_LENGTH - 1] = '\0';
+// Fonction pour exécuter une commande sans fenêtre (ni SDL_Init, ni police) sur un tableau.
+// "batch" lit une commande par ligne sur l'entrée standard et enregistre les modifications
+// à la fin ; la lecture s'arrête à la première commande qui échoue et le tableau est fermé
+// sans enregistrer. Chaque fichier est enregistré séparément : une interruption pendant
+// l'enregistrement peut en laisser un à jour et l'autre non. Dans un tableau partagé, les
+// modifications partent au serveur par lots.
+int runCli(const char *name, int numArgs, const char **args) {
+    OpenBoard *open = openBoard(name, 0, true);
+    if (open == NULL) {
+        return 1;
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+    bool ok = true;
+    int numCommands = 0;
+    if (strcmp(args[0], "batch") == 0 && numArgs == 1) {
+        char line[MAX_TEXT_LENGTH + 64];
+        const char *lineArgs[4];
+        int lineNumber = 0;
+        while (ok && fgets(line, sizeof(line), stdin) != NULL) {
+            lineNumber++;
+            if (strchr(line, '\n') == NULL && !feof(stdin)) {
+                printf("Line %d is too long.\n", lineNumber);
+                ok = false;
+                break;
+            }
+            int count = splitCliLine(line, lineArgs, 4);
+            if (count == 0 || (count > 0 && lineArgs[0][0] == '#')) {
+                continue;
+            }
+            ok = count > 0 && runCliCommand(open, count, lineArgs);
+            if (!ok) {
+                printf("Error in command on line %d, stopping without saving.\n", lineNumber);
+            }
+            numCommands++;
+        }
+    } else {
+        ok = runCliCommand(open, numArgs, args);
+        numCommands = 1;
+    }
 
-    char *token = strtok(textBuffer, "\n");
-    int totalHeight = 0;
+    // Enregistrer les fichiers (ou attendre que le serveur ait accepté les modifications)
+    if (!ok) {
+        discardBoard(open);
+        return 1;
+    }
+    finishBoardSync(open);
+    if (open->sync.role == SYNC_CLIENT && (open->sync.lost || open->sync.batchesAcked != open->sync.batchesSent)) {
+        printf("Board %s is shared and its server did not accept the changes.\n", name);
+        ok = false;
+    }
+    closeBoard(open);
+    if (ok && strcmp(args[0], "batch") == 0) {
+        double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+        printf("%d commands applied to %s (%.0f commands/s).\n", numCommands, name, numCommands / (seconds > 0 ? seconds : 1e-9));
+    }
+    return ok ? 0 : 1;
+}
 
-    while (token != NULL) {
-        SDL_Surface *textSurface = TTF_RenderText_Blended_Wrapped(font, token, textColor, rect.w - 20);
-        SDL_Texture *textTexture = SDL_CreateTextureFromSurface(rend, textSurface);
-        SDL_FreeSurface(textSurface);
+// Structure pour les options du générateur de tableaux
+typedef struct {
+    int numTasks;
+    int columns[3];       // Part de chaque colonne (poids relatifs)
+    int textLength;       // Longueur moyenne des textes, en octets
+    int multiLine;        // Part des textes sur plusieurs lignes, en %
+    int utf8;             // Part des mots non ASCII, en %
+    int numTags;          // Nombre d'étiquettes différentes (0 : aucune)
+    int days;             // Les dates sont réparties sur ces derniers jours
+    int history;          // Versions enregistrées dans la chronologie après la génération
+    Uint32 seed;
+    const char *textPath; // Copie CSV ou JSON (selon l'extension), NULL sinon
+    bool overwrite;
+} GeneratorOptions;
 
-        int text_width, text_height;
-        SDL_QueryTexture(textTexture, NULL, NULL, &text_width, &text_height);
+// Fonction pour lire les options du générateur (--generate <nombre> [options])
+bool parseGeneratorOptions(GeneratorOptions *options, int argc, char *argv[]) {
+    memset(options, 0, sizeof(*options));
+    options->numTasks = argc > 2 ? atoi(argv[2]) : 0;
+    options->columns[0] = 30;
+    options->columns[1] = 20;
+    options->columns[2] = 50;
+    options->textLength = GENERATOR_TEXT_LENGTH;
+    options->multiLine = GENERATOR_MULTILINE_PERCENT;
+    options->utf8 = GENERATOR_UTF8_PERCENT;
+    options->numTags = GENERATOR_TAGS;
+    options->days = GENERATOR_DAYS;
+    options->seed = 2463534242u;
+    bool ok = argc > 2 && options->numTasks >= 0 && strspn(argv[2], "0123456789") == strlen(argv[2]);
+    for (int i = 3; i < argc && ok; ++i) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--overwrite") == 0) {
+            options->overwrite = true;
+            continue;
+        }
+        if (value == NULL) {
+            ok = false;
+        } else if (strcmp(argv[i], "--columns") == 0) {
+            ok = sscanf(value, "%d,%d,%d", &options->columns[0], &options->columns[1], &options->columns[2]) == 3 &&
+                 options->columns[0] >= 0 && options->columns[1] >= 0 && options->columns[2] >= 0 &&
+                 options->columns[0] + options->columns[1] + options->columns[2] > 0;
+        } else if (strcmp(argv[i], "--text-length") == 0) {
+            options->textLength = atoi(value);
+            ok = options->textLength > 0 && options->textLength < MAX_TEXT_LENGTH;
+        } else if (strcmp(argv[i], "--multiline") == 0) {
+            options->multiLine = atoi(value);
+        } else if (strcmp(argv[i], "--utf8") == 0) {
+            options->utf8 = atoi(value);
+        } else if (strcmp(argv[i], "--tags") == 0) {
+            options->numTags = atoi(value);
+            ok = options->numTags >= 0 && options->numTags < 1000000;
+        } else if (strcmp(argv[i], "--days") == 0) {
+            options->days = atoi(value);
+            ok = options->days > 0;
+        } else if (strcmp(argv[i], "--history") == 0) {
+            options->history = atoi(value);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            options->seed = (Uint32)strtoul(value, NULL, 10);
+            options->seed = options->seed != 0 ? options->seed : 2463534242u;
+        } else if (strcmp(argv[i], "--text") == 0) {
+            options->textPath = value;
+        } else if (strcmp(argv[i], "--board") != 0) {
+            ok = false;
+        }
+        ++i;
+    }
+    if (!ok) {
+        printf("Usage: --generate <tasks> [--board name] [--columns 30,20,50] [--text-length 40] [--multiline 5] [--utf8 10]\n"
+               "       [--tags 50] [--days 365] [--history 0] [--seed n] [--text copy.csv|copy.json] [--overwrite]\n");
+    }
+    return ok;
+}
 
-        SDL_Rect renderQuad = {rect.x + 10, rect.y + 5 + totalHeight, text_width, text_height};
-        SDL_RenderCopy(rend, textTexture, NULL, &renderQuad);
+// Fonction pour tirer un nombre pseudo-aléatoire (xorshift32 : la même graine donne le même tableau)
+Uint32 nextRandom(Uint32 *state) {
+    Uint32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
 
-        SDL_DestroyTexture(textTexture);
+// Fonction pour composer le texte d'une tâche générée : mots ASCII ou UTF-8 (jamais coupés),
+// parfois sur plusieurs lignes, puis quelques étiquettes, les plus fréquentes en premier
+void generateTaskText(char text[MAX_TEXT_LENGTH], const GeneratorOptions *options, Uint32 *seed) {
+    static const char *const words[] = {"review", "fix", "update", "write", "call", "plan", "check", "deploy",
+                                        "design", "test", "report", "budget", "meeting", "release", "invoice", "draft",
+                                        "server", "client", "backup", "notes", "the", "for", "with", "before"};
+    static const char *const utf8Words[] = {"café", "réunion", "Überprüfung", "naïve", "façade", "straße", "año",
+                                            "日本語", "задача", "προθεσμία", "✓", "📌"};
+    Uint32 r = nextRandom(seed);
+    // Longueur visée : autour de la moyenne, avec quelques textes très longs
+    int target = r % 50 == 0 ? MAX_TEXT_LENGTH - 1 : 1 + (int)(nextRandom(seed) % (Uint32)options->textLength) + (int)(nextRandom(seed) % (Uint32)options->textLength);
+    bool multiLine = (int)(r >> 8) % 100 < options->multiLine;
+    int numTags = options->numTags > 0 ? (int)(r >> 16) % 4 : 0;
+    int room = MAX_TEXT_LENGTH - 1 - numTags * 12;
+    target = target < room ? target : room;
 
-        // Passer au jeton suivant
-        token = strtok(NULL, "\n");
-        if (token != NULL) {
-            // Ajouter la hauteur de la ligne à la hauteur totale
-            totalHeight += text_height;
+    int length = 0;
+    int wordsOnLine = 0;
+    while (length < target) {
+        Uint32 pick = nextRandom(seed);
+        const char *word = (int)(pick % 100) < options->utf8 ? utf8Words[(pick >> 8) % SDL_arraysize(utf8Words)] : words[(pick >> 8) % SDL_arraysize(words)];
+        int wordLength = (int)strlen(word);
+        if (length > 0 && length + 1 + wordLength > target) {
+            break;
         }
+        if (length > 0) {
+            text[length++] = multiLine && wordsOnLine >= 3 && (pick >> 24) % 3 == 0 ? '\n' : ' ';
+            wordsOnLine = text[length - 1] == '\n' ? 0 : wordsOnLine;
+        }
+        memcpy(text + length, word, (size_t)wordLength);
+        length += wordLength;
+        wordsOnLine++;
+    }
+    for (int t = 0; t < numTags; ++t) {
+        Uint32 a = nextRandom(seed) % (Uint32)options->numTags;
+        Uint32 b = nextRandom(seed) % (Uint32)options->numTags;
+        length += SDL_snprintf(text + length, (size_t)(MAX_TEXT_LENGTH - length), " #tag%u", (unsigned)(a * b / (Uint32)options->numTags));
     }
+    text[length] = '\0';
 }
 
+// Fonction pour générer un tableau de test : les tâches sont enregistrées par lots comme pour
+// un import (mémoire constante quel que soit leur nombre), avec une copie CSV ou JSON si
+// demandé, puis le tableau est ouvert pour enregistrer des versions dans sa chronologie
+int runGenerate(const BoardFiles *files, const GeneratorOptions *options) {
+    const char *paths[6] = {files->tasks, files->done, files->archive, files->inbox, files->timelineLog, files->timelinePages};
+    for (int i = 0; i < 6; ++i) {
+        SDL_RWops *rw = SDL_RWFromFile(paths[i], "rb");
+        if (rw != NULL) {
+            SDL_RWclose(rw);
+            if (!options->overwrite) {
+                printf("Board %s already exists (use --overwrite to replace it).\n", files->name);
+                return 1;
+            }
+            remove(paths[i]);
+        }
+    }
 
+    ImportBatch batch = {0};
+    batch.tasks = SDL_malloc(IMPORT_BATCH_SIZE * sizeof(TextLine));
+    ExportWriter writer = {0};
+    if (options->textPath != NULL) {
+        const char *extension = strrchr(options->textPath, '.');
+        writer.json = extension != NULL && strcmp(extension, ".json") == 0;
+        writer.file = fopen(options->textPath, "wb");
+        if (writer.file == NULL) {
+            printf("Error opening %s for writing.\n", options->textPath);
+            SDL_free(batch.tasks);
+            return 1;
+        }
+        fputs(writer.json ? "[" : "column,text,created_at,done_at\n", writer.file);
+    }
+    if (batch.tasks == NULL) {
+        printf("Error allocating memory for %d tasks.\n", IMPORT_BATCH_SIZE);
+        if (writer.file != NULL) {
+            fclose(writer.file);
+        }
+        return 1;
+    }
+    Board board = {0};
+    Board done = {0};
+    board.path = files->tasks;
+    done.path = files->done;
+    done.appendOnly = true;
+    board.store.rewriteAll = done.store.rewriteAll = true;
+    board.store.quiet = done.store.quiet = true;
+    batch.board = &board;
+    batch.done = &done;
 
+    // Dates croissantes sur la période : la colonne "Done" reste triée par date de fin
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint32 seed = options->seed;
+    Uint32 now = (Uint32)time(NULL);
+    Uint32 span = (Uint32)options->days * 86400;
+    int totalWeight = options->columns[0] + options->columns[1] + options->columns[2];
+    int numDone = 0;
+    bool ok = true;
+    for (int i = 0; i < options->numTasks && ok && !batch.failed; ++i) {
+        TextLine *task = &batch.tasks[batch.count++];
+        memset(task, 0, sizeof(*task));
+        int pick = (int)(nextRandom(&seed) % (Uint32)totalWeight);
+        task->column = pick < options->columns[0] ? 0 : (pick < options->columns[0] + options->columns[1] ? 1 : DONE_COLUMN);
+        Uint32 date = now - span + (Uint32)((Uint64)i * span / (Uint64)options->numTasks);
+        if (task->column == DONE_COLUMN) {
+            task->doneAt = date;
+            task->createdAt = date - nextRandom(&seed) % (14 * 86400);
+            numDone++;
+        } else {
+            task->createdAt = date;
+        }
+        generateTaskText(task->text, options, &seed);
+        if (writer.file != NULL) {
+            ok = writeExportTask(task, &writer);
+        }
+        if (batch.count == IMPORT_BATCH_SIZE) {
+            flushImportBatch(&batch);
+        }
+    }
+    flushImportBatch(&batch);
+    ok = ok && !batch.failed;
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    Uint64 bytes = (Uint64)(countPages(board.numLines) + countPages(done.numLines)) * PAGE_SIZE;
+    freeBoard(&board);
+    freeBoard(&done);
+    SDL_free(batch.tasks);
+    if (writer.file != NULL) {
+        if (writer.json) {
+            fputs(writer.count > 0 ? "\n]\n" : "]\n", writer.file);
+        }
+        if (fclose(writer.file) != 0) {
+            ok = false;
+        }
+    }
+    if (!ok) {
+        printf("Error generating board %s.\n", files->name);
+        return 1;
+    }
+    printf("%d tasks generated in %s (%d active, %d done) in %.2f s (%.1f MB/s).\n", options->numTasks, files->name,
+           options->numTasks - numDone, numDone, seconds, bytes / 1e6 / (seconds > 0 ? seconds : 1e-9));
 
-// Fonction pour obtenir la hauteur d'une ligne de texte
-int getTextLineHeight(TTF_Font *font) {
-    // Utiliser la police pour obtenir la hauteur de ligne
-    return TTF_FontHeight(font);
+    // Historique : modifications enregistrées une à une, chacune devenant une version de la chronologie
+    if (options->history > 0) {
+        OpenBoard *open = openBoard(files->name, 0, true);
+        if (open == NULL) {
+            return 1;
+        }
+        Board *tasks = &open->tasks;
+        for (int k = 0; k < options->history && ok; ++k) {
+            for (int m = 0; m < 3 && ok; ++m) {
+                Uint32 r = nextRandom(&seed);
+                int i = tasks->numLines > 0 ? nextLiveTask(tasks, (int)(r % (Uint32)tasks->numLines)) : -1;
+                int action = i >= 0 ? (int)(r >> 24) % 6 : 5;
+                if (action < 3) {
+                    char text[MAX_TEXT_LENGTH];
+                    generateTaskText(text, options, &seed);
+                    setTaskText(tasks, i, text);
+                } else if (action == 3) {
+                    setTaskColumn(tasks, i, 1 - tasks->lines[i].column);
+                } else if (action == 4) {
+                    ok = transferTask(tasks, i, &open->done, DONE_COLUMN);
+                } else {
+                    TextLine line = {0};
+                    line.createdAt = (Uint32)time(NULL);
+                    generateTaskText(line.text, options, &seed);
+                    ok = appendTask(tasks, &line) != NULL;
+                }
+            }
+            saveOpenBoard(open);
+        }
+        closeBoard(open);
+        if (!ok) {
+            printf("Error generating the history of board %s.\n", files->name);
+            return 1;
+        }
+        printf("%d versions added to the timeline of %s.\n", options->history, files->name);
+    }
+    return 0;
 }
 
+int main(int argc, char *argv[]) {
 
+    // Nombre de jours après lequel une tâche terminée part dans l'archive (0 : jamais)
+    int archiveDays = DEFAULT_ARCHIVE_DAYS;
+    // Tableaux proposés (--board, plusieurs fois possible) et budget mémoire de leur cache
+    const char *boardNames[MAX_OPEN_BOARDS] = {DEFAULT_BOARD_NAME};
+    int numBoardNames = 0;
+    int cacheMegabytes = DEFAULT_CACHE_MB;
+    // Enregistrement (--record) ou relecture (--replay, --max-speed pour ne pas attendre) des événements
+    const char *recordPath = NULL;
+    const char *replayPath = NULL;
+    bool maxSpeed = false;
+    // Comptage des allocations (--alloc-stats), installé avant tout appel à SDL
+    bool allocCounting = false;
+    // Affichage sans attendre la fin de la pause quand une saisie arrive (--low-latency), et
+    // latence des saisies affichée à la sortie (--latency-stats)
+    bool lowLatency = false;
+    bool latencyStats = false;
+    for (int i = 1; i < argc; ++i) {
+        maxSpeed = maxSpeed || strcmp(argv[i], "--max-speed") == 0;
+        lowLatency = lowLatency || strcmp(argv[i], "--low-latency") == 0;
+        latencyStats = latencyStats || strcmp(argv[i], "--latency-stats") == 0;
+        allocCounting = allocCounting || strcmp(argv[i], "--alloc-stats") == 0 || strcmp(argv[i], "--check-allocs") == 0;
+    }
+    if (allocCounting && !startAllocStats()) {
+        return 1;
+    }
+    for (int i = 1; i < argc - 1; ++i) {
+        if (strcmp(argv[i], "--archive-after") == 0) {
+            archiveDays = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--board") == 0 && numBoardNames < MAX_OPEN_BOARDS) {
+            boardNames[numBoardNames++] = argv[i + 1];
+        } else if (strcmp(argv[i], "--cache-mb") == 0) {
+            cacheMegabytes = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--record") == 0) {
+            recordPath = argv[i + 1];
+        } else if (strcmp(argv[i], "--replay") == 0) {
+            replayPath = argv[i + 1];
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            startTrace(argv[i + 1]);
+        }
+    }
+    numBoardNames = numBoardNames > 0 ? numBoardNames : 1;
+    BoardFiles files;
+    if (!setBoardFiles(&files, boardNames[0])) {
+        return 1;
+    }
 
-int main(int argc, char *argv[]) {
+    // Mode benchmark : pas de fenêtre
+    if (argc > 1 && strcmp(argv[1], "--bench-save") == 0) {
+        return runSaveBenchmark(argc > 2 ? atoi(argv[2]) : 1000000);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-search") == 0) {
+        return runSearchBenchmark(argc > 2 ? atoi(argv[2]) : 1000000);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-tags") == 0) {
+        return runTagBenchmark(argc > 2 ? atoi(argv[2]) : 1000000);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-query") == 0) {
+        return runQueryBenchmark(argc > 2 ? atoi(argv[2]) : 1000000);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-undo") == 0) {
+        return runUndoBenchmark(argc > 2 ? atoi(argv[2]) : 1000000);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-timeline") == 0) {
+        return runTimelineBenchmark(argc > 2 ? atoi(argv[2]) : 10000);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-sync") == 0) {
+        return runSyncBenchmark(argc > 2 ? atoi(argv[2]) : 4, argc > 3 ? atoi(argv[3]) : 2000);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-crdt") == 0) {
+        return runCrdtBenchmark(argc > 2 ? atoi(argv[2]) : 8, argc > 3 ? atoi(argv[3]) : 10000);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-render") == 0) {
+        return runRenderBenchmark(argc > 2 ? atoi(argv[2]) : 1000000, argc > 3 ? atoi(argv[3]) : 300, argc > 4 ? argv[4] : FONT_PATH);
+    }
+    if (argc > 1 && strcmp(argv[1], "--check-allocs") == 0) {
+        return runAllocCheck(argc > 2 ? atoi(argv[2]) : 300, argc > 3 ? argv[3] : FONT_PATH);
+    }
+    if (argc > 1 && strcmp(argv[1], "--check-render") == 0) {
+        bool update = false;
+        for (int i = 2; i < argc; ++i) {
+            update = update || strcmp(argv[i], "--update-golden") == 0;
+        }
+        const char *goldenPath = argc > 2 && strncmp(argv[2], "--", 2) != 0 ? argv[2] : RENDER_GOLDEN_PATH;
+        const char *fontPath = argc > 3 && strncmp(argv[3], "--", 2) != 0 ? argv[3] : FONT_PATH;
+        return runRenderCheck(goldenPath, update, fontPath);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-palette") == 0) {
+        return runPaletteBenchmark(argc > 2 ? atoi(argv[2]) : 1000000);
+    }
+    if (argc > 1 && strcmp(argv[1], "--generate") == 0) {
+        GeneratorOptions options;
+        return parseGeneratorOptions(&options, argc, argv) ? runGenerate(&files, &options) : 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "--verify") == 0) {
+        return runVerify(argc > 2 && strncmp(argv[2], "--", 2) != 0 ? argv[2] : files.tasks);
+    }
+    if (argc > 1 && strcmp(argv[1], "--archive") == 0) {
+        return runArchive(&files, archiveDays > 0 ? archiveDays : DEFAULT_ARCHIVE_DAYS);
+    }
+    if (argc > 2 && strcmp(argv[1], "--import") == 0) {
+        return runImport(&files, argv[2]);
+    }
+    if (argc > 2 && strcmp(argv[1], "--export") == 0) {
+        return runExport(&files, argv[2]);
+    }
+
+    // Commandes sans fenêtre (todo add/list/move/delete/export/batch), les options pouvant
+    // être placées avant ou après
+    // (au-delà de 4 mots, la commande est refusée avec son message d'usage)
+    const char *cliArgs[5];
+    int numCliArgs = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--archive-after") == 0 || strcmp(argv[i], "--board") == 0 || strcmp(argv[i], "--cache-mb") == 0 ||
+            strcmp(argv[i], "--record") == 0 || strcmp(argv[i], "--replay") == 0 || strcmp(argv[i], "--trace") == 0) {
+            ++i;
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            continue;
+        } else if (numCliArgs < 5) {
+            cliArgs[numCliArgs++] = argv[i];
+        }
+    }
+    if (numCliArgs > 0) {
+        const char *commands[6] = {"add", "list", "move", "delete", "export", "batch"};
+        for (int c = 0; c < 6; ++c) {
+            if (strcmp(cliArgs[0], commands[c]) == 0) {
+                return runCli(files.name, numCliArgs, cliArgs);
+            }
+        }
+    }
 
     SDL_Window *wind;
     SDL_Renderer *rend;
@@ -145,7 +11030,8 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    Uint32 render_flags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
+    // Une relecture à vitesse maximale n'attend pas l'écran
+    Uint32 render_flags = SDL_RENDERER_ACCELERATED | (replayPath != NULL && maxSpeed ? 0 : SDL_RENDERER_PRESENTVSYNC);
     rend = SDL_CreateRenderer(wind, -1, render_flags);
     if (!rend) {
         printf("Error creating renderer: %s\n", SDL_GetError());
@@ -162,7 +11048,7 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    font = TTF_OpenFont("C:\\SDL\\todolist\\Roboto-Regular.ttf", 30);
+    font = TTF_OpenFont(FONT_PATH, FONT_SIZE);
     if (!font) {
         printf("Error loading font: %s\n", TTF_GetError());
         TTF_Quit();
@@ -172,282 +11058,429 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    // Définir les couleurs pour chaque colonne
-    SDL_Color colorToDo = {221, 221, 221, 255}; // Rouge
-    SDL_Color colorInProgress = {128, 234, 250, 255}; // Vert
-    SDL_Color colorDone = {175, 239, 196, 255}; // Bleu
+    // Fils de rendu des textes : la première image d'un grand tableau n'attend pas le rendu
+    // de tous ses textes (sans fil, les textes sont rendus par l'interface)
+    TextRaster *raster = createTextRaster(FONT_PATH, FONT_SIZE);
+    if (raster == NULL) {
+        printf("Text rendering threads unavailable, rendering text on the main thread\n");
+    }
 
     // Initialiser les colonnes avec leurs couleurs
     Column columns[3];
-    columns[0].rect = (SDL_Rect){0, 0, WIDTH / 3, HEIGHT};
-    columns[0].numLines = 0;
-    strcpy(columns[0].title, "To Do");
-    columns[0].color = colorToDo;
+    initColumns(columns);
 
-    columns[1].rect = (SDL_Rect){WIDTH / 3, 0, WIDTH / 3, HEIGHT};
-    columns[1].numLines = 0;
-    strcpy(columns[1].title, "In Progress");
-    columns[1].color = colorInProgress;
+    Uint32 archiveCutoff = (Uint32)time(NULL) - (Uint32)archiveDays * 86400;
+    if (archiveDays <= 0) {
+        archiveCutoff = 0;
+    }
 
-    columns[2].rect = (SDL_Rect){2 * WIDTH / 3, 0, WIDTH / 3, HEIGHT};
-    columns[2].numLines = 0;
-    strcpy(columns[2].title, "Done");
-    columns[2].color = colorDone;
+    // Ouvrir le premier tableau : tâches depuis le fichier paginé, ou depuis l'ancien fichier
+    // texte, et seules les dernières pages de la colonne "Done". Le fichier texte n'est plus
+    // réécrit : il sert de boîte de réception aux scripts.
+    BoardCache boardCache = {0};
+    boardCache.budget = (size_t)(cacheMegabytes > 0 ? cacheMegabytes : DEFAULT_CACHE_MB) << 20;
+    int currentName = 0;
+    OpenBoard *current = switchBoard(&boardCache, boardNames[currentName], archiveCutoff);
+    if (current == NULL) {
+        destroyTextRaster(raster);
+        TTF_CloseFont(font);
+        TTF_Quit();
+        SDL_DestroyRenderer(rend);
+        SDL_DestroyWindow(wind);
+        SDL_Quit();
+        return 1;
+    }
+    char windowTitle[MAX_BOARD_NAME + 16];
+    SDL_snprintf(windowTitle, sizeof(windowTitle), "To Do List - %s", current->files.name);
+    SDL_SetWindowTitle(wind, windowTitle);
 
-    TextLine textLines[100]; // Tableau de 100 lignes pour les zones de texte
-    int numLines = 0;
-    loadTasksFromFile(textLines, &numLines);
+    // Tableaux affichés : tâches actives puis colonne "Done"
+    Board *boards[2] = {&current->tasks, &current->done};
 
-    bool running = true;
-    SDL_Event event;
+    // Recherche (Ctrl+F) : les tâches trouvées sont surlignées
+    bool searching = false;
+    char searchQuery[MAX_TEXT_LENGTH] = "";
 
-    FILE *file = NULL;
+    // Vue filtrée par étiquettes (Ctrl+T) : seules les tâches de la vue sont affichées
+    bool filterEditing = false;
+    bool filterValid = true;
+    char filterQuery[MAX_FILTER_LENGTH] = "";
 
-    // Chargez les tâches depuis le fichier
-    file = fopen("tasks.txt", "r");
-    if (file != NULL) {
-        numLines = 0;
-        while (numLines < 100 && fscanf(file, "%d %[^\n]", &textLines[numLines].column, textLines[numLines].text) == 2) {
-            ++numLines;
-        }
-        fclose(file);
-        printf("Tasks loaded from file.\n");
+    // Palette de commandes (Ctrl+P)
+    Palette palette = {0};
+    palette.results = SDL_malloc(PALETTE_MAX_RESULTS * sizeof(PaletteResult));
 
-        // Mettez à jour les zones de texte après le chargement des tâches
-        for (int i = 0; i < numLines; ++i) {
-            textLines[i].rect = (SDL_Rect){10, 40 + i * (MIN_TEXTBOX_HEIGHT + 5), TEXTBOX_WIDTH, MIN_TEXTBOX_HEIGHT};
-            textLines[i].isEditing = false;
-            textLines[i].isDragging = false;
-            textLines[i].inputText[0] = '\0';
-        }
-    } else {
-        printf("Error opening tasks.txt for reading.\n");
+    // Chronologie (Ctrl+H) : versions enregistrées du tableau, affichées en lecture seule.
+    // Le tableau est enregistré toutes les AUTOSAVE_SECONDS secondes s'il a changé.
+    TimelineView timeline = {0};
+    Uint32 lastAutosave = SDL_GetTicks();
+
+    EventLog eventLog = {0};
+    bool eventLogOk = true;
+    if (replayPath != NULL) {
+        eventLogOk = startEventReplay(&eventLog, replayPath, current, maxSpeed);
+    } else if (recordPath != NULL) {
+        eventLogOk = startEventRecording(&eventLog, recordPath, current);
     }
+    bool running = eventLogOk;
+    SDL_Event event;
 
     bool somethingChanged = false;
+    AllocOverlay allocOverlay = {0};
+    PerfHud hud = {0};
+    InputLatency latency = {0};
 
     while (running) {
+        setAllocZone(ALLOC_UPDATE);
+        // Durée de chaque phase de l'image, pour l'affichage des performances (F3)
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        Uint64 phaseStart = frameStart;
+        Uint64 phaseTicks[HUD_PHASES] = {0};
+        int numEvents = 0;
+        Uint64 frameZone = beginTraceZone();
+        Uint64 zone = beginTraceZone();
+
+        // Événements relus de cette image, placés dans la file avant les vraies saisies
+        eventLog.frame++;
+        replayEvents(&eventLog);
+
+        // Prendre en compte les tâches ajoutées ou modifiées dans tasks.txt par d'autres programmes
+        // (par le serveur seulement si le tableau est partagé avec d'autres instances)
+        current->textCache.frame++;
+        current->textCache.raster = raster;
+        if (current->sync.role != SYNC_CLIENT && checkInbox(&current->inbox) &&
+            syncInbox(&current->inbox, &current->tasks, &current->done) > 0) {
+            scrollDoneColumn(&current->done, &current->doneScroll);
+        }
+        // Échanger les modifications avec les autres instances qui ont ouvert les mêmes tableaux
+        Uint64 syncZone = beginTraceZone();
+        for (int i = 0; i < boardCache.count; ++i) {
+            if (pollBoardSync(boardCache.boards[i], archiveCutoff) && boardCache.boards[i] == current) {
+                scrollDoneColumn(&current->done, &current->doneScroll);
+            }
+        }
+        endTraceZone(syncZone, "sync");
+        // Relancer la recherche si des tâches ont été ajoutées, modifiées ou supprimées
+        if (searching && (current->taskIndex.stale || current->doneIndex.stale)) {
+            updateSearch(current, searchQuery);
+        }
+        verifySearchMatches(&current->taskIndex, &current->tasks, SEARCH_VERIFY_PER_FRAME);
+        verifySearchMatches(&current->doneIndex, &current->done, SEARCH_VERIFY_PER_FRAME);
+        applyPendingPostings(&current->taskIndex, INDEX_CHANGES_PER_FRAME);
+        applyPendingPostings(&current->doneIndex, INDEX_CHANGES_PER_FRAME);
+        if (SDL_GetTicks() - lastAutosave >= AUTOSAVE_SECONDS * 1000) {
+            setAllocZone(ALLOC_STORAGE);
+            saveOpenBoard(current);
+            lastAutosave = SDL_GetTicks();
+        }
+
+        phaseTicks[HUD_UPDATE] = SDL_GetPerformanceCounter() - phaseStart;
+        phaseStart += phaseTicks[HUD_UPDATE];
+        endTraceZone(zone, "update");
+        zone = beginTraceZone();
+
+        setAllocZone(ALLOC_EVENTS);
         while (SDL_PollEvent(&event)) {
+            numEvents++;
+            noteInputLatency(&latency, &event);
+            recordEvent(&eventLog, &event);
             if (event.type == SDL_QUIT) {
                 running = false;
-            } else if (event.type == SDL_MOUSEBUTTONDOWN) {
-                int mouseX, mouseY;
-                SDL_GetMouseState(&mouseX, &mouseY);
-
-                // Vérifier si le clic est sur le bouton "Add"
-                if (event.button.button == SDL_BUTTON_LEFT && isPointInRect(&(SDL_Point){mouseX, mouseY}, &(SDL_Rect){WIDTH - BUTTON_WIDTH, HEIGHT - BUTTON_HEIGHT, BUTTON_WIDTH, BUTTON_HEIGHT})) {
-                    // Ajouter une nouvelle zone de texte dans la colonne "To Do"
-                    if (numLines < 100) {
-                        // Utilisez une valeur plus grande pour la hauteur initiale (par exemple, 40)
-                        textLines[numLines].rect = (SDL_Rect){10, 40 + numLines * (40 + 5), TEXTBOX_WIDTH, 40};
-                        textLines[numLines].isEditing = true;
-                        textLines[numLines].isDragging = false;
-                        textLines[numLines].text[0] = '\0';
-                        textLines[numLines].inputText[0] = '\0';
-                        textLines[numLines].column = 0; // La nouvelle tâche appartient à la colonne "To Do"
-                        numLines++;
-                    }
-                } else if (event.button.button == SDL_BUTTON_RIGHT) {
-                    // Vérifier si le clic est sur une zone de texte existante pour la supprimer
-                    for (int i = 0; i < numLines; ++i) {
-                        if (isPointInRect(&(SDL_Point){mouseX, mouseY}, &(textLines[i].rect))) {
-                            // Supprimer la ligne en décalant les éléments suivants dans le tableau
-                            for (int j = i; j < numLines - 1; ++j) {
-                                textLines[j] = textLines[j + 1];
-                            }
-                            numLines--;
-                            break;
-                        }
-                    }
-                } else {
-                    // Vérifier si le clic est sur une zone de texte existante pour la déplacer
-                    for (int i = 0; i < numLines; ++i) {
-                        if (isPointInRect(&(SDL_Point){mouseX, mouseY}, &(textLines[i].rect))) {
-                            for (int j = 0; j < numLines; ++j) {
-                                textLines[j].isEditing = false;
-                                textLines[j].isDragging = false;
-                            }
-                            textLines[i].isEditing = true;
-                            textLines[i].isDragging = true;
-
-                            // Stocker la position y initiale
-                            int textWidth, textHeight;
-                            TTF_SizeText(font, textLines[i].text, &textWidth, &textHeight);
-                            textLines[i].rect.y = textLines[i].rect.y + (textLines[i].rect.h - textHeight) / 2;
-                        } else {
-                            textLines[i].isEditing = false;
-                            textLines[i].isDragging = false;
-                        }
-                    }
+            } else if (timeline.open) {
+                // Chronologie affichée : les tableaux ne peuvent pas être modifiés
+                if (!handleTimelineEvent(&timeline, &event)) {
+                    closeTimelineView(&timeline);
+                    boards[0] = &current->tasks;
+                    boards[1] = &current->done;
                 }
-            } else if (event.type == SDL_MOUSEBUTTONUP) {
-                // Désactiver le déplacement lorsque le bouton de la souris est relâché
-                for (int i = 0; i < numLines; ++i) {
-                    textLines[i].isDragging = false;
-                }
-            } else if (event.type == SDL_MOUSEMOTION) {
-                // Déplacer la zone de texte en cours d'édition si elle est en cours de déplacement
-                for (int i = 0; i < numLines; ++i) {
-                    if (textLines[i].isDragging) {
-                        textLines[i].rect.x = event.motion.x - textLines[i].rect.w / 2;
-                        textLines[i].rect.y = event.motion.y - textLines[i].rect.h / 2;
-                    }
+            } else if (event.type == SDL_MOUSEBUTTONDOWN || event.type == SDL_MOUSEBUTTONUP || event.type == SDL_MOUSEMOTION) {
+                handleMouseEvent(current, boards, font, &event);
+            } else if (event.type == SDL_MOUSEWHEEL) {
+                // Faire défiler la colonne "Done" (les pages plus anciennes sont chargées à la demande)
+                int mouseX = event.wheel.mouseX;
+                if (palette.open) {
+                    movePaletteSelection(&palette, -event.wheel.y);
+                } else if (mouseX >= columns[DONE_COLUMN].rect.x) {
+                    current->doneScroll -= event.wheel.y * (MIN_TEXTBOX_HEIGHT + 5);
+                    scrollDoneColumn(&current->done, &current->doneScroll);
                 }
                 // Gérer la saisie clavier
-            } else if (event.type == SDL_TEXTINPUT && numLines > 0) {
-                // Gérer la saisie de texte dans la zone de texte en cours d'édition
-                for (int i = 0; i < numLines; ++i) {
-                    if (textLines[i].isEditing) {
-                        // Vérifier si la zone de texte est en cours d'édition pour la première fois
-                        if (textLines[i].inputText[0] == '\0') {
-                            // Si oui, centrer le texte verticalement dans la zone de texte
-                            int textWidth, textHeight;
-                            TTF_SizeText(font, textLines[i].inputText, &textWidth, &textHeight);
-
-                            textLines[i].rect.y = textLines[i].rect.y + (textLines[i].rect.h - textHeight) / 2;
-                        }
+            } else if (event.type == SDL_TEXTINPUT) {
+                // Gérer la saisie de texte dans la zone de recherche ou dans la zone de texte en cours d'édition
+                TextLine *line = searching || filterEditing || palette.open ? NULL : findEditingTask(boards, 2, NULL, NULL);
+                if (palette.open) {
+                    SDL_strlcat(palette.query, event.text.text, sizeof(palette.query));
+                    updatePalette(&palette, current, boardNames, numBoardNames);
+                } else if (filterEditing) {
+                    SDL_strlcat(filterQuery, event.text.text, sizeof(filterQuery));
+                    filterValid = updateFilterView(current, filterQuery);
+                    scrollDoneColumn(&current->done, &current->doneScroll);
+                } else if (searching) {
+                    SDL_strlcat(searchQuery, event.text.text, sizeof(searchQuery));
+                    updateSearch(current, searchQuery);
+                } else if (line != NULL) {
+                    // Vérifier si la zone de texte est en cours d'édition pour la première fois
+                    if (line->inputText[0] == '\0') {
+                        // Si oui, centrer le texte verticalement dans la zone de texte
+                        int textWidth, textHeight;
+                        TTF_SizeText(font, line->inputText, &textWidth, &textHeight);
 
-                        // Concaténer le texte de saisie
-                        strcat(textLines[i].inputText, event.text.text);
+                        line->rect.y = line->rect.y + (line->rect.h - textHeight) / 2;
+                    }
 
-                        // Ajuster la position verticale pour centrer le texte
-                        int textWidth, textHeight;
-                        TTF_SizeText(font, textLines[i].inputText, &textWidth, &textHeight);
+                    // Concaténer le texte de saisie
+                    strcat(line->inputText, event.text.text);
 
-                        // Vérifier si le texte dépasse la largeur de la zone de texte
-                        if (textWidth > textLines[i].rect.w - 20) {
-                            // Si le texte dépasse, empêcher le texte de dépasser la largeur de la zone de texte
-                            textLines[i].inputText[strlen(textLines[i].inputText) - 1] = '\0';
-                        }
+                    // Ajuster la position verticale pour centrer le texte
+                    int textWidth, textHeight;
+                    TTF_SizeText(font, line->inputText, &textWidth, &textHeight);
 
-                        break;
+                    // Vérifier si le texte dépasse la largeur de la zone de texte
+                    if (textWidth > line->rect.w - 20) {
+                        // Si le texte dépasse, empêcher le texte de dépasser la largeur de la zone de texte
+                        line->inputText[strlen(line->inputText) - 1] = '\0';
                     }
                 }
             } else if (event.type == SDL_KEYDOWN) {
-                // Gérer le retour chariot pour finaliser la saisie dans la zone de texte en cours d'édition
-                if (event.key.keysym.sym == SDLK_RETURN && numLines > 0) {
-                    for (int i = 0; i < numLines; ++i) {
-                        if (textLines[i].isEditing) {
-                            textLines[i].isEditing = false;
-                            textLines[i].isDragging = false;
-                            strncpy(textLines[i].text, textLines[i].inputText, 12);  // Limiter le texte à 12 caractères //mais permet à la mémoire de marcher ?
-                            textLines[i].text[12] = '\0';
-                            textLines[i].inputText[0] = '\0';
-
-                            // Ajuster la hauteur de la zone de texte en fonction du texte entré
-                            int textWidth, textHeight;
-                            TTF_SizeText(font, textLines[i].text, &textWidth, &textHeight);
-                            textLines[i].rect.h = textHeight + 10;
-
-                            // Centrer le texte verticalement
-                            textLines[i].rect.y = textLines[i].rect.y + (textLines[i].rect.h - MIN_TEXTBOX_HEIGHT) / 2;
-                        }
-                    }
-                } else if (event.key.keysym.sym == SDLK_BACKSPACE && numLines > 0) {
-                    // Gérer la touche de suppression pour effacer le texte
-                    for (int i = 0; i < numLines; ++i) {
-                        if (textLines[i].isEditing && strlen(textLines[i].inputText) > 0) {
-                            textLines[i].inputText[strlen(textLines[i].inputText) - 1] = '\0';
-                            break;
+                SDL_Keycode key = event.key.keysym.sym;
+                int nextName = -1;
+                // Palette ouverte : elle reçoit toutes les touches
+                bool paletteKey = palette.open;
+                if (palette.open) {
+                    if (key == SDLK_ESCAPE) {
+                        palette.open = false;
+                    } else if (key == SDLK_BACKSPACE && palette.query[0] != '\0') {
+                        palette.query[strlen(palette.query) - 1] = '\0';
+                        updatePalette(&palette, current, boardNames, numBoardNames);
+                    } else if (key == SDLK_UP || key == SDLK_DOWN) {
+                        movePaletteSelection(&palette, key == SDLK_UP ? -1 : 1);
+                    } else if (key == SDLK_PAGEUP || key == SDLK_PAGEDOWN) {
+                        movePaletteSelection(&palette, key == SDLK_PAGEUP ? -PALETTE_VISIBLE_ROWS : PALETTE_VISIBLE_ROWS);
+                    } else if (key == SDLK_RETURN && palette.numResults > 0) {
+                        palette.open = false;
+                        if (palette.results[palette.selected].action == PALETTE_SWITCH_BOARD) {
+                            nextName = palette.results[palette.selected].id;
+                        } else {
+                            runPaletteAction(&palette.results[palette.selected], current);
                         }
                     }
+                } else if ((event.key.keysym.mod & KMOD_CTRL) && key == SDLK_p && palette.results != NULL) {
+                    palette.open = true;
+                    palette.query[0] = '\0';
+                    updatePalette(&palette, current, boardNames, numBoardNames);
+                    paletteKey = true;
+                // F3 : afficher ou masquer les mesures de performance
+                } else if (key == SDLK_F3) {
+                    hud.visible = !hud.visible;
+                // F4 : écrire la trace des phases sans quitter
+                } else if (key == SDLK_F4) {
+                    writeTrace(tracer.path);
+                // F5 : passer en mode faible latence ou en revenir
+                } else if (key == SDLK_F5) {
+                    lowLatency = !lowLatency;
+                // Ctrl+Tab et Ctrl+1 à Ctrl+9 : changer de tableau (repris du cache s'il est encore ouvert)
+                } else if ((event.key.keysym.mod & KMOD_CTRL) && key == SDLK_TAB) {
+                    nextName = (currentName + 1) % numBoardNames;
+                } else if ((event.key.keysym.mod & KMOD_CTRL) && key >= SDLK_1 && key <= SDLK_9 && key - SDLK_1 < numBoardNames) {
+                    nextName = key - SDLK_1;
                 }
-            } else if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_RIGHT) {
-                // Effacer une zone de texte si le bouton droit de la souris est cliqué
-                int mouseX, mouseY;
-                SDL_GetMouseState(&mouseX, &mouseY);
+                if (nextName >= 0) {
+                    OpenBoard *next = nextName != currentName ? switchBoard(&boardCache, boardNames[nextName], archiveCutoff) : NULL;
+                    if (next != NULL) {
+                        current = next;
+                        currentName = nextName;
+                        boards[0] = &current->tasks;
+                        boards[1] = &current->done;
+                        SDL_snprintf(windowTitle, sizeof(windowTitle), "To Do List - %s", current->files.name);
+                        SDL_SetWindowTitle(wind, windowTitle);
+                        updateSearch(current, searching ? searchQuery : "");
+                        filterValid = updateFilterView(current, filterQuery);
+                        scrollDoneColumn(&current->done, &current->doneScroll);
+                    }
+                } else if (paletteKey) {
+                    // Touche déjà traitée par la palette
+                // Ctrl+H : parcourir la chronologie du tableau, enregistré juste avant
+                } else if ((event.key.keysym.mod & KMOD_CTRL) && key == SDLK_h) {
+                    saveOpenBoard(current);
+                    lastAutosave = SDL_GetTicks();
+                    if (openTimelineView(&timeline, &current->files)) {
+                        boards[0] = &timeline.boards[0];
+                        boards[1] = &timeline.boards[1];
+                        searching = false;
+                        filterEditing = false;
+                        searchQuery[0] = '\0';
+                        updateSearch(current, searchQuery);
+                    }
+                // Ctrl+Z : annuler la dernière action, Ctrl+Y (ou Ctrl+Maj+Z) : la refaire
+                } else if ((event.key.keysym.mod & KMOD_CTRL) && (key == SDLK_z || key == SDLK_y)) {
+                    if (undoStep(current, key == SDLK_y || (event.key.keysym.mod & KMOD_SHIFT))) {
+                        scrollDoneColumn(&current->done, &current->doneScroll);
+                    }
+                // Ctrl+T : modifier la vue filtrée, Entrée : la garder, Échap : l'enlever
+                } else if ((event.key.keysym.mod & KMOD_CTRL) && key == SDLK_t) {
+                    filterEditing = true;
+                } else if (filterEditing && (key == SDLK_ESCAPE || key == SDLK_RETURN)) {
+                    filterEditing = false;
+                    if (key == SDLK_ESCAPE) {
+                        filterQuery[0] = '\0';
+                        filterValid = updateFilterView(current, filterQuery);
+                        scrollDoneColumn(&current->done, &current->doneScroll);
+                    }
+                } else if (filterEditing && key == SDLK_BACKSPACE) {
+                    if (filterQuery[0] != '\0') {
+                        filterQuery[strlen(filterQuery) - 1] = '\0';
+                        filterValid = updateFilterView(current, filterQuery);
+                        scrollDoneColumn(&current->done, &current->doneScroll);
+                    }
+                // Ctrl+F : ouvrir la recherche, Échap : la fermer
+                } else if ((event.key.keysym.mod & KMOD_CTRL) && key == SDLK_f) {
+                    searching = true;
+                    filterEditing = false;
+                } else if (searching && key == SDLK_ESCAPE) {
+                    searching = false;
+                    searchQuery[0] = '\0';
+                    updateSearch(current, searchQuery);
+                } else if (searching && key == SDLK_BACKSPACE) {
+                    if (searchQuery[0] != '\0') {
+                        searchQuery[strlen(searchQuery) - 1] = '\0';
+                        updateSearch(current, searchQuery);
+                    }
+                // Gérer le retour chariot pour finaliser la saisie dans la zone de texte en cours d'édition
+                } else if (event.key.keysym.sym == SDLK_RETURN) {
+                    beginUndoStep(current);
+                    for (int b = 0; b < 2; ++b) {
+                        for (int i = 0; i < loadedTasks(boards[b]); ++i) {
+                            TextLine *line = &boards[b]->lines[i];
+                            if (line->isEditing) {
+                                line->isEditing = false;
+                                line->isDragging = false;
+                                char text[MAX_TEXT_LENGTH];
+                                strncpy(text, line->inputText, 12);  // Limiter le texte à 12 caractères //mais permet à la mémoire de marcher ?
+                                text[12] = '\0';
+                                editTask(current, boards[b], boards[b]->baseIndex + i, text);
+                                line->inputText[0] = '\0';
+
+                                // Ajuster la hauteur de la zone de texte en fonction du texte entré
+                                int textWidth, textHeight;
+                                TTF_SizeText(font, line->text, &textWidth, &textHeight);
+                                line->rect.h = textHeight + 10;
 
-                for (int i = 0; i < numLines; ++i) {
-                    if (isPointInRect(&(SDL_Point){mouseX, mouseY}, &(textLines[i].rect))) {
-                        // Supprimer la ligne
-                        for (int j = i; j < numLines - 1; ++j) {
-                            textLines[j] = textLines[j + 1];
+                                // Centrer le texte verticalement
+                                line->rect.y = line->rect.y + (line->rect.h - MIN_TEXTBOX_HEIGHT) / 2;
+                            }
                         }
-                        numLines--;
-                        break;
+                    }
+                    endUndoStep(current);
+                } else if (event.key.keysym.sym == SDLK_BACKSPACE) {
+                    // Gérer la touche de suppression pour effacer le texte
+                    TextLine *line = findEditingTask(boards, 2, NULL, NULL);
+                    if (line != NULL && strlen(line->inputText) > 0) {
+                        line->inputText[strlen(line->inputText) - 1] = '\0';
                     }
                 }
             }
         }
 
-        // Effacer l'écran
-        SDL_SetRenderDrawColor(rend, 255, 255, 255, 255);
-        SDL_RenderClear(rend);
-
-        // Dessiner les colonnes
-        for (int i = 0; i < 3; ++i) {
-            SDL_SetRenderDrawColor(rend, columns[i].color.r, columns[i].color.g, columns[i].color.b, columns[i].color.a);
-            SDL_RenderFillRect(rend, &(columns[i].rect));
-
-            SDL_Color textColor = {255, 255, 255, 255};
-            SDL_Surface *textSurface = TTF_RenderText_Solid(font, columns[i].title, textColor);
-            SDL_Texture *textTexture = SDL_CreateTextureFromSurface(rend, textSurface);
-            SDL_FreeSurface(textSurface);
+        phaseTicks[HUD_EVENTS] = SDL_GetPerformanceCounter() - phaseStart;
+        phaseStart += phaseTicks[HUD_EVENTS];
+        endTraceZone(zone, "events");
 
-            SDL_Rect renderQuad = {columns[i].rect.x + WIDTH / 6 - textSurface->w / 2, 0, textSurface->w, textSurface->h};
-            SDL_RenderCopy(rend, textTexture, NULL, &renderQuad);
-            SDL_DestroyTexture(textTexture);
+        // Créer les textures des textes rendus par les fils depuis l'image précédente
+        setAllocZone(ALLOC_RENDER);
+        if (raster != NULL) {
+            uploadTextRaster(raster, rend, &current->textCache, RASTER_UPLOAD_BUDGET_US);
         }
 
-        // Dessiner le bouton "Add"
-        // Dimensions du bouton "Add"
-        int buttonWidth = BUTTON_WIDTH;
-        int buttonHeight = BUTTON_HEIGHT;
-
-        // Position du bouton en bas à droite
-        int buttonX = WIDTH - buttonWidth;
-        int buttonY = HEIGHT - buttonHeight;
-
-        // Dessine le bouton "Add"
-        SDL_SetRenderDrawColor(rend, 0, 0, 0, 255);
-        SDL_Rect rect = {buttonX, buttonY, buttonWidth, buttonHeight};
-        SDL_RenderFillRect(rend, &rect);
-
-        // Dessine le texte au centre du bouton "Add"
-        SDL_Color textColor = {255, 255, 255, 255}; // Couleur du texte (blanc)
-        SDL_Surface *textSurfaceButton = TTF_RenderText_Solid(font, "Add", textColor);
-        SDL_Texture *textButton = SDL_CreateTextureFromSurface(rend, textSurfaceButton);
-
-        int textWidth, textHeight;
-        SDL_QueryTexture(textButton, NULL, NULL, &textWidth, &textHeight);
+        // Effacer l'écran, puis dessiner le tableau
+        renderBoard(rend, font, columns, boards, &current->textCache);
+        zone = beginTraceZone();
 
-        SDL_Rect textRect = {buttonX + (buttonWidth - textWidth) / 2, buttonY + (buttonHeight - textHeight) / 2, textWidth, textHeight};
-        SDL_RenderCopy(rend, textButton, NULL, &textRect);
+        // Dessiner la zone de recherche par-dessus les titres des colonnes
+        if (searching) {
+            char searchLabel[MAX_TEXT_LENGTH + 32];
+            SDL_snprintf(searchLabel, sizeof(searchLabel), "Search: %s (%d)", searchQuery,
+                         countSearchMatches(&current->taskIndex) + countSearchMatches(&current->doneIndex));
+            renderText(rend, font, NULL, searchLabel, (SDL_Rect){0, 0, WIDTH, 36}, (SDL_Color){0, 0, 0, 255}, (SDL_Color){255, 255, 255, 255}, true, false);
+        }
 
-        // Libère la surface et la texture du texte
-        SDL_FreeSurface(textSurfaceButton);
-        SDL_DestroyTexture(textButton);
+        // Dessiner la vue filtrée, sous la zone de recherche si elle est ouverte
+        if (!timeline.open && (filterEditing || filterQuery[0] != '\0')) {
+            char filterLabel[MAX_FILTER_LENGTH + 32];
+            if (filterValid) {
+                SDL_snprintf(filterLabel, sizeof(filterLabel), "Filter: %s (%d)", filterQuery,
+                             tagBitmapCount(&current->taskIndex.filtered) + tagBitmapCount(&current->doneIndex.filtered));
+            } else {
+                SDL_snprintf(filterLabel, sizeof(filterLabel), "Filter: %s (invalid)", filterQuery);
+            }
+            renderText(rend, font, NULL, filterLabel, (SDL_Rect){0, searching ? 36 : 0, WIDTH, 36}, (SDL_Color){0, 0, 0, 255}, (SDL_Color){255, 255, 255, 255}, filterEditing, false);
+        }
 
-        // Dessiner le texte "Right-click to delete" à côté du bouton "Add"
-        SDL_Color deleteTextColor = {255, 255, 255, 255};
-        SDL_Surface *textSurfaceDelete = TTF_RenderText_Solid(font, "Right click to delete - Enter to save the task", deleteTextColor);
-        SDL_Texture *textDelete = SDL_CreateTextureFromSurface(rend, textSurfaceDelete);
-        SDL_FreeSurface(textSurfaceDelete);
+        // Dessiner la date de la version affichée de la chronologie
+        if (timeline.open) {
+            char date[32] = "";
+            time_t versionTime = (time_t)timeline.entries[timeline.position].time;
+            struct tm *versionDate = localtime(&versionTime);
+            if (versionDate != NULL) {
+                strftime(date, sizeof(date), "%Y-%m-%d %H:%M", versionDate);
+            }
+            char timelineLabel[96];
+            SDL_snprintf(timelineLabel, sizeof(timelineLabel), "History: %s (%d/%d)", date, timeline.position + 1, timeline.numEntries);
+            renderText(rend, font, NULL, timelineLabel, (SDL_Rect){0, 0, WIDTH, 36}, (SDL_Color){0, 0, 0, 255}, (SDL_Color){255, 255, 255, 255}, true, false);
+        }
 
-        SDL_Rect renderQuadDelete = {WIDTH - BUTTON_WIDTH - textSurfaceDelete->w - 10, HEIGHT - BUTTON_HEIGHT, textSurfaceDelete->w, textSurfaceDelete->h};
-        SDL_RenderCopy(rend, textDelete, NULL, &renderQuadDelete);
-        SDL_DestroyTexture(textDelete);
+        // Dessiner la palette : la requête puis seulement les résultats visibles
+        if (palette.open) {
+            SDL_Rect paletteRect = {WIDTH / 2 - 260, 50, 520, 36};
+            char paletteLabel[PALETTE_MAX_QUERY + 8];
+            SDL_snprintf(paletteLabel, sizeof(paletteLabel), "> %s", palette.query);
+            renderText(rend, font, NULL, paletteLabel, paletteRect, (SDL_Color){0, 0, 0, 255}, (SDL_Color){255, 255, 255, 255}, true, false);
+            for (int r = palette.scroll; r < palette.numResults && r < palette.scroll + PALETTE_VISIBLE_ROWS; ++r) {
+                char label[MAX_TEXT_LENGTH + 32];
+                paletteResultLabel(&palette.results[r], current, boardNames, label, sizeof(label));
+                paletteRect.y += paletteRect.h;
+                SDL_Color background = r == palette.selected ? (SDL_Color){200, 220, 255, 255} : (SDL_Color){245, 245, 245, 255};
+                renderText(rend, font, &current->textCache, label, paletteRect, (SDL_Color){0, 0, 0, 255}, background, false, false);
+            }
+        }
 
-        // Dessiner les zones de texte
-        for (int i = 0; i < numLines; ++i) {
-            SDL_Color color = {0, 0, 0}; // Couleur du texte (noir)
-            SDL_Color backgroundColor = {255, 255, 255};
-            renderText(rend, font, textLines[i].text, textLines[i].rect, color, backgroundColor, textLines[i].isEditing, textLines[i].isDragging);
+        // Allocations de la dernière image
+        if (allocStats.enabled) {
+            renderAllocOverlay(rend, font, &allocOverlay);
+        }
+        phaseTicks[HUD_DRAW] = SDL_GetPerformanceCounter() - phaseStart;
+        endTraceZone(zone, "render overlays");
 
+        // Mesures de performance, hors du temps de dessin mesuré
+        zone = beginTraceZone();
+        renderHud(rend, FONT_PATH, &hud);
+        endTraceZone(zone, "render hud");
 
+// Mettre à jour l'affichage
+        zone = beginTraceZone();
+        phaseStart = SDL_GetPerformanceCounter();
+        SDL_RenderPresent(rend);
+        phaseTicks[HUD_PRESENT] = SDL_GetPerformanceCounter() - phaseStart;
+        recordPresentedInput(&latency);
+        endTraceZone(zone, "present");
 
-            if (textLines[i].isEditing) {
-                SDL_Rect inputRect = {textLines[i].rect.x, textLines[i].rect.y, textLines[i].rect.w, textLines[i].rect.h};
-                renderText(rend, font, textLines[i].inputText, inputRect, color, backgroundColor, textLines[i].isEditing, textLines[i].isDragging);
+        // Respecter le budget mémoire des tableaux gardés en cache
+        setAllocZone(ALLOC_UPDATE);
+        trimBoardCache(&boardCache, current);
 
-            }
+        // Ajouter un délai pour réduire l'utilisation du processeur (sauf relecture à vitesse maximale).
+        // En mode faible latence, la pause s'arrête dès qu'un événement arrive : la saisie est
+        // affichée à l'image suivante au lieu d'attendre la fin des 16 millisecondes.
+        if (!eventLog.maxSpeed && lowLatency) {
+            SDL_WaitEventTimeout(NULL, 16);
+        } else if (!eventLog.maxSpeed) {
+            SDL_Delay(16); // Pause de 16 millisecondes
         }
 
-// Mettre à jour l'affichage
-        SDL_RenderPresent(rend);
-
-        // Ajouter un délai pour réduire l'utilisation du processeur
-        SDL_Delay(16); // Pause de 16 millisecondes
+        // Écrire les événements enregistrés pendant l'image ; fin de la relecture
+        flushEventRecording(&eventLog);
+        if (eventLog.finished) {
+            running = false;
+        }
 
 
         // Si quelque chose a changé, mettez à jour l'affichage
@@ -456,29 +11489,42 @@ int main(int argc, char *argv[]) {
             somethingChanged = false;  // Réinitialisez l'indicateur
         }
 
-    }
-    // Sauvegarder les tâches avant de quitter
-    saveTasksToFile(textLines, numLines);
-
-    // Enregistrez les tâches dans le fichier
-    FILE *saveFile = fopen("tasks.txt", "w");
-    if (saveFile != NULL) {
-        for (int i = 0; i < numLines; ++i) {
-            fprintf(saveFile, "%d %s\n", textLines[i].column, textLines[i].text);
+        // Rendre la mémoire de travail de l'image
+        resetFrameArena(&frameArena);
+        if (allocStats.enabled) {
+            endAllocFrame();
         }
-        fclose(saveFile);
-        printf("Tasks saved to file.\n");
-    } else {
-        printf("Error opening tasks.txt for writing.\n");
+        recordHudFrame(&hud, phaseTicks, SDL_GetPerformanceCounter() - frameStart, numEvents, &latency, lowLatency);
+        endTraceZone(frameZone, "frame");
     }
+    // Terminer l'enregistrement ou la relecture des événements avec l'état final du tableau
+    eventLogOk = stopEventRecording(&eventLog, current) && eventLogOk;
+    eventLogOk = stopEventReplay(&eventLog, current) && eventLogOk;
 
+    // Sauvegarder les pages modifiées avant de quitter
+    closeTimelineView(&timeline);
+    freeBoardCache(&boardCache);
+    freePalette(&palette);
 
     // Libérer la mémoire et quitter
+    destroyTextRaster(raster);
+    if (allocOverlay.texture != NULL) {
+        SDL_DestroyTexture(allocOverlay.texture);
+    }
+    freeHud(&hud);
     TTF_CloseFont(font);
     TTF_Quit();
     SDL_DestroyRenderer(rend);
     SDL_DestroyWindow(wind);
     SDL_Quit();
+    freeFrameArena(&frameArena);
+    if (allocStats.enabled) {
+        printAllocStats();
+    }
+    if (latencyStats) {
+        printInputLatency(&latency, lowLatency);
+    }
 
-    return 0;
+    // Une relecture dont l'état final diffère de l'enregistrement est un échec
+    return eventLogOk ? 0 : 1;
 }